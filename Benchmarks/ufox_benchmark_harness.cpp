@@ -0,0 +1,111 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_benchmark_harness.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <fmt/core.h>
+#include <fmt/os.h>
+
+namespace ufox::benchmarks {
+    using Clock = std::chrono::steady_clock;
+
+    bool BenchmarkRunner::isEnabled(const std::string &name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    BenchmarkResult* BenchmarkRunner::run(const std::string &name, double items, const std::string &unit,
+                                          const std::function<void()> &function) {
+        if (!isEnabled(name)) return nullptr;
+
+        function();
+        std::vector<double> times;
+        times.reserve(options.repetitions);
+        for (int i = 0; i < options.repetitions; ++i) {
+            const auto start = Clock::now();
+            function();
+            times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        std::ranges::sort(times);
+
+        return &report({ name, times.front(), times[times.size() / 2], items, unit, true });
+    }
+
+    BenchmarkResult& BenchmarkRunner::report(BenchmarkResult result) {
+        Print(result);
+        return results.emplace_back(std::move(result));
+    }
+
+    void BenchmarkRunner::fail(const std::string &name, const std::string &reason) {
+        fmt::println("  {:<40} FAILED: {}", name, reason);
+        failures.push_back(name + ": " + reason);
+    }
+
+    void BenchmarkRunner::Print(const BenchmarkResult &result) {
+        const double throughput = result.bestMs > 0.0 ? result.items / result.bestMs / 1000.0 : 0.0;
+        fmt::println("  {:<40} {:>10.3f} ms {:>10.3f} ms median {:>10.2f} M {}/s{}", result.name, result.bestMs, result.medianMs,
+                     throughput, result.unit, result.valid ? "" : "  MISMATCH");
+    }
+
+    void WriteJson(const std::filesystem::path &path, const std::vector<BenchmarkResult> &results, const std::string &simdLevel) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) throw std::runtime_error("Failed to write " + path.string());
+
+        out << fmt::format("{{\n  \"version\": 1,\n  \"simd\": \"{}\",\n  \"results\": [\n", simdLevel);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& result = results[i];
+            out << fmt::format("    {{\"name\": \"{}\", \"best_ms\": {:.6f}, \"median_ms\": {:.6f}, \"items\": {:.0f}, \"unit\": \"{}\", \"valid\": {}}}{}\n",
+                               result.name, result.bestMs, result.medianMs, result.items, result.unit, result.valid,
+                               i + 1 < results.size() ? "," : "");
+        }
+        out << "  ]\n}\n";
+    }
+
+    std::unordered_map<std::string, double> ReadBaseline(const std::filesystem::path &path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Failed to read baseline " + path.string());
+
+        // Only has to understand what WriteJson produces: one result object per line
+        constexpr std::string_view NAME_KEY = "\"name\": \"";
+        constexpr std::string_view BEST_KEY = "\"best_ms\": ";
+        std::unordered_map<std::string, double> baseline;
+        std::string line;
+        while (std::getline(in, line)) {
+            const size_t name = line.find(NAME_KEY);
+            const size_t best = line.find(BEST_KEY);
+            if (name == std::string::npos || best == std::string::npos) continue;
+
+            const size_t nameStart = name + NAME_KEY.size();
+            const size_t nameEnd = line.find('"', nameStart);
+            if (nameEnd == std::string::npos) continue;
+            baseline[line.substr(nameStart, nameEnd - nameStart)] = std::stod(line.substr(best + BEST_KEY.size()));
+        }
+        return baseline;
+    }
+
+    uint32_t CompareWithBaseline(const std::vector<BenchmarkResult> &results, const std::unordered_map<std::string, double> &baseline,
+                                 double threshold) {
+        fmt::println("\nAgainst baseline, regression above {:.0f}%:", threshold * 100.0);
+        uint32_t regressions = 0;
+        for (const BenchmarkResult& result : results) {
+            auto it = baseline.find(result.name);
+            if (it == baseline.end() || it->second <= 0.0) {
+                fmt::println("  {:<40} {:>10.3f} ms   new", result.name, result.bestMs);
+                continue;
+            }
+            const double change = result.bestMs / it->second - 1.0;
+            const bool regressed = change > threshold;
+            if (regressed) ++regressions;
+            fmt::println("  {:<40} {:>10.3f} ms {:>10.3f} ms {:>+8.1f}%{}", result.name, result.bestMs, it->second, change * 100.0,
+                         regressed ? "  REGRESSION" : "");
+        }
+        for (const auto& [name, ms] : baseline) {
+            if (std::ranges::none_of(results, [&](const BenchmarkResult& result) { return result.name == name; }))
+                fmt::println("  {:<40} missing from this run", name);
+        }
+        return regressions;
+    }
+}
@@ -0,0 +1,72 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ufox::benchmarks {
+
+    struct BenchmarkOptions {
+        std::string filter{};                       // substring of the benchmark name, empty runs everything
+        int repetitions{15};
+        size_t elementCount{100000};
+        bool headless{false};                       // GPU benchmarks on an offscreen window, e.g. lavapipe in CI
+        std::optional<std::filesystem::path> jsonPath{};
+        std::optional<std::filesystem::path> baselinePath{};
+        double threshold{0.10};                     // slowdown against the baseline that counts as a regression
+    };
+
+    struct BenchmarkResult {
+        std::string name;
+        double bestMs{0.0};
+        double medianMs{0.0};
+        double items{0.0};                          // work per run, throughput = items / best
+        std::string unit{};
+        bool valid{true};                           // false when the output disagreed with the reference
+    };
+
+    // Runs each benchmark function once to warm up, then options.repetitions times and keeps the best and median.
+    // The best run is what baselines compare, it is the least disturbed by the rest of the machine.
+    class BenchmarkRunner {
+    public:
+        explicit BenchmarkRunner(BenchmarkOptions options) : options{std::move(options)} {}
+
+        [[nodiscard]] bool isEnabled(const std::string& name) const;
+
+        // Returns nullptr when the filter skips the benchmark
+        BenchmarkResult* run(const std::string& name, double items, const std::string& unit, const std::function<void()>& function);
+        // For measurements the runner cannot repeat itself, e.g. a sequence of frames
+        BenchmarkResult& report(BenchmarkResult result);
+        void fail(const std::string& name, const std::string& reason);
+
+        [[nodiscard]] const BenchmarkOptions& getOptions() const { return options; }
+        [[nodiscard]] const std::vector<BenchmarkResult>& getResults() const { return results; }
+        [[nodiscard]] const std::vector<std::string>& getFailures() const { return failures; }
+
+    private:
+        BenchmarkOptions options;
+        std::vector<BenchmarkResult> results;
+        std::vector<std::string> failures;
+
+        static void Print(const BenchmarkResult& result);
+    };
+
+    // {"version": 1, "simd": ..., "results": [{"name": ..., "best_ms": ..., ...}, ...]}, one result per line
+    void WriteJson(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results, const std::string& simdLevel);
+    // Best times by name from a file written by WriteJson
+    [[nodiscard]] std::unordered_map<std::string, double> ReadBaseline(const std::filesystem::path& path);
+    // Prints every benchmark against its baseline, returns the number of regressions beyond threshold
+    [[nodiscard]] uint32_t CompareWithBaseline(const std::vector<BenchmarkResult>& results,
+                                               const std::unordered_map<std::string, double>& baseline, double threshold);
+
+    void RunCpuBenchmarks(BenchmarkRunner& runner);
+    // Needs a Vulkan driver, run with --headless to create the device on SDL's offscreen video driver
+    void RunGpuBenchmarks(BenchmarkRunner& runner);
+}
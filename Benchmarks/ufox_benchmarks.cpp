@@ -0,0 +1,509 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include "Engine/ufox_asset_pack.hpp"
+#include "Engine/ufox_gui_draw_list.hpp"
+#include "Engine/ufox_gui_hit_test.hpp"
+#include "Engine/ufox_gui_path.hpp"
+#include "Engine/ufox_gui_quad_batch.hpp"
+#include "Engine/ufox_gui_renderer.hpp"
+#include "ufox_benchmark_harness.hpp"
+
+namespace {
+    using namespace ufox::renderer::gui;
+    using ufox::benchmarks::BenchmarkOptions;
+    using ufox::benchmarks::BenchmarkRunner;
+
+    struct QuadData {
+        std::vector<float> x, y, width, height;
+        std::vector<float> scaleX, scaleY, translateX, translateY;
+        std::vector<uint32_t> color;
+        std::vector<float> clipMinX, clipMinY, clipMaxX, clipMaxY;
+
+        [[nodiscard]] QuadBatch getBatch() const {
+            return { x.size(), x, y, width, height, scaleX, scaleY, translateX, translateY, color, clipMinX, clipMinY, clipMaxX, clipMaxY };
+        }
+    };
+
+    // Widgets on a 1920x1080 target: most fully inside their clip, some cut by a scroll view, a few scrolled out
+    QuadData MakeQuads(size_t count) {
+        std::mt19937 random{42};
+        std::uniform_real_distribution<float> position(0.0f, 1800.0f);
+        std::uniform_real_distribution<float> size(4.0f, 240.0f);
+        std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+        std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+        QuadData data{};
+        for (size_t i = 0; i < count; ++i) {
+            data.x.push_back(0.0f);
+            data.y.push_back(0.0f);
+            data.width.push_back(size(random));
+            data.height.push_back(size(random) * 0.25f);
+            data.scaleX.push_back(scale(random));
+            data.scaleY.push_back(scale(random));
+            data.translateX.push_back(position(random));
+            data.translateY.push_back(position(random) * 0.6f);
+            data.color.push_back(static_cast<uint32_t>(random()));
+
+            const float roll = chance(random);
+            if (roll < 0.7f) {
+                data.clipMinX.push_back(0.0f);
+                data.clipMinY.push_back(0.0f);
+                data.clipMaxX.push_back(1920.0f);
+                data.clipMaxY.push_back(1080.0f);
+            }
+            else {
+                // Scroll view around the element, occasionally missing it entirely
+                const float offset = roll < 0.9f ? 20.0f : 600.0f;
+                data.clipMinX.push_back(data.translateX.back() + offset);
+                data.clipMinY.push_back(data.translateY.back() + offset * 0.5f);
+                data.clipMaxX.push_back(data.translateX.back() + offset + 300.0f);
+                data.clipMaxY.push_back(data.translateY.back() + offset * 0.5f + 200.0f);
+            }
+        }
+        return data;
+    }
+
+    // Widgets spread over the right half of a 3840x2160 target, every corner past 2048 px and none clipped away
+    QuadData MakeQuads4k(size_t count) {
+        std::mt19937 random{43};
+        std::uniform_real_distribution<float> positionX(2048.0f, 3600.0f);
+        std::uniform_real_distribution<float> positionY(1100.0f, 2000.0f);
+        std::uniform_real_distribution<float> size(4.0f, 120.0f);
+
+        QuadData data{};
+        for (size_t i = 0; i < count; ++i) {
+            data.x.push_back(0.0f);
+            data.y.push_back(0.0f);
+            data.width.push_back(size(random));
+            data.height.push_back(size(random));
+            data.scaleX.push_back(1.0f);
+            data.scaleY.push_back(1.0f);
+            data.translateX.push_back(positionX(random));
+            data.translateY.push_back(positionY(random));
+            data.color.push_back(static_cast<uint32_t>(random()));
+            data.clipMinX.push_back(0.0f);
+            data.clipMinY.push_back(0.0f);
+            data.clipMaxX.push_back(3840.0f);
+            data.clipMaxY.push_back(2160.0f);
+        }
+        return data;
+    }
+
+    // Unpacks every corner and compares it with the unclipped rect, within half a fixed-point step
+    bool QuadsMatch(const QuadData& data, const std::vector<std::byte>& output, size_t written) {
+        if (written != data.x.size()) return false;
+        constexpr float TOLERANCE = 0.5f / PackedVertex::POSITION_SCALE;
+        for (size_t i = 0; i < written; ++i) {
+            const glm::vec2 min{ data.translateX[i], data.translateY[i] };
+            const glm::vec2 max = min + glm::vec2(data.width[i], data.height[i]);
+            const glm::vec2 expected[4] = { min, {max.x, min.y}, max, {min.x, max.y} };
+            for (size_t c = 0; c < 4; ++c) {
+                PackedVertex vertex{};
+                std::memcpy(&vertex, output.data() + (i * 4 + c) * sizeof(PackedVertex), sizeof(vertex));
+                const glm::vec2 difference = glm::abs(UnpackVertex(vertex).position - expected[c]);
+                if (difference.x > TOLERANCE || difference.y > TOLERANCE) return false;
+            }
+        }
+        return true;
+    }
+
+    // What one element costs today: the matrix chain of GraphicsDevice::updateUniformBuffer and PackVertex per
+    // corner, without clipping
+    size_t WriteQuadsGlm(const QuadData& data, std::byte* out) {
+        static constexpr glm::vec2 CORNERS[4] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} };
+        for (size_t i = 0; i < data.x.size(); ++i) {
+            const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(data.translateX[i], data.translateY[i], 0.0f)) *
+                                    glm::scale(glm::mat4(1.0f), glm::vec3(data.scaleX[i], data.scaleY[i], 1.0f));
+            glm::vec4 color{};
+            for (int c = 0; c < 4; ++c) color[c] = static_cast<float>((data.color[i] >> (c * 8)) & 0xFF) / 255.0f;
+
+            for (const glm::vec2& corner : CORNERS) {
+                const glm::vec2 local = glm::vec2(data.x[i], data.y[i]) + corner * glm::vec2(data.width[i], data.height[i]);
+                const glm::vec4 position = model * glm::vec4(local, 0.0f, 1.0f);
+                const PackedVertex vertex = PackVertex(glm::vec2(position), color, corner);
+                std::memcpy(out, &vertex, sizeof(vertex));
+                out += sizeof(vertex);
+            }
+        }
+        return data.x.size();
+    }
+
+    template<typename Handle>
+    Handle FakeHandle(uint64_t value) {
+        typename Handle::CType raw{};
+        static_assert(sizeof(raw) == sizeof(value));
+        std::memcpy(&raw, &value, sizeof(raw));
+        return Handle(raw);
+    }
+
+    void BenchmarkQuadBatch(BenchmarkRunner& runner) {
+        const size_t count = runner.getOptions().elementCount;
+        const QuadData data = MakeQuads(count);
+        const QuadBatch batch = data.getBatch();
+        std::vector<std::byte> reference(count * 4 * sizeof(PackedVertex));
+        std::vector<std::byte> output(reference.size());
+
+        size_t visible = WriteQuads(SimdLevel::Scalar, batch, reference.data());
+        runner.run("batch.quads.glm", count, "elements", [&] { (void)WriteQuadsGlm(data, output.data()); });
+        runner.run("batch.quads.scalar", count, "elements", [&] { visible = WriteQuads(SimdLevel::Scalar, batch, reference.data()); });
+
+        for (const SimdLevel level : { SimdLevel::Sse2, SimdLevel::Avx2 }) {
+            const std::string name = std::string("batch.quads.") + ToString(level);
+            if (level > GetSimdLevel()) {
+                if (runner.isEnabled(name)) fmt::println("  {:<40} not supported", name);
+                continue;
+            }
+            size_t written = 0;
+            if (auto* result = runner.run(name, count, "elements", [&] { written = WriteQuads(level, batch, output.data()); })) {
+                result->valid = written == visible &&
+                                std::memcmp(output.data(), reference.data(), written * 4 * sizeof(PackedVertex)) == 0;
+            }
+        }
+
+        // Positions past 2048 px used to saturate, every level has to place 4K corners where they belong
+        const QuadData data4k = MakeQuads4k(count);
+        const QuadBatch batch4k = data4k.getBatch();
+        for (const SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 }) {
+            const std::string name = std::string("batch.quads.4k.") + ToString(level);
+            if (level > GetSimdLevel()) {
+                if (runner.isEnabled(name)) fmt::println("  {:<40} not supported", name);
+                continue;
+            }
+            size_t written = 0;
+            if (auto* result = runner.run(name, count, "elements", [&] { written = WriteQuads(level, batch4k, output.data()); }))
+                result->valid = QuadsMatch(data4k, output, written);
+        }
+    }
+
+    // A frame's worth of GUI draws: a handful of pipelines and textures, quads sharing one vertex and index
+    // buffer so neighbours can merge, and a fifth drawn opaque
+    void BenchmarkDrawList(BenchmarkRunner& runner) {
+        const size_t count = runner.getOptions().elementCount;
+        std::mt19937 random{7};
+        std::vector<DrawCommand> commands(count);
+        std::vector<std::array<std::byte, sizeof(ufox::graphics::RoundedRectParams)>> params(count);
+        for (size_t i = 0; i < count; ++i) {
+            DrawCommand& command = commands[i];
+            command.pipeline = FakeHandle<vk::Pipeline>(1 + random() % 8);
+            command.layout = FakeHandle<vk::PipelineLayout>(1);
+            command.descriptorSet = FakeHandle<vk::DescriptorSet>(1 + random() % 32);
+            command.vertexBuffer = FakeHandle<vk::Buffer>(1);
+            command.indexBuffer = FakeHandle<vk::Buffer>(2);
+            command.pushConstantStages = vk::ShaderStageFlagBits::eFragment;
+            command.scissor = vk::Rect2D{ {0, 0}, {1920, 1080} };
+            command.firstIndex = static_cast<uint32_t>(i * 6);
+            command.indexCount = 6;
+            command.layer = static_cast<uint8_t>(random() % 4);
+            command.transparent = random() % 5 != 0;
+            command.depth = static_cast<float>(random() % 1000) / 1000.0f;
+            params[i].fill(std::byte{ static_cast<unsigned char>(random() % 3) });
+        }
+
+        // The engine builds its lists in the frame arena, reset between runs like a frame slot. The pass tests
+        // depth so opaque draws group by pipeline and texture.
+        std::vector<std::byte> storage(count * 512);
+        std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size());
+        size_t compiled = 0;
+        if (runner.run("drawlist.build", count, "draws", [&] {
+            arena.release();
+            DrawList drawList(&arena, true);
+            for (size_t i = 0; i < count; ++i) drawList.add(commands[i], std::span<const std::byte>(params[i]));
+            drawList.compile();
+            compiled = drawList.size();
+        }))
+            fmt::println("  {:<40} {} draws after merging", "", compiled);
+
+        // Siblings in one container, each under its own scroll view clip. The clip only changes their vertex clip
+        // indices, pipeline, set, buffers, scissor and push constants are shared, so the list collapses to one draw.
+        ClipStack clipStack{};
+        std::vector<uint32_t> vertexClips(count * 4);
+        const std::array<std::byte, sizeof(ufox::graphics::RoundedRectParams)> sharedParams{};
+        DrawCommand sibling = commands.front();
+        sibling.transparent = true;
+        sibling.scissor = vk::Rect2D{ {0, 0}, {1920, 1080} };
+        size_t clippedDraws = 0;
+        if (auto* result = runner.run("drawlist.clipped_siblings", count, "draws", [&] {
+            arena.release();
+            clipStack.reset(vk::Extent2D{1920, 1080});
+            DrawList drawList(&arena);
+            for (size_t i = 0; i < count; ++i) {
+                const float x = static_cast<float>(i % 64) * 30.0f;
+                clipStack.push({ {x, 0.0f}, {24.0f, 1080.0f} }, glm::vec4(4.0f));
+                std::fill_n(vertexClips.begin() + static_cast<std::ptrdiff_t>(i * 4), 4, clipStack.getClipIndex());
+                sibling.firstIndex = static_cast<uint32_t>(i * 6);
+                drawList.add(sibling, std::span<const std::byte>(sharedParams));
+                clipStack.pop();
+            }
+            drawList.compile();
+            clippedDraws = drawList.size();
+        })) {
+            result->valid = clippedDraws == 1 && clipStack.getTable().size() == count + 1 &&
+                            (count < 2 || vertexClips[0] != vertexClips[4]);
+        }
+
+        // Three overlapping opaque quads in a pass without depth, the first and last sharing a texture. Grouping by
+        // texture would draw the last one under the middle one, only submission order keeps it on top.
+        std::array<DrawCommand, 3> stacked{};
+        for (size_t i = 0; i < stacked.size(); ++i) {
+            stacked[i] = commands.front();
+            stacked[i].transparent = false;
+            stacked[i].layer = 0;
+            stacked[i].descriptorSet = FakeHandle<vk::DescriptorSet>(1 + i % 2);
+            stacked[i].firstIndex = static_cast<uint32_t>(i * 6);
+        }
+        bool painterOrder = false;
+        if (auto* result = runner.run("drawlist.painter_order", static_cast<double>(stacked.size()), "draws", [&] {
+            arena.release();
+            DrawList drawList(&arena);
+            for (const DrawCommand& command : stacked) drawList.add(command);
+            drawList.compile();
+            painterOrder = drawList.size() == stacked.size();
+            for (size_t i = 0; painterOrder && i < stacked.size(); ++i)
+                painterOrder = drawList.getCommand(i).firstIndex == stacked[i].firstIndex;
+        })) {
+            result->valid = painterOrder;
+        }
+    }
+
+    // The tree has no layout engine yet, what layout hands to rendering is clipped rects: nested scroll views
+    // through the ClipStack and the hit test grid rebuilt from the result
+    void BenchmarkLayout(BenchmarkRunner& runner) {
+        const size_t count = runner.getOptions().elementCount;
+        std::mt19937 random{11};
+        std::uniform_real_distribution<float> position(0.0f, 1800.0f);
+        std::uniform_real_distribution<float> size(8.0f, 240.0f);
+
+        std::vector<Rect> rects(count);
+        for (Rect& rect : rects) rect = { {position(random), position(random) * 0.6f}, {size(random), size(random) * 0.5f} };
+
+        ClipStack clipStack{};
+        std::vector<HitElement> elements(count);
+        // Each element is a quad, its four vertices carry the clip index
+        std::vector<uint32_t> vertexClips(count * 4);
+        constexpr size_t PANEL_SIZE = 16;
+        runner.run("layout.clip", count, "elements", [&] {
+            clipStack.reset(vk::Extent2D{1920, 1080});
+            for (size_t i = 0; i < count; ++i) {
+                // Every PANEL_SIZE elements share a scroll view, each element clips its own content
+                if (i % PANEL_SIZE == 0) {
+                    if (i != 0) clipStack.pop();
+                    clipStack.push({ rects[i].position - 40.0f, rects[i].size + 300.0f }, glm::vec4(8.0f));
+                }
+                clipStack.push(rects[i], glm::vec4(4.0f));
+                std::fill_n(vertexClips.begin() + static_cast<std::ptrdiff_t>(i * 4), 4, clipStack.getClipIndex());
+                (void)clipStack.getScissor(rects[i]);
+                elements[i] = { static_cast<uint32_t>(i), rects[i], clipStack.current().rect, static_cast<int32_t>(i % 7) };
+                clipStack.pop();
+            }
+            clipStack.pop();
+        });
+
+        HitTestGrid grid{};
+        runner.run("layout.hittest.build", count, "elements", [&] { grid.build(elements); });
+
+        std::vector<glm::vec2> points(count);
+        for (glm::vec2& point : points) point = { position(random), position(random) * 0.6f };
+        size_t hits = 0;
+        runner.run("layout.hittest.query", count, "queries", [&] {
+            hits = 0;
+            for (const glm::vec2& point : points) hits += grid.hitTest(point).has_value();
+        });
+    }
+
+    // Icon-like shapes: rounded frames, circles and curved strokes
+    void BenchmarkPaths(BenchmarkRunner& runner) {
+        constexpr size_t PATHS = 1000;
+        constexpr float TOLERANCE = 0.25f;
+        std::vector<Path> paths(PATHS);
+        for (size_t i = 0; i < PATHS; ++i) {
+            const float s = 16.0f + static_cast<float>(i % 64);
+            paths[i].addRoundedRect({0.0f, 0.0f}, {s * 2.0f, s}, s * 0.25f)
+                    .addCircle({s, s * 0.5f}, s * 0.3f)
+                    .moveTo({0.0f, s * 1.5f})
+                    .cubicTo({s * 0.5f, s}, {s * 1.5f, s * 2.0f}, {s * 2.0f, s * 1.5f})
+                    .quadTo({s, s * 2.5f}, {0.0f, s * 1.5f})
+                    .close();
+        }
+
+        const StrokeStyle stroke{ 2.0f, LineJoin::Round, LineCap::Round, 4.0f };
+        size_t segments = 0;
+        runner.run("path.fill", PATHS, "paths", [&] {
+            segments = 0;
+            for (const Path& path : paths) segments += BuildFillGeometry(path, FillRule::NonZero, TOLERANCE).segments.size();
+        });
+        runner.run("path.stroke", PATHS, "paths", [&] {
+            for (const Path& path : paths) segments += BuildStrokeGeometry(path, stroke, TOLERANCE).segments.size();
+        });
+    }
+
+    void BenchmarkVertexEncoding(BenchmarkRunner& runner) {
+        using ufox::graphics::vulkan::VertexLayout;
+        const size_t count = runner.getOptions().elementCount * 4;
+        std::vector<ufox::graphics::Vertex> vertices(count);
+        for (size_t i = 0; i < count; ++i) {
+            const ufox::graphics::Vertex& corner = ufox::graphics::TestRect[i % 4];
+            vertices[i] = { corner.position * 64.0f + glm::vec3(static_cast<float>(i % 1800), static_cast<float>(i % 1000), 0.0f),
+                            corner.color, corner.texCoord };
+        }
+
+        std::vector<std::byte> output(count * GetVertexStride(VertexLayout::Standard));
+        runner.run("vertices.gui", count, "vertices", [&] { WriteVertices(VertexLayout::Gui, vertices, output.data()); });
+        runner.run("vertices.packed", count, "vertices", [&] { WriteVertices(VertexLayout::GuiPacked, vertices, output.data()); });
+    }
+
+    void BenchmarkTextures(BenchmarkRunner& runner) {
+        using namespace ufox::assets;
+        const std::filesystem::path image = std::filesystem::path(UFOX_CONTENTS_DIR) / "statue-1275469_1280.jpg";
+
+        // What GraphicsDevice does for loose files: decode, convert to RGBA8 and copy into upload memory
+        std::vector<std::byte> pixels;
+        uint32_t width = 0, height = 0;
+        const auto decode = [&] {
+            std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> raw{IMG_Load(image.string().c_str()), SDL_DestroySurface};
+            if (!raw) throw std::runtime_error(std::string("Failed to load texture: ") + SDL_GetError());
+            std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> converted{SDL_ConvertSurface(raw.get(), SDL_PIXELFORMAT_ABGR8888), SDL_DestroySurface};
+            if (!converted) throw std::runtime_error(std::string("Failed to convert texture: ") + SDL_GetError());
+
+            width = static_cast<uint32_t>(converted->w);
+            height = static_cast<uint32_t>(converted->h);
+            const size_t rowSize = size_t{width} * 4;
+            pixels.resize(rowSize * height);
+            for (uint32_t y = 0; y < height; ++y)
+                std::memcpy(pixels.data() + y * rowSize, static_cast<const std::byte*>(converted->pixels) + static_cast<size_t>(y) * converted->pitch, rowSize);
+        };
+
+        try {
+            decode();
+        } catch (const std::exception& e) {
+            runner.fail("texture.decode", e.what());
+            return;
+        }
+        const double pixelCount = static_cast<double>(width) * height;
+        runner.run("texture.decode", pixelCount, "pixels", decode);
+
+        const std::vector<std::byte> compressed = LzCompress(pixels);
+        std::vector<std::byte> decompressed(pixels.size());
+        runner.run("texture.lz.compress", static_cast<double>(pixels.size()), "bytes", [&] { (void)LzCompress(pixels); });
+        if (auto* result = runner.run("texture.lz.decompress", static_cast<double>(pixels.size()), "bytes",
+                                      [&] { (void)LzDecompress(compressed, decompressed); }))
+            result->valid = decompressed == pixels;
+
+        // The packed path: map the archive, find the entry and copy its GPU-ready pixels
+        const std::filesystem::path packPath = std::filesystem::temp_directory_path() / "ufox_benchmark.ufpk";
+        AssetPackWriter writer{};
+        writer.addTexture("statue", TextureHeader{ width, height, TextureFormat::Rgba8Srgb, 1 }, pixels);
+        writer.write(packPath);
+        runner.run("texture.pack", pixelCount, "pixels", [&] {
+            const AssetPack pack(packPath);
+            const PackEntry* entry = pack.find("statue");
+            if (!entry) throw std::runtime_error("Benchmark pack lost its texture");
+            const TextureView texture = pack.getTexture(*entry);
+            std::memcpy(decompressed.data(), texture.pixels.data(), std::min(texture.pixels.size(), decompressed.size()));
+        });
+        std::error_code error;
+        std::filesystem::remove(packPath, error);
+    }
+
+    void PrintUsage() {
+        fmt::println("Usage: UFox-Benchmarks [options]\n"
+                     "  --filter <text>        only run benchmarks whose name contains text\n"
+                     "  --count <n>            elements per CPU benchmark, default 100000\n"
+                     "  --repetitions <n>      timed runs per benchmark, default 15\n"
+                     "  --json <file>          write the results, the same file works as a baseline later\n"
+                     "  --baseline <file>      compare against a previous --json run\n"
+                     "  --threshold <percent>  slowdown that counts as a regression, default 10\n"
+                     "  --headless             also run the GPU benchmarks on an offscreen window. Run from bin so the\n"
+                     "                         shaders are found; for lavapipe set VK_DRIVER_FILES to its ICD json, and\n"
+                     "                         MESA_SHADER_CACHE_DISABLE=true to keep cold pipeline builds cold");
+    }
+
+    BenchmarkOptions ParseOptions(int argc, char** argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error("Missing value for " + argument);
+                return argv[++i];
+            };
+
+            if (argument == "--filter") options.filter = value();
+            else if (argument == "--count") options.elementCount = std::stoul(value());
+            else if (argument == "--repetitions") options.repetitions = std::max(1, std::stoi(value()));
+            else if (argument == "--json") options.jsonPath = value();
+            else if (argument == "--baseline") options.baselinePath = value();
+            else if (argument == "--threshold") options.threshold = std::stod(value()) / 100.0;
+            else if (argument == "--headless") options.headless = true;
+            else if (argument == "--help") {
+                PrintUsage();
+                std::exit(0);
+            }
+            else throw std::runtime_error("Unknown option " + argument);
+        }
+        return options;
+    }
+}
+
+namespace ufox::benchmarks {
+    void RunCpuBenchmarks(BenchmarkRunner &runner) {
+        BenchmarkQuadBatch(runner);
+        BenchmarkDrawList(runner);
+        BenchmarkLayout(runner);
+        BenchmarkPaths(runner);
+        BenchmarkVertexEncoding(runner);
+        BenchmarkTextures(runner);
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace ufox::benchmarks;
+    try {
+        BenchmarkRunner runner(ParseOptions(argc, argv));
+        const BenchmarkOptions& options = runner.getOptions();
+
+        fmt::println("Runtime dispatch selects {}, best and median of {} runs", ToString(GetSimdLevel()), options.repetitions);
+        RunCpuBenchmarks(runner);
+        if (options.headless) RunGpuBenchmarks(runner);
+
+        if (options.jsonPath) {
+            WriteJson(*options.jsonPath, runner.getResults(), ToString(GetSimdLevel()));
+            fmt::println("Results written to {}", options.jsonPath->string());
+        }
+
+        uint32_t regressions = 0;
+        if (options.baselinePath) {
+            // A first run on a new machine has nothing to compare against yet
+            if (std::filesystem::exists(*options.baselinePath))
+                regressions = CompareWithBaseline(runner.getResults(), ReadBaseline(*options.baselinePath), options.threshold);
+            else
+                fmt::println("Baseline {} not found, skipping the comparison", options.baselinePath->string());
+        }
+
+        const auto mismatches = std::ranges::count_if(runner.getResults(), [](const BenchmarkResult& result) { return !result.valid; });
+        if (regressions > 0 || mismatches > 0 || !runner.getFailures().empty()) {
+            fmt::println("{} regressions, {} mismatches, {} failures", regressions, mismatches, runner.getFailures().size());
+            return 1;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        fmt::println("Error: {}", e.what());
+        return 1;
+    }
+}
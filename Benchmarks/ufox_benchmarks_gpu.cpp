@@ -0,0 +1,290 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <fmt/core.h>
+#include <SDL3/SDL.h>
+#include <Windowing/ufox_windowing.hpp>
+#include <Engine/ufox_graphic.hpp>
+#include <Engine/ufox_gui_cull.hpp>
+#include <Engine/ufox_gui_effects.hpp>
+#include <Engine/ufox_render_target_pool.hpp>
+#include "ufox_benchmark_harness.hpp"
+
+namespace {
+    using namespace ufox::graphics::vulkan;
+    using ufox::benchmarks::BenchmarkResult;
+    using ufox::benchmarks::BenchmarkRunner;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr vk::Extent2D FRAME_EXTENT{1280, 720};
+    constexpr std::array PIPELINE_BENCHMARKS{ "gpu.pipeline.cold", "gpu.pipeline.driver_cache", "gpu.pipeline.lookup" };
+    constexpr std::array GPU_BENCHMARKS{ "gpu.upload", "gpu.pipeline.cold", "gpu.pipeline.driver_cache", "gpu.pipeline.lookup", "gpu.cull",
+                                         "gpu.effects.blur", "gpu.frame" };
+
+    void BenchmarkUpload(BenchmarkRunner& runner, GraphicsDevice& gpu) {
+        constexpr vk::DeviceSize UPLOAD_SIZE = 64ull << 20;
+        if (!runner.isEnabled("gpu.upload")) return;
+
+        Buffer staging{};
+        Buffer destination{};
+        gpu.createBuffer(UPLOAD_SIZE, vk::BufferUsageFlagBits::eTransferSrc,
+                         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, staging);
+        gpu.createBuffer(UPLOAD_SIZE, vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal, destination);
+
+        // Filling staging memory is part of every upload, so it is timed together with the copy
+        void* mapped = staging.memory->mapMemory(0, UPLOAD_SIZE);
+        std::vector<std::byte> source(UPLOAD_SIZE, std::byte{0x5A});
+        runner.run("gpu.upload", static_cast<double>(UPLOAD_SIZE), "bytes", [&] {
+            std::memcpy(mapped, source.data(), source.size());
+            gpu.copyBuffer(staging, destination, UPLOAD_SIZE);
+        });
+        staging.memory->unmapMemory();
+    }
+
+    // A scroll view's worth of instances, some outside the target, some outside their clip and some empty. The
+    // compacted commands are read back and compared with a CPU reference of gui_cull.comp, including the zeroed
+    // tail that plain indirect draws rely on, and a few instances past capacity check the dropped count.
+    void BenchmarkCull(BenchmarkRunner& runner, GraphicsDevice& gpu) {
+        using namespace ufox::renderer::gui;
+        constexpr uint32_t INSTANCES = 20000;
+        constexpr uint32_t OVERFLOW = 16;
+        if (!runner.isEnabled("gpu.cull")) return;
+
+        std::mt19937 random{5};
+        std::uniform_int_distribution<int> position(-400, 1600);
+        std::uniform_int_distribution<int> size(0, 300);
+        std::vector<CullInstance> instances(INSTANCES + OVERFLOW);
+        for (uint32_t i = 0; i < instances.size(); ++i) {
+            CullInstance& instance = instances[i];
+            instance.rect = glm::vec4(position(random), position(random) / 2, size(random), size(random));
+            instance.clip = i % 3 == 0 ? glm::vec4(0.0f, 0.0f, 640.0f, 360.0f) : glm::vec4(0.0f, 0.0f, 4096.0f, 4096.0f);
+            instance.firstIndex = i * 6;
+            instance.indexCount = i % 50 == 0 ? 0 : 6;
+            instance.vertexOffset = static_cast<int32_t>(i % 4);
+        }
+
+        const glm::vec2 viewportMin{0.0f};
+        const glm::vec2 viewportMax{FRAME_EXTENT.width, FRAME_EXTENT.height};
+        // firstInstance names the instance only where drawIndirectFirstInstance is enabled, drawInstances always does
+        const bool firstInstance = gpu.supportsDrawIndirectFirstInstance();
+        std::vector<vk::DrawIndexedIndirectCommand> expected(INSTANCES);
+        std::vector<uint32_t> expectedInstances;
+        uint32_t visible = 0;
+        for (uint32_t i = 0; i < INSTANCES; ++i) {
+            const CullInstance& instance = instances[i];
+            const glm::vec2 lo = glm::max(glm::vec2(instance.rect), glm::max(glm::vec2(instance.clip), viewportMin));
+            const glm::vec2 hi = glm::min(glm::vec2(instance.rect) + glm::vec2(instance.rect.z, instance.rect.w),
+                                          glm::min(glm::vec2(instance.clip) + glm::vec2(instance.clip.z, instance.clip.w), viewportMax));
+            if (instance.indexCount > 0 && hi.x > lo.x && hi.y > lo.y) {
+                expected[visible++] = vk::DrawIndexedIndirectCommand{ instance.indexCount, 1, instance.firstIndex, instance.vertexOffset,
+                                                                      firstInstance ? i : 0 };
+                expectedInstances.push_back(i);
+            }
+        }
+
+        GuiCullPass pass(gpu, INSTANCES);
+        const vk::DeviceSize commandSize = sizeof(vk::DrawIndexedIndirectCommand) * INSTANCES;
+        const vk::DeviceSize instanceIndexSize = sizeof(uint32_t) * INSTANCES;
+        Buffer readback{};
+        gpu.createBuffer(commandSize, vk::BufferUsageFlagBits::eTransferDst,
+                         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, readback);
+        Buffer instanceReadback{};
+        gpu.createBuffer(instanceIndexSize, vk::BufferUsageFlagBits::eTransferDst,
+                         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, instanceReadback);
+
+        vk::MemoryBarrier2 copyBarrier{};
+        copyBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                   .setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+                   .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                   .setDstAccessMask(vk::AccessFlagBits2::eTransferRead);
+        vk::MemoryBarrier2 hostBarrier{};
+        hostBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                   .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                   .setDstStageMask(vk::PipelineStageFlagBits2::eHost)
+                   .setDstAccessMask(vk::AccessFlagBits2::eHostRead);
+
+        uint32_t uploaded = 0;
+        auto* result = runner.run("gpu.cull", INSTANCES, "instances", [&] {
+            uploaded = pass.upload(0, instances);
+            vk::raii::CommandBuffer cmd = gpu.beginSingleTimeCommands();
+            pass.record(cmd, 0, vk::Rect2D{ {0, 0}, FRAME_EXTENT });
+            cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(copyBarrier));
+            cmd.copyBuffer(*pass.getCommandBuffer(0).data, *readback.data, vk::BufferCopy{ 0, 0, commandSize });
+            cmd.copyBuffer(*pass.getDrawInstanceBuffer(0).data, *instanceReadback.data, vk::BufferCopy{ 0, 0, instanceIndexSize });
+            cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(hostBarrier));
+            gpu.endSingleTimeCommands(cmd);
+        });
+        if (!result) return;
+
+        const CullStats stats = pass.readStats(0);
+        const void* commands = readback.memory->mapMemory(0, commandSize);
+        const void* drawInstances = instanceReadback.memory->mapMemory(0, instanceIndexSize);
+        // Slots past the survivors are never written
+        result->valid = uploaded == INSTANCES && stats.dropped == OVERFLOW && stats.visible == visible &&
+                        stats.culled == INSTANCES - visible && pass.writesFirstInstance() == firstInstance &&
+                        std::memcmp(commands, expected.data(), commandSize) == 0 &&
+                        std::memcmp(drawInstances, expectedInstances.data(), expectedInstances.size() * sizeof(uint32_t)) == 0;
+        instanceReadback.memory->unmapMemory();
+        readback.memory->unmapMemory();
+        fmt::println("  {:<40} {} of {} visible", "", stats.visible, INSTANCES);
+    }
+
+    // A backdrop blur every frame, with drawFrame advancing the device frame counter the pool is clocked by. Once the
+    // frames in flight are covered every blur target must come out of the pool again, and idle images stay in budget.
+    void BenchmarkBlurPool(BenchmarkRunner& runner, GraphicsDevice& gpu) {
+        using namespace ufox::renderer::gui;
+        constexpr vk::DeviceSize IDLE_BUDGET = 32ull << 20;
+        constexpr int MAX_WARMUP_FRAMES = 600;
+        if (!runner.isEnabled("gpu.effects.blur")) return;
+
+        gpu.recreateSwapchain(FRAME_EXTENT);
+        RenderTargetPool pool(gpu, IDLE_BUDGET);
+        EffectsRenderer effects(gpu, pool);
+
+        Image source{};
+        source.format = vk::Format::eR8G8B8A8Unorm;
+        source.extent = FRAME_EXTENT;
+        gpu.createImage(vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+                        vk::MemoryPropertyFlagBits::eDeviceLocal, source);
+        source.view.emplace(gpu.getDevice(), vk::ImageViewCreateInfo{ {}, *source.data, vk::ImageViewType::e2D, source.format, {},
+                                                                     { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 } });
+        gpu.transitionImageLayout(source, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+        gpu.transitionImageLayout(source, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        uint32_t slot = 0;
+        const auto blurFrame = [&] {
+            effects.beginFrame(slot);
+            DrawList drawList{};
+            const bool queued = effects.backdrop(drawList, Rect{ { 100.0f, 100.0f }, { 600.0f, 400.0f } }, glm::vec4(12.0f),
+                                                 BackdropFilter{ 24.0f, glm::vec4(0.0f) }, vk::Rect2D{ {0, 0}, FRAME_EXTENT }, FRAME_EXTENT);
+            vk::raii::CommandBuffer cmd = gpu.beginSingleTimeCommands();
+            effects.record(cmd, source);
+            gpu.endSingleTimeCommands(cmd);
+            gpu.drawFrame(FRAME_EXTENT);
+            slot = (slot + 1) % MAX_FRAMES_IN_FLIGHT;
+            return queued;
+        };
+
+        // The backdrop pipeline compiles in the background, then the frames in flight fill the pool once
+        int warmup = 0;
+        while (!blurFrame()) {
+            if (++warmup == MAX_WARMUP_FRAMES) {
+                runner.fail("gpu.effects.blur", "backdrop pipeline never became ready");
+                return;
+            }
+        }
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) blurFrame();
+
+        const RenderTargetPoolStats before = pool.getStats();
+        auto* result = runner.run("gpu.effects.blur", 1.0, "frames", [&] { blurFrame(); });
+        gpu.waitForIdle();
+        if (!result) return;
+
+        const RenderTargetPoolStats after = pool.getStats();
+        result->valid = effects.getStats().blurPasses > 0 && after.created == before.created &&
+                        after.reused > before.reused && after.idleBytes <= IDLE_BUDGET;
+        fmt::println("  {:<40} {} created, {} reused, {} idle bytes", "", after.created, after.reused, after.idleBytes);
+    }
+
+    // Every blend mode over every vertex layout shader.vert understands, what a GUI with a few widget kinds warms up
+    std::vector<PipelineKey> MakePipelineVariants(const GraphicsDevice& gpu) {
+        std::vector<PipelineKey> keys;
+        for (const VertexLayout layout : { VertexLayout::Standard, VertexLayout::Gui, VertexLayout::GuiPacked }) {
+            for (const BlendMode blend : { BlendMode::Opaque, BlendMode::AlphaBlend, BlendMode::Premultiplied, BlendMode::Additive, BlendMode::Layer }) {
+                PipelineKey key = gpu.makePipelineKey();
+                key.vertexLayout = layout;
+                key.specialization = ufox::renderer::gui::GetLayoutSpecialization(layout);
+                key.blendMode = blend;
+                keys.push_back(std::move(key));
+            }
+        }
+        return keys;
+    }
+
+    void BenchmarkPipelines(BenchmarkRunner& runner, GraphicsDevice& gpu) {
+        if (!std::ranges::any_of(PIPELINE_BENCHMARKS, [&](const char* name) { return runner.isEnabled(name); })) return;
+
+        const std::vector<PipelineKey> keys = MakePipelineVariants(gpu);
+        const auto buildAll = [&](PipelineCache& cache) {
+            for (const PipelineKey& key : keys) {
+                if (!cache.getOrCreate(key)) throw std::runtime_error("Pipeline variant failed to build");
+            }
+        };
+
+        // A fresh cache each run owns an empty VkPipelineCache, nothing is shared with the previous build
+        runner.run("gpu.pipeline.cold", static_cast<double>(keys.size()), "pipelines", [&] {
+            PipelineCache cache(gpu.getDevice(), gpu.getJobSystem(), gpu.getLayoutCache(), gpu.getShaderCompiler());
+            buildAll(cache);
+        });
+
+        // clear() drops the pipelines but keeps the driver cache, like a restart with a persisted cache
+        PipelineCache cache(gpu.getDevice(), gpu.getJobSystem(), gpu.getLayoutCache(), gpu.getShaderCompiler());
+        runner.run("gpu.pipeline.driver_cache", static_cast<double>(keys.size()), "pipelines", [&] {
+            cache.clear();
+            buildAll(cache);
+        });
+
+        buildAll(cache);
+        runner.run("gpu.pipeline.lookup", static_cast<double>(keys.size()), "pipelines", [&] { buildAll(cache); });
+    }
+
+    void BenchmarkDrawFrame(BenchmarkRunner& runner, GraphicsDevice& gpu) {
+        constexpr int WARMUP_FRAMES = 60;
+        if (!runner.isEnabled("gpu.frame")) return;
+
+        // Immediate presentation, vsync would turn the measurement into the display refresh rate
+        gpu.useVsync = false;
+        gpu.recreateSwapchain(FRAME_EXTENT);
+
+        // Shaders and the texture finish loading in the background during the first frames
+        for (int i = 0; i < WARMUP_FRAMES; ++i) gpu.drawFrame(FRAME_EXTENT);
+        gpu.waitForIdle();
+
+        const int frames = std::max(runner.getOptions().repetitions * 20, 100);
+        std::vector<double> times;
+        times.reserve(frames);
+        const auto total = Clock::now();
+        for (int i = 0; i < frames; ++i) {
+            const auto start = Clock::now();
+            gpu.drawFrame(FRAME_EXTENT);
+            times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        gpu.waitForIdle();
+        const double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - total).count();
+        std::ranges::sort(times);
+
+        // Single frames overlap with the GPU, the mean over the whole run is the sustained frame time
+        runner.report({ "gpu.frame", times.front(), times[times.size() / 2], 1.0, "frames", true });
+        runner.report({ "gpu.frame.sustained", totalMs / frames, totalMs / frames, 1.0, "frames", true });
+    }
+}
+
+namespace ufox::benchmarks {
+    void RunGpuBenchmarks(BenchmarkRunner &runner) {
+        if (!std::ranges::any_of(GPU_BENCHMARKS, [&](const char* name) { return runner.isEnabled(name); })) return;
+
+        // No display in CI: the offscreen driver creates its Vulkan surfaces through VK_EXT_headless_surface
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        try {
+            windowing::sdl::UfoxWindow window("UFox Benchmarks", SDL_WINDOW_VULKAN);
+            GraphicsDevice gpu(window, "UFox Engine", vk::makeApiVersion(0, 1, 0, 0),
+                               "UFox Benchmarks", vk::makeApiVersion(0, 1, 0, 0));
+
+            BenchmarkUpload(runner, gpu);
+            BenchmarkPipelines(runner, gpu);
+            BenchmarkCull(runner, gpu);
+            BenchmarkBlurPool(runner, gpu);
+            BenchmarkDrawFrame(runner, gpu);
+            gpu.waitForIdle();
+        } catch (const std::exception& e) {
+            runner.fail("gpu", e.what());
+        }
+    }
+}
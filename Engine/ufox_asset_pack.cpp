@@ -0,0 +1,419 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_asset_pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <fmt/format.h>
+#include "Engine/ufox_hash.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ufox::assets {
+    namespace {
+        constexpr size_t MIN_MATCH = 4;
+        constexpr size_t MAX_OFFSET = 65535;
+        constexpr uint32_t HASH_BITS = 14;
+
+        uint32_t Load32(const std::byte* p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        void WriteLength(std::vector<std::byte>& out, size_t length) {
+            while (length >= 255) {
+                out.push_back(std::byte{255});
+                length -= 255;
+            }
+            out.push_back(static_cast<std::byte>(length));
+        }
+
+        void EmitSequence(std::vector<std::byte>& out, std::span<const std::byte> literals, size_t offset, size_t matchLength) {
+            const size_t literalCode = std::min<size_t>(literals.size(), 15);
+            const size_t matchCode = matchLength ? std::min<size_t>(matchLength - MIN_MATCH, 15) : 0;
+            out.push_back(static_cast<std::byte>(literalCode << 4 | matchCode));
+            if (literalCode == 15) WriteLength(out, literals.size() - 15);
+            out.insert(out.end(), literals.begin(), literals.end());
+
+            // The last sequence carries literals only, the decoder stops once its input is exhausted
+            if (matchLength == 0) return;
+            out.push_back(static_cast<std::byte>(offset & 0xff));
+            out.push_back(static_cast<std::byte>(offset >> 8));
+            if (matchCode == 15) WriteLength(out, matchLength - MIN_MATCH - 15);
+        }
+
+        size_t ReadLength(std::span<const std::byte> source, size_t& ip) {
+            size_t length = 0;
+            uint8_t value;
+            do {
+                if (ip >= source.size()) throw std::runtime_error("Truncated LZ length");
+                value = static_cast<uint8_t>(source[ip++]);
+                length += value;
+            } while (value == 255);
+            return length;
+        }
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        template<typename T>
+        std::span<const std::byte> AsBytes(const T& value) {
+            return std::as_bytes(std::span{ &value, 1 });
+        }
+    }
+
+#pragma region LZ
+    std::vector<std::byte> LzCompress(std::span<const std::byte> source) {
+        std::vector<std::byte> out;
+        out.reserve(source.size() + source.size() / 255 + 16);
+
+        // Positions are stored plus one so zero marks an empty slot
+        std::vector<uint32_t> table(size_t{1} << HASH_BITS, 0);
+        const std::byte* src = source.data();
+        const size_t size = source.size();
+        size_t anchor = 0;
+        size_t i = 0;
+
+        while (i + MIN_MATCH <= size) {
+            const uint32_t sequence = Load32(src + i);
+            const uint32_t slot = (sequence * 2654435761u) >> (32 - HASH_BITS);
+            const size_t candidate = table[slot];
+            table[slot] = static_cast<uint32_t>(i + 1);
+
+            if (candidate == 0 || i - (candidate - 1) > MAX_OFFSET || Load32(src + candidate - 1) != sequence) {
+                ++i;
+                continue;
+            }
+
+            const size_t match = candidate - 1;
+            size_t length = MIN_MATCH;
+            while (i + length < size && src[match + length] == src[i + length]) ++length;
+
+            EmitSequence(out, source.subspan(anchor, i - anchor), i - match, length);
+            i += length;
+            anchor = i;
+        }
+
+        EmitSequence(out, source.subspan(anchor), 0, 0);
+        return out;
+    }
+
+    size_t LzDecompress(std::span<const std::byte> source, std::span<std::byte> destination) {
+        size_t ip = 0;
+        size_t op = 0;
+
+        while (ip < source.size()) {
+            const auto token = static_cast<uint8_t>(source[ip++]);
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15) literalLength += ReadLength(source, ip);
+            if (literalLength > source.size() - ip || literalLength > destination.size() - op)
+                throw std::runtime_error("LZ literals run past the buffer");
+            if (literalLength) std::memcpy(destination.data() + op, source.data() + ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            if (ip == source.size()) break;
+
+            if (source.size() - ip < 2) throw std::runtime_error("Truncated LZ offset");
+            const size_t offset = static_cast<size_t>(source[ip]) | static_cast<size_t>(source[ip + 1]) << 8;
+            ip += 2;
+            if (offset == 0 || offset > op) throw std::runtime_error("LZ offset points before the output");
+
+            size_t matchLength = token & 0x0f;
+            if (matchLength == 15) matchLength += ReadLength(source, ip);
+            matchLength += MIN_MATCH;
+            if (matchLength > destination.size() - op) throw std::runtime_error("LZ match runs past the buffer");
+
+            std::byte* out = destination.data() + op;
+            const std::byte* from = out - offset;
+            if (offset >= matchLength) std::memcpy(out, from, matchLength);
+            else for (size_t j = 0; j < matchLength; ++j) out[j] = from[j];
+            op += matchLength;
+        }
+        return op;
+    }
+#pragma endregion
+
+#pragma region MappedFile
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+#if defined(_WIN32)
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open " + path.string());
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(handle);
+            throw std::runtime_error("Failed to size " + path.string());
+        }
+
+        mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(handle);
+        if (!mapping) throw std::runtime_error("Failed to map " + path.string());
+
+        data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data) {
+            CloseHandle(mapping);
+            mapping = nullptr;
+            throw std::runtime_error("Failed to map " + path.string());
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("Failed to open " + path.string());
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to size " + path.string());
+        }
+
+        void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+        if (address == MAP_FAILED) throw std::runtime_error("Failed to map " + path.string());
+
+        data = static_cast<const std::byte*>(address);
+        size = static_cast<size_t>(info.st_size);
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept :
+        data{std::exchange(other.data, nullptr)}, size{std::exchange(other.size, 0)}
+#if defined(_WIN32)
+        , mapping{std::exchange(other.mapping, nullptr)}
+#endif
+    {}
+
+    MappedFile& MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+#if defined(_WIN32)
+            mapping = std::exchange(other.mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    void MappedFile::close() {
+        if (!data) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        ::munmap(const_cast<std::byte*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+#pragma endregion
+
+#pragma region AssetPack
+    AssetPack::AssetPack(const std::filesystem::path &path) : file{path} {
+        std::span<const std::byte> bytes = file.getBytes();
+        if (bytes.size() < sizeof(PackHeader)) throw std::runtime_error("Asset pack is truncated: " + path.string());
+
+        PackHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0)
+            throw std::runtime_error("Not an asset pack: " + path.string());
+        if (header.version != PACK_VERSION)
+            throw std::runtime_error(fmt::format("Unsupported asset pack version {} in {}", header.version, path.string()));
+
+        const uint64_t tocSize = uint64_t{header.entryCount} * sizeof(PackEntry);
+        if (header.tocOffset % TOC_ALIGNMENT != 0 || header.tocOffset > bytes.size() || tocSize > bytes.size() - header.tocOffset ||
+            header.namesOffset < header.tocOffset + tocSize || header.namesOffset > bytes.size())
+            throw std::runtime_error("Asset pack table of contents is corrupt: " + path.string());
+
+        // The mapping is page aligned and the table offset is a multiple of 64, so entries can be used in place
+        entries = { reinterpret_cast<const PackEntry*>(bytes.data() + header.tocOffset), header.entryCount };
+
+        uint64_t namesEnd = header.namesOffset;
+        for (const PackEntry& entry : entries) {
+            if (entry.offset > bytes.size() || entry.storedSize > bytes.size() - entry.offset)
+                throw std::runtime_error("Asset pack entry is out of bounds: " + path.string());
+            namesEnd = std::max<uint64_t>(namesEnd, header.namesOffset + entry.nameOffset + entry.nameLength);
+        }
+        if (namesEnd > bytes.size()) throw std::runtime_error("Asset pack names are out of bounds: " + path.string());
+
+        names = { reinterpret_cast<const char*>(bytes.data() + header.namesOffset), static_cast<size_t>(namesEnd - header.namesOffset) };
+    }
+
+    const PackEntry* AssetPack::find(std::string_view name) const {
+        const uint64_t hash = hash::Fnv1a64(name);
+        auto it = std::ranges::lower_bound(entries, hash, {}, &PackEntry::nameHash);
+        if (it == entries.end() || it->nameHash != hash || getName(*it) != name) return nullptr;
+        return &*it;
+    }
+
+    std::string_view AssetPack::getName(const PackEntry &entry) const {
+        return names.substr(entry.nameOffset, entry.nameLength);
+    }
+
+    std::span<const std::byte> AssetPack::view(const PackEntry &entry) const {
+        return file.getBytes().subspan(entry.offset, entry.storedSize);
+    }
+
+    void AssetPack::read(const PackEntry &entry, std::span<std::byte> destination) const {
+        if (destination.size() < entry.size)
+            throw std::runtime_error(fmt::format("Destination too small for {}: {} < {}", getName(entry), destination.size(), entry.size));
+
+        std::span<const std::byte> stored = view(entry);
+        switch (entry.compression) {
+            case Compression::None:
+                if (entry.size) std::memcpy(destination.data(), stored.data(), entry.size);
+                return;
+            case Compression::Lz:
+                if (LzDecompress(stored, destination.first(entry.size)) != entry.size)
+                    throw std::runtime_error(fmt::format("Decompressed size mismatch for {}", getName(entry)));
+                return;
+        }
+        throw std::runtime_error(fmt::format("Unknown compression for {}", getName(entry)));
+    }
+
+    bool AssetPack::verify(const PackEntry &entry) const {
+        if (entry.compression == Compression::None)
+            return hash::Fnv1a64(view(entry)) == entry.contentHash;
+
+        std::vector<std::byte> payload(entry.size);
+        try {
+            read(entry, payload);
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+        return hash::Fnv1a64(std::span<const std::byte>{payload}) == entry.contentHash;
+    }
+
+    TextureView AssetPack::getTexture(const PackEntry &entry) const {
+        if (entry.type != AssetType::Texture || entry.compression != Compression::None || entry.size < sizeof(TextureHeader))
+            throw std::runtime_error(fmt::format("{} is not an uncompressed texture", getName(entry)));
+
+        std::span<const std::byte> payload = view(entry);
+        TextureView texture{};
+        std::memcpy(&texture.header, payload.data(), sizeof(TextureHeader));
+        texture.pixels = payload.subspan(sizeof(TextureHeader));
+        if (texture.pixels.size() != uint64_t{texture.header.width} * texture.header.height * 4)
+            throw std::runtime_error(fmt::format("Texture {} has a size mismatch", getName(entry)));
+        return texture;
+    }
+#pragma endregion
+
+#pragma region AssetPackWriter
+    void AssetPackWriter::add(std::string name, AssetType type, std::span<const std::byte> payload, Compression compression) {
+        PendingEntry entry{ std::move(name), type, compression, payload.size(), hash::Fnv1a64(payload), {} };
+        if (compression == Compression::Lz) {
+            entry.stored = LzCompress(payload);
+            // Not worth a decode step if it barely shrinks
+            if (entry.stored.size() + entry.stored.size() / 16 >= payload.size()) entry.compression = Compression::None;
+        }
+        if (entry.compression == Compression::None) entry.stored.assign(payload.begin(), payload.end());
+        pending.push_back(std::move(entry));
+    }
+
+    void AssetPackWriter::addTexture(std::string name, const TextureHeader &header, std::span<const std::byte> pixels) {
+        std::vector<std::byte> payload;
+        payload.reserve(sizeof(TextureHeader) + pixels.size());
+        std::span<const std::byte> headerBytes = AsBytes(header);
+        payload.insert(payload.end(), headerBytes.begin(), headerBytes.end());
+        payload.insert(payload.end(), pixels.begin(), pixels.end());
+        add(std::move(name), AssetType::Texture, payload, Compression::None);
+    }
+
+    void AssetPackWriter::write(const std::filesystem::path &path) const {
+        std::vector<size_t> order(pending.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::vector<uint64_t> nameHashes(pending.size());
+        for (size_t i = 0; i < pending.size(); ++i) nameHashes[i] = hash::Fnv1a64(pending[i].name);
+        std::ranges::sort(order, {}, [&](size_t i) { return nameHashes[i]; });
+
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (nameHashes[order[i]] == nameHashes[order[i - 1]])
+                throw std::runtime_error(fmt::format("Asset names collide: {} and {}", pending[order[i]].name, pending[order[i - 1]].name));
+        }
+
+        PackHeader header{};
+        std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+        header.version = PACK_VERSION;
+        header.entryCount = static_cast<uint32_t>(pending.size());
+        header.tocOffset = AlignUp(sizeof(PackHeader), TOC_ALIGNMENT);
+        header.namesOffset = header.tocOffset + pending.size() * sizeof(PackEntry);
+
+        std::vector<PackEntry> toc(pending.size());
+        std::string names;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const PendingEntry& source = pending[order[i]];
+            PackEntry& entry = toc[i];
+            entry.nameHash = nameHashes[order[i]];
+            entry.contentHash = source.contentHash;
+            entry.storedSize = source.stored.size();
+            entry.size = source.size;
+            entry.nameOffset = static_cast<uint32_t>(names.size());
+            entry.nameLength = static_cast<uint32_t>(source.name.size());
+            entry.type = source.type;
+            entry.compression = source.compression;
+            names += source.name;
+        }
+
+        uint64_t offset = AlignUp(header.namesOffset + names.size(), DATA_ALIGNMENT);
+        for (PackEntry& entry : toc) {
+            entry.offset = offset;
+            offset = AlignUp(offset + entry.storedSize, DATA_ALIGNMENT);
+        }
+
+        // Written next to the target and renamed so a running engine never maps a half written pack
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error("Failed to create " + temporary.string());
+
+            uint64_t position = 0;
+            auto writeBytes = [&](std::span<const std::byte> bytes) {
+                out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                position += bytes.size();
+            };
+            auto pad = [&](uint64_t target) {
+                static constexpr std::byte zeros[DATA_ALIGNMENT]{};
+                while (position < target) writeBytes({ zeros, static_cast<size_t>(std::min<uint64_t>(target - position, DATA_ALIGNMENT)) });
+            };
+
+            writeBytes(AsBytes(header));
+            pad(header.tocOffset);
+            writeBytes(std::as_bytes(std::span{ toc }));
+            writeBytes(std::as_bytes(std::span{ names }));
+            for (size_t i = 0; i < order.size(); ++i) {
+                pad(toc[i].offset);
+                writeBytes(pending[order[i]].stored);
+            }
+            if (!out) throw std::runtime_error("Failed to write " + temporary.string());
+        }
+        std::filesystem::rename(temporary, path);
+    }
+#pragma endregion
+}
@@ -0,0 +1,154 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ufox::assets {
+
+    // Layout of a pack, every offset is from the start of the file:
+    //   PackHeader | PackEntry[entryCount] sorted by name hash | names | payloads aligned to DATA_ALIGNMENT
+    static constexpr char PACK_MAGIC[4] = { 'U', 'F', 'P', 'K' };
+    static constexpr uint32_t PACK_VERSION = 1;
+    static constexpr uint64_t TOC_ALIGNMENT = 64;
+    // Covers nonCoherentAtomSize and optimalBufferCopyOffsetAlignment on every GPU we target
+    static constexpr uint64_t DATA_ALIGNMENT = 256;
+
+    enum class AssetType : uint32_t {
+        Raw,
+        Texture,
+        Shader,
+        Font,
+    };
+
+    enum class Compression : uint32_t {
+        None,
+        Lz,
+    };
+
+    enum class TextureFormat : uint32_t {
+        Rgba8Srgb,
+        Rgba8Unorm,
+    };
+
+    struct PackHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t tocOffset;
+        uint64_t namesOffset;
+    };
+    static_assert(sizeof(PackHeader) == 32);
+
+    struct PackEntry {
+        uint64_t nameHash;
+        // FNV-1a of the uncompressed payload
+        uint64_t contentHash;
+        uint64_t offset;
+        uint64_t storedSize;
+        uint64_t size;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        AssetType type;
+        Compression compression;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(PackEntry) == 64);
+
+    // Payload prefix of AssetType::Texture, pixels follow tightly packed row by row
+    struct TextureHeader {
+        uint32_t width;
+        uint32_t height;
+        TextureFormat format;
+        uint32_t mipCount;
+    };
+    static_assert(sizeof(TextureHeader) == 16);
+
+    struct TextureView {
+        TextureHeader header;
+        std::span<const std::byte> pixels;
+    };
+
+    // Byte oriented LZ77, sequences of literals followed by a back reference. Decoding is a tight copy loop,
+    // compression ratio is secondary since GPU-ready payloads are stored raw anyway.
+    [[nodiscard]] std::vector<std::byte> LzCompress(std::span<const std::byte> source);
+    // Returns the number of bytes written, throws on malformed input or if destination is too small
+    size_t LzDecompress(std::span<const std::byte> source, std::span<std::byte> destination);
+
+    // Read-only view of a whole file, pages are faulted in on first access
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        [[nodiscard]] std::span<const std::byte> getBytes() const { return { data, size }; }
+        [[nodiscard]] bool isOpen() const { return data != nullptr; }
+
+    private:
+        const std::byte* data{nullptr};
+        size_t size{0};
+#if defined(_WIN32)
+        void* mapping{nullptr};
+#endif
+        void close();
+    };
+
+    class AssetPack {
+    public:
+        explicit AssetPack(const std::filesystem::path& path);
+
+        [[nodiscard]] const PackEntry* find(std::string_view name) const;
+        [[nodiscard]] std::string_view getName(const PackEntry& entry) const;
+        [[nodiscard]] std::span<const PackEntry> getEntries() const { return entries; }
+
+        // Stored bytes straight from the mapping, compressed entries have to go through read
+        [[nodiscard]] std::span<const std::byte> view(const PackEntry& entry) const;
+        // Copies or decompresses the payload into destination, e.g. a mapped staging buffer
+        void read(const PackEntry& entry, std::span<std::byte> destination) const;
+        [[nodiscard]] bool verify(const PackEntry& entry) const;
+
+        // Texture entries are always stored uncompressed so their pixels can be copied straight to staging memory
+        [[nodiscard]] TextureView getTexture(const PackEntry& entry) const;
+
+    private:
+        MappedFile file;
+        std::span<const PackEntry> entries{};
+        std::string_view names{};
+    };
+
+    class AssetPackWriter {
+    public:
+        void add(std::string name, AssetType type, std::span<const std::byte> payload, Compression compression);
+        void addTexture(std::string name, const TextureHeader& header, std::span<const std::byte> pixels);
+
+        // Entries whose names hash to the same value are rejected, the reader identifies entries by hash only
+        void write(const std::filesystem::path& path) const;
+
+        [[nodiscard]] size_t getEntryCount() const { return pending.size(); }
+
+    private:
+        struct PendingEntry {
+            std::string name;
+            AssetType type;
+            Compression compression;
+            uint64_t size;
+            uint64_t contentHash;
+            std::vector<std::byte> stored;
+        };
+        std::vector<PendingEntry> pending;
+    };
+}
@@ -0,0 +1,284 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gpu_memory.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <fmt/base.h>
+
+namespace ufox::graphics::vulkan {
+    const char* ToString(MemoryCategory category) {
+        switch (category) {
+            case MemoryCategory::Vertex: return "Vertex";
+            case MemoryCategory::Index: return "Index";
+            case MemoryCategory::Uniform: return "Uniform";
+            case MemoryCategory::Storage: return "Storage";
+            case MemoryCategory::Staging: return "Staging";
+            case MemoryCategory::Texture: return "Texture";
+            case MemoryCategory::Attachment: return "Attachment";
+            default: return "Other";
+        }
+    }
+
+    MemoryCategory CategorizeBuffer(vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties) {
+        if (usage & vk::BufferUsageFlagBits::eVertexBuffer) return MemoryCategory::Vertex;
+        if (usage & vk::BufferUsageFlagBits::eIndexBuffer) return MemoryCategory::Index;
+        if (usage & vk::BufferUsageFlagBits::eUniformBuffer) return MemoryCategory::Uniform;
+        if (usage & (vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer)) return MemoryCategory::Storage;
+        if ((usage & vk::BufferUsageFlagBits::eTransferSrc) && (properties & vk::MemoryPropertyFlagBits::eHostVisible)) return MemoryCategory::Staging;
+        return MemoryCategory::Other;
+    }
+
+    MemoryCategory CategorizeImage(vk::ImageUsageFlags usage) {
+        if (usage & (vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment)) return MemoryCategory::Attachment;
+        if (usage & vk::ImageUsageFlagBits::eSampled) return MemoryCategory::Texture;
+        return MemoryCategory::Other;
+    }
+
+#pragma region MemoryTracker
+    MemoryTracker::MemoryTracker(const vk::raii::PhysicalDevice &physicalDevice, bool hasMemoryBudget) :
+        physicalDevice{physicalDevice}, memoryProperties{physicalDevice.getMemoryProperties()}, useMemoryBudget{hasMemoryBudget} {}
+
+    void MemoryTracker::add(MemoryCategory category, uint32_t heapIndex, vk::DeviceSize size) {
+        auto index = static_cast<size_t>(category);
+        categoryBytes[index].fetch_add(size, std::memory_order_relaxed);
+        categoryAllocations[index].fetch_add(1, std::memory_order_relaxed);
+        heapBytes[heapIndex].fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::remove(MemoryCategory category, uint32_t heapIndex, vk::DeviceSize size) {
+        auto index = static_cast<size_t>(category);
+        categoryBytes[index].fetch_sub(size, std::memory_order_relaxed);
+        categoryAllocations[index].fetch_sub(1, std::memory_order_relaxed);
+        heapBytes[heapIndex].fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    CategoryStats MemoryTracker::getCategory(MemoryCategory category) const {
+        auto index = static_cast<size_t>(category);
+        return { categoryBytes[index].load(std::memory_order_relaxed), categoryAllocations[index].load(std::memory_order_relaxed) };
+    }
+
+    vk::DeviceSize MemoryTracker::getTrackedBytes() const {
+        vk::DeviceSize total = 0;
+        for (const auto& bytes : categoryBytes) total += bytes.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    vk::PhysicalDeviceMemoryBudgetPropertiesEXT MemoryTracker::queryBudgetProperties() const {
+        if (!useMemoryBudget) return {};
+        auto chain = physicalDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        return chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+    }
+
+    HeapBudget MemoryTracker::makeHeapBudget(uint32_t heapIndex, const vk::PhysicalDeviceMemoryBudgetPropertiesEXT &properties) const {
+        const vk::MemoryHeap& heap = memoryProperties.memoryHeaps[heapIndex];
+        HeapBudget budget{};
+        budget.heapIndex = heapIndex;
+        budget.deviceLocal = static_cast<bool>(heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+        budget.size = heap.size;
+        budget.tracked = heapBytes[heapIndex].load(std::memory_order_relaxed);
+        // Without the extension other processes are invisible, leave headroom for them and the driver
+        budget.budget = useMemoryBudget ? properties.heapBudget[heapIndex] : heap.size / 5 * 4;
+        budget.usage = useMemoryBudget ? properties.heapUsage[heapIndex] : budget.tracked;
+        return budget;
+    }
+
+    std::vector<HeapBudget> MemoryTracker::queryBudgets() const {
+        const vk::PhysicalDeviceMemoryBudgetPropertiesEXT properties = queryBudgetProperties();
+        std::vector<HeapBudget> budgets;
+        budgets.reserve(memoryProperties.memoryHeapCount);
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i) budgets.push_back(makeHeapBudget(i, properties));
+        return budgets;
+    }
+
+    std::pair<vk::DeviceSize, vk::DeviceSize> MemoryTracker::queryDeviceLocalBudget() const {
+        const vk::PhysicalDeviceMemoryBudgetPropertiesEXT properties = queryBudgetProperties();
+        vk::DeviceSize budget = 0;
+        vk::DeviceSize usage = 0;
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i) {
+            const HeapBudget heap = makeHeapBudget(i, properties);
+            if (!heap.deviceLocal) continue;
+            budget += heap.budget;
+            usage += heap.usage;
+        }
+        return { budget, usage };
+    }
+
+    void MemoryTracker::printReport() const {
+        fmt::println("GPU memory ({}):", useMemoryBudget ? "VK_EXT_memory_budget" : "tracked only");
+        for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+            CategoryStats stats = getCategory(static_cast<MemoryCategory>(i));
+            if (stats.allocations == 0) continue;
+            fmt::println("  {:<10} {:>10.2f} MiB in {} allocations", ToString(static_cast<MemoryCategory>(i)),
+                         static_cast<double>(stats.bytes) / (1024.0 * 1024.0), stats.allocations);
+        }
+        for (const HeapBudget& heap : queryBudgets()) {
+            fmt::println("  heap {}{}: {:.2f} / {:.2f} MiB, {:.2f} MiB tracked", heap.heapIndex, heap.deviceLocal ? " (device local)" : "",
+                         static_cast<double>(heap.usage) / (1024.0 * 1024.0), static_cast<double>(heap.budget) / (1024.0 * 1024.0),
+                         static_cast<double>(heap.tracked) / (1024.0 * 1024.0));
+        }
+    }
+#pragma endregion
+
+#pragma region MemoryAllocation
+    MemoryAllocation::MemoryAllocation(MemoryTracker &tracker, MemoryCategory category, uint32_t heapIndex, vk::DeviceSize size) :
+        tracker{&tracker}, category{category}, heapIndex{heapIndex}, size{size} {
+        tracker.add(category, heapIndex, size);
+    }
+
+    MemoryAllocation::MemoryAllocation(MemoryAllocation &&other) noexcept :
+        tracker{std::exchange(other.tracker, nullptr)}, category{other.category}, heapIndex{other.heapIndex}, size{std::exchange(other.size, 0)} {}
+
+    MemoryAllocation& MemoryAllocation::operator=(MemoryAllocation &&other) noexcept {
+        if (this != &other) {
+            reset();
+            tracker = std::exchange(other.tracker, nullptr);
+            category = other.category;
+            heapIndex = other.heapIndex;
+            size = std::exchange(other.size, 0);
+        }
+        return *this;
+    }
+
+    void MemoryAllocation::reset() {
+        if (tracker) tracker->remove(category, heapIndex, size);
+        tracker = nullptr;
+        size = 0;
+    }
+#pragma endregion
+
+#pragma region TextureResidencyManager
+    TextureResidencyManager::TextureResidencyManager(MemoryTracker &tracker, uint32_t framesInFlight, float budgetFraction) :
+        tracker{tracker}, framesInFlight{framesInFlight}, budgetFraction{budgetFraction} {}
+
+    TextureId TextureResidencyManager::add(std::string name, uint32_t mipCount, vk::DeviceSize residentBytes, StreamCallback stream) {
+        Texture texture{ std::move(name), std::max(mipCount, 1u), 0, residentBytes, std::nullopt, std::move(stream), true, false };
+        if (!freeIds.empty()) {
+            TextureId id = freeIds.back();
+            freeIds.pop_back();
+            textures[id] = std::move(texture);
+            return id;
+        }
+        textures.push_back(std::move(texture));
+        return static_cast<TextureId>(textures.size() - 1);
+    }
+
+    void TextureResidencyManager::remove(TextureId id) {
+        if (id >= textures.size() || !textures[id].alive) return;
+        textures[id] = Texture{};
+        freeIds.push_back(id);
+    }
+
+    bool TextureResidencyManager::use(TextureId id, uint64_t frameNumber) {
+        if (id >= textures.size() || !textures[id].alive) return false;
+
+        Texture& texture = textures[id];
+        texture.lastUsedFrame = frameNumber;
+        if (texture.baseMip == 0) return true;
+        if (texture.streaming) return false;
+
+        try {
+            std::optional<vk::DeviceSize> residentBytes = texture.stream(id, 0);
+            if (!residentBytes) {
+                texture.streaming = true;
+                return false;
+            }
+            texture.residentBytes = *residentBytes;
+            texture.baseMip = 0;
+            ++restreams;
+        }
+        catch (const std::exception& e) {
+            fmt::println("Failed to restream texture {}: {}", texture.name, e.what());
+            return false;
+        }
+        return true;
+    }
+
+    void TextureResidencyManager::finishStream(TextureId id, std::optional<vk::DeviceSize> residentBytes) {
+        if (id >= textures.size() || !textures[id].alive) return;
+
+        Texture& texture = textures[id];
+        texture.streaming = false;
+        if (!residentBytes) return;
+        texture.residentBytes = *residentBytes;
+        texture.baseMip = 0;
+        ++restreams;
+    }
+
+    void TextureResidencyManager::update(uint64_t frameNumber, std::pmr::memory_resource* scratch) {
+        auto [budget, usage] = tracker.queryDeviceLocalBudget();
+        auto target = static_cast<vk::DeviceSize>(static_cast<double>(budget) * budgetFraction);
+        if (usage <= target) return;
+
+        vk::DeviceSize freed = trim(usage - target, frameNumber, scratch);
+        if (freed < usage - target)
+            fmt::println("GPU memory over budget by {} bytes with nothing left to evict", usage - target - freed);
+    }
+
+    bool TextureResidencyManager::makeRoom(vk::DeviceSize bytes, uint64_t frameNumber) {
+        return trim(bytes, frameNumber, memory::GetHeapResource()) >= bytes;
+    }
+
+    vk::DeviceSize TextureResidencyManager::trim(vk::DeviceSize bytes, uint64_t frameNumber, std::pmr::memory_resource* scratch) {
+        // Least recently used first, frames still in flight may be sampling the rest. A stream callback may
+        // allocate and trim again, so the list is local rather than a reused member.
+        std::pmr::vector<TextureId> candidates(scratch);
+        for (TextureId id = 0; id < textures.size(); ++id) {
+            const Texture& texture = textures[id];
+            if (!texture.alive || texture.streaming || texture.baseMip >= texture.mipCount) continue;
+            if (texture.lastUsedFrame && *texture.lastUsedFrame + framesInFlight >= frameNumber) continue;
+            candidates.push_back(id);
+        }
+        // Textures no frame ever used sort first
+        std::ranges::sort(candidates, [this](TextureId a, TextureId b) {
+            return textures[a].lastUsedFrame < textures[b].lastUsedFrame;
+        });
+
+        vk::DeviceSize freed = 0;
+        for (TextureId id : candidates) {
+            // Dropping the top mip frees about three quarters of the texture and keeps it drawable
+            while (freed < bytes && textures[id].baseMip < textures[id].mipCount) {
+                const uint32_t mipCount = textures[id].mipCount;
+                uint32_t nextMip = textures[id].baseMip + 1;
+                std::optional<vk::DeviceSize> residentBytes = textures[id].stream(id, nextMip);
+                if (!residentBytes && nextMip < mipCount) {
+                    // The smaller mips could not be made resident in the call, evicting needs no new data
+                    nextMip = mipCount;
+                    residentBytes = textures[id].stream(id, nextMip);
+                }
+                // Nothing changed, leave the texture as it is and move on
+                if (!residentBytes) break;
+
+                // The callback may have added textures, take the reference only after it returned
+                Texture& texture = textures[id];
+                freed += texture.residentBytes > *residentBytes ? texture.residentBytes - *residentBytes : 0;
+                texture.residentBytes = *residentBytes;
+                texture.baseMip = nextMip;
+                if (nextMip < mipCount) ++mipDrops;
+                else ++evictions;
+            }
+            if (freed >= bytes) break;
+        }
+        return freed;
+    }
+
+    TextureResidencyManager::Stats TextureResidencyManager::getStats() const {
+        Stats stats{};
+        for (const Texture& texture : textures) {
+            if (!texture.alive) continue;
+            if (texture.streaming) ++stats.streaming;
+            if (texture.baseMip >= texture.mipCount) ++stats.evicted;
+            else {
+                ++stats.resident;
+                stats.residentBytes += texture.residentBytes;
+            }
+        }
+        stats.evictions = evictions;
+        stats.mipDrops = mipDrops;
+        stats.restreams = restreams;
+        return stats;
+    }
+#pragma endregion
+}
@@ -0,0 +1,171 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+#include "Engine/ufox_memory.hpp"
+
+namespace ufox::graphics::vulkan {
+
+    enum class MemoryCategory : uint8_t {
+        Vertex,
+        Index,
+        Uniform,
+        Storage,
+        Staging,
+        Texture,
+        Attachment,
+        Other,
+        Count,
+    };
+
+    [[nodiscard]] const char* ToString(MemoryCategory category);
+    [[nodiscard]] MemoryCategory CategorizeBuffer(vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
+    [[nodiscard]] MemoryCategory CategorizeImage(vk::ImageUsageFlags usage);
+
+    struct CategoryStats {
+        vk::DeviceSize bytes;
+        uint32_t allocations;
+    };
+
+    struct HeapBudget {
+        uint32_t heapIndex;
+        bool deviceLocal;
+        vk::DeviceSize size;
+        vk::DeviceSize budget;          // what the driver lets this process use, VK_EXT_memory_budget or 80% of size
+        vk::DeviceSize usage;           // driver-reported process usage, or tracked bytes without the extension
+        vk::DeviceSize tracked;         // allocations made through GraphicsDevice
+    };
+
+    // Counts every device memory allocation by category and heap, and reads heap budgets through
+    // VK_EXT_memory_budget when the device exposes it. Counters are atomic, any thread may allocate.
+    class MemoryTracker {
+    public:
+        MemoryTracker(const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget);
+
+        void add(MemoryCategory category, uint32_t heapIndex, vk::DeviceSize size);
+        void remove(MemoryCategory category, uint32_t heapIndex, vk::DeviceSize size);
+
+        [[nodiscard]] CategoryStats getCategory(MemoryCategory category) const;
+        [[nodiscard]] vk::DeviceSize getTrackedBytes() const;
+        [[nodiscard]] bool hasMemoryBudget() const { return useMemoryBudget; }
+
+        // Queries the driver, cheap enough for once every few frames
+        [[nodiscard]] std::vector<HeapBudget> queryBudgets() const;
+        // Sums of the device-local heaps, where textures live. Does not allocate, drawFrame calls it periodically
+        [[nodiscard]] std::pair<vk::DeviceSize, vk::DeviceSize> queryDeviceLocalBudget() const;
+        [[nodiscard]] uint32_t getHeapIndex(uint32_t memoryTypeIndex) const { return memoryProperties.memoryTypes[memoryTypeIndex].heapIndex; }
+
+        void printReport() const;
+
+    private:
+        static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+        const vk::raii::PhysicalDevice& physicalDevice;
+        vk::PhysicalDeviceMemoryProperties memoryProperties;
+        bool useMemoryBudget;
+        std::array<std::atomic<vk::DeviceSize>, CATEGORY_COUNT> categoryBytes{};
+        std::array<std::atomic<uint32_t>, CATEGORY_COUNT> categoryAllocations{};
+        std::array<std::atomic<vk::DeviceSize>, VK_MAX_MEMORY_HEAPS> heapBytes{};
+
+        [[nodiscard]] vk::PhysicalDeviceMemoryBudgetPropertiesEXT queryBudgetProperties() const;
+        [[nodiscard]] HeapBudget makeHeapBudget(uint32_t heapIndex, const vk::PhysicalDeviceMemoryBudgetPropertiesEXT& properties) const;
+    };
+
+    // Accounting handle stored next to the vk::raii::DeviceMemory it describes, releases its bytes when reset or
+    // destroyed
+    class MemoryAllocation {
+    public:
+        MemoryAllocation() = default;
+        MemoryAllocation(MemoryTracker& tracker, MemoryCategory category, uint32_t heapIndex, vk::DeviceSize size);
+        ~MemoryAllocation() { reset(); }
+
+        MemoryAllocation(const MemoryAllocation&) = delete;
+        MemoryAllocation& operator=(const MemoryAllocation&) = delete;
+        MemoryAllocation(MemoryAllocation&& other) noexcept;
+        MemoryAllocation& operator=(MemoryAllocation&& other) noexcept;
+
+        void reset();
+        [[nodiscard]] vk::DeviceSize getSize() const { return size; }
+        [[nodiscard]] MemoryCategory getCategory() const { return category; }
+
+    private:
+        MemoryTracker* tracker{nullptr};
+        MemoryCategory category{MemoryCategory::Other};
+        uint32_t heapIndex{0};
+        vk::DeviceSize size{0};
+    };
+
+    using TextureId = uint32_t;
+
+    // Keeps textures inside the device-local budget. When usage goes over, the least recently used textures
+    // first lose their top mip, then get evicted entirely, and they are streamed back at full detail the next time
+    // a frame uses them. The manager owns no GPU objects, the callback does the actual work.
+    class TextureResidencyManager {
+    public:
+        // Bring the texture to baseMip (0 is full detail, mipCount evicts) and return its resident bytes. A trim that
+        // cannot finish in the call returns nullopt with the texture untouched, it is then evicted or skipped.
+        // Streaming back in may return nullopt and report through finishStream later.
+        using StreamCallback = std::function<std::optional<vk::DeviceSize>(TextureId id, uint32_t baseMip)>;
+
+        struct Stats {
+            uint32_t resident;
+            uint32_t evicted;
+            uint32_t streaming;
+            uint64_t evictions;
+            uint64_t mipDrops;
+            uint64_t restreams;
+            vk::DeviceSize residentBytes;
+        };
+
+        TextureResidencyManager(MemoryTracker& tracker, uint32_t framesInFlight, float budgetFraction = 0.9f);
+
+        TextureId add(std::string name, uint32_t mipCount, vk::DeviceSize residentBytes, StreamCallback stream);
+        void remove(TextureId id);
+
+        // Marks the texture as used by frameNumber, restreaming it first if it was trimmed or evicted.
+        // Returns false while it is not resident, the caller keeps drawing its fallback until it is.
+        bool use(TextureId id, uint64_t frameNumber);
+        // Completes a restream the callback left running, nullopt when it failed and the next use retries
+        void finishStream(TextureId id, std::optional<vk::DeviceSize> residentBytes);
+        // Trims textures while the device-local heaps are over budget, textures used by frames still in flight
+        // are never touched. scratch holds the candidate list, drawFrame passes its frame arena
+        void update(uint64_t frameNumber, std::pmr::memory_resource* scratch = memory::GetHeapResource());
+        // Frees at least bytes if possible, for allocations that would otherwise fail
+        bool makeRoom(vk::DeviceSize bytes, uint64_t frameNumber);
+
+        [[nodiscard]] Stats getStats() const;
+
+    private:
+        struct Texture {
+            std::string name;
+            uint32_t mipCount;
+            uint32_t baseMip;
+            vk::DeviceSize residentBytes;
+            std::optional<uint64_t> lastUsedFrame;
+            StreamCallback stream;
+            bool alive;
+            bool streaming;
+        };
+
+        MemoryTracker& tracker;
+        uint32_t framesInFlight;
+        float budgetFraction;
+        std::vector<Texture> textures;
+        std::vector<TextureId> freeIds;
+        uint64_t evictions{0};
+        uint64_t mipDrops{0};
+        uint64_t restreams{0};
+
+        vk::DeviceSize trim(vk::DeviceSize bytes, uint64_t frameNumber, std::pmr::memory_resource* scratch);
+    };
+}
@@ -4,28 +4,35 @@
 
 #include "ufox_graphic.hpp"
 
+#include <cstdlib>
+#include "Engine/ufox_gui_renderer.hpp"
+
 
 namespace ufox::graphics::vulkan {
-    uint32_t FindMemoryType(const vk::PhysicalDeviceMemoryProperties &memoryProperties, uint32_t typeBits,
-                            vk::MemoryPropertyFlags requirementsMask){
-        auto typeIndex = static_cast<uint32_t>(~0);
+    std::optional<uint32_t> TryFindMemoryType(const vk::PhysicalDeviceMemoryProperties &memoryProperties, uint32_t typeBits,
+                                              vk::MemoryPropertyFlags requirementsMask){
         for ( uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++ )
         {
             if ( typeBits & 1 && ( memoryProperties.memoryTypes[i].propertyFlags & requirementsMask ) == requirementsMask )
             {
-                typeIndex = i;
-                break;
+                return i;
             }
             typeBits >>= 1;
         }
-        assert( typeIndex != static_cast<uint32_t>(~0));
-        return typeIndex;
+        return std::nullopt;
+    }
+
+    uint32_t FindMemoryType(const vk::PhysicalDeviceMemoryProperties &memoryProperties, uint32_t typeBits,
+                            vk::MemoryPropertyFlags requirementsMask){
+        auto typeIndex = TryFindMemoryType(memoryProperties, typeBits, requirementsMask);
+        assert( typeIndex.has_value());
+        return *typeIndex;
     }
 
    void TransitionImageLayout(const vk::raii::CommandBuffer& cmd, const vk::Image& image, const vk::Format& format,
                                vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
                                vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
-                               vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage){
+                               vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage, TraceWriter* trace){
         vk::ImageMemoryBarrier2 barrier{};
         barrier.setImage(image)
             .setOldLayout(oldLayout)
@@ -54,23 +61,11 @@ namespace ufox::graphics::vulkan {
         dependency.setImageMemoryBarrierCount(1)
             .setPImageMemoryBarriers(&barrier);
         cmd.pipelineBarrier2(dependency);
-    }
-
-    std::vector<char> loadShader(const std::string& filename){
-        std::string path = SDL_GetBasePath() + filename;
-        std::ifstream file(path, std::ios::ate | std::ios::binary);
-        if (!file.is_open()) throw std::runtime_error("Failed to open shader: " + path);
 
-        size_t size = file.tellg();
-        if (size > static_cast<size_t>(std::numeric_limits<std::streamsize>::max())) {
-            throw std::runtime_error("File size exceeds maximum streamsize limit");
-        }
-
-        std::vector<char> buffer(size);
-        file.seekg(0);
-        file.read(buffer.data(), static_cast<std::streamsize>(size));
-        file.close();
-        return buffer;
+        if (trace) trace->record(TraceBarrier{ TraceId(image), static_cast<uint64_t>(srcStage), static_cast<uint64_t>(dstStage),
+                                               static_cast<uint64_t>(srcAccess), static_cast<uint64_t>(dstAccess),
+                                               static_cast<uint32_t>(oldLayout), static_cast<uint32_t>(newLayout),
+                                               static_cast<uint32_t>(barrier.subresourceRange.aspectMask) });
     }
 
     bool AreExtensionsSupported( const std::vector<const char *> &required, const std::vector<vk::ExtensionProperties> &available) {
@@ -90,8 +85,33 @@ namespace ufox::graphics::vulkan {
         return true;
     }
 
+    vk::SampleCountFlagBits GetSampleCount(AntiAliasing mode) {
+        switch (mode) {
+            case AntiAliasing::Msaa2: return vk::SampleCountFlagBits::e2;
+            case AntiAliasing::Msaa4: return vk::SampleCountFlagBits::e4;
+            case AntiAliasing::Msaa8: return vk::SampleCountFlagBits::e8;
+            default: return vk::SampleCountFlagBits::e1;
+        }
+    }
+
+    const char* ToString(AntiAliasing mode) {
+        switch (mode) {
+            case AntiAliasing::Msaa2: return "MSAA 2x";
+            case AntiAliasing::Msaa4: return "MSAA 4x";
+            case AntiAliasing::Msaa8: return "MSAA 8x";
+            default: return "Analytic";
+        }
+    }
+
     GraphicsDevice::GraphicsDevice(const windowing::sdl::UfoxWindow& window, const char* engineName, uint32_t engineVersion, const char* appName, uint32_t appVersion) {
+        registerMetrics();
+        if (const char* tracePath = std::getenv("UFOX_TRACE")) {
+            trace = std::make_unique<TraceWriter>(tracePath);
+            fmt::println("Tracing Vulkan calls to {}", tracePath);
+        }
+
 #pragma region Create Context
+        const uint32_t instancePhase = startupTimeline.begin("instance");
         auto vkGetInstanceProcAddr{reinterpret_cast<PFN_vkGetInstanceProcAddr>(SDL_Vulkan_GetVkGetInstanceProcAddr())};
         context.emplace(vkGetInstanceProcAddr);
         auto const vulkanVersion {context->enumerateInstanceVersion()};
@@ -131,15 +151,18 @@ namespace ufox::graphics::vulkan {
             .setPpEnabledExtensionNames(requiredInstanceExtensions.data());
 
         instance.emplace(*context, createInfo);
+        startupTimeline.end(instancePhase);
 #pragma endregion
 
 #pragma region Create Surface
+        const uint32_t devicePhase = startupTimeline.begin("surface and device");
         VkSurfaceKHR raw_surface;
 
         if (!SDL_Vulkan_CreateSurface(window.get(),**instance, nullptr, &raw_surface))
             throw windowing::sdl::SDLException("Failed to create surface");
 
-        surface.emplace(*instance,raw_surface);
+        // Becomes the primary presentation target once the device exists
+        vk::raii::SurfaceKHR primarySurface(*instance, raw_surface);
 #pragma endregion
 
 #pragma region Select Physical Device
@@ -150,7 +173,7 @@ namespace ufox::graphics::vulkan {
             auto families = device.getQueueFamilyProperties();
             for (uint32_t i = 0; i < families.size(); ++i) {
                 if (families[i].queueFlags & vk::QueueFlagBits::eGraphics) indices.graphics = i;
-                if (device.getSurfaceSupportKHR(i, *surface)) indices.present = i;
+                if (device.getSurfaceSupportKHR(i, *primarySurface)) indices.present = i;
                 foundBoth = indices.graphics && indices.present;
                 if (foundBoth) break;
             }
@@ -167,6 +190,10 @@ namespace ufox::graphics::vulkan {
         if (!AreExtensionsSupported(requiredDeviceExtensions, availableDeviceExtensions))
             throw std::runtime_error("Required device extensions are missing");
 
+        // Real per-heap budgets when the driver reports them, heap sizes are only an upper bound
+        const bool hasMemoryBudget = AreExtensionsSupported({ vk::EXTMemoryBudgetExtensionName }, availableDeviceExtensions);
+        if (hasMemoryBudget) requiredDeviceExtensions.push_back(vk::EXTMemoryBudgetExtensionName);
+
         std::set uniqueFamilies = { *queueFamilyIndices.graphics, *queueFamilyIndices.present };
         std::vector<vk::DeviceQueueCreateInfo> queueInfos;
         float priority = 0.0f;
@@ -180,13 +207,27 @@ namespace ufox::graphics::vulkan {
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT dynamicStateFeatures{};
             dynamicStateFeatures.setExtendedDynamicState(true);
 
+            // drawIndirectCount lets the GUI cull pass skip empty indirect slots, fall back to plain indirect draws without it.
+            // Those need multiDrawIndirect for more than one draw per call, without it the pass issues one call per slot.
+            // Culled commands only name their instance in firstInstance when drawIndirectFirstInstance allows it
+            auto supportedFeatures = physicalDevice->getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+            useDrawIndirectCount = supportedFeatures.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount;
+            useMultiDrawIndirect = supportedFeatures.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect;
+            useDrawIndirectFirstInstance = supportedFeatures.get<vk::PhysicalDeviceFeatures2>().features.drawIndirectFirstInstance;
+
+            vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+            vulkan12Features.setPNext(&dynamicStateFeatures)
+                .setDrawIndirectCount(useDrawIndirectCount);
+
             vk::PhysicalDeviceVulkan13Features vulkan13Features{};
-            vulkan13Features.setPNext(&dynamicStateFeatures)
+            vulkan13Features.setPNext(&vulkan12Features)
                 .setSynchronization2(true)
                 .setDynamicRendering(true);
 
             vk::PhysicalDeviceFeatures2 features2{};
-            features2.features.setSamplerAnisotropy(true);
+            features2.features.setSamplerAnisotropy(true)
+                .setMultiDrawIndirect(useMultiDrawIndirect)
+                .setDrawIndirectFirstInstance(useDrawIndirectFirstInstance);
             features2.setPNext(&vulkan13Features);
 
 
@@ -204,6 +245,37 @@ namespace ufox::graphics::vulkan {
 
 #pragma endregion
 
+#pragma region Open Content Pack
+        startupTimeline.end(devicePhase);
+        const uint32_t servicesPhase = startupTimeline.begin("engine services");
+        // Built by UFox-AssetPacker next to the binary
+        if (std::filesystem::path packPath = std::filesystem::path(SDL_GetBasePath()) / "Contents.ufpk"; std::filesystem::exists(packPath)) {
+            contentPack.emplace(packPath);
+            fmt::println("Content pack: {} assets", contentPack->getEntries().size());
+        }
+#pragma endregion
+
+#pragma region Create Memory Tracker
+        memoryTracker.emplace(*physicalDevice, hasMemoryBudget);
+        residency.emplace(*memoryTracker, MAX_FRAMES_IN_FLIGHT);
+#pragma endregion
+
+#pragma region Create Pipeline Cache
+        jobSystem.emplace();
+        frameArenas.emplace(FRAME_ARENA_SIZE, MAX_FRAMES_IN_FLIGHT);
+        // Sources are only present in development trees, shipped builds load the prebuilt SPIR-V next to the binary
+        shaderCompiler.emplace(UFOX_SHADER_SOURCE_DIR, SDL_GetBasePath(), std::filesystem::path(SDL_GetBasePath()) / "ShaderCache");
+        layoutCache.emplace(*device, *shaderCompiler);
+        pipelineCache.emplace(*device, *jobSystem, *layoutCache, *shaderCompiler);
+        pipelineCache->setTrace(trace.get());
+#pragma endregion
+
+        // Decoding does not touch the device, it overlaps with everything below and lands on first use
+        pendingTexture = jobSystem->submit([this] {
+            auto phase = startupTimeline.scope("texture decode");
+            return loadTexturePixels();
+        });
+
 #pragma region Create Command Pool
         vk::CommandPoolCreateInfo poolInfo{};
         poolInfo.setQueueFamilyIndex(*queueFamilyIndices.graphics)
@@ -220,33 +292,68 @@ namespace ufox::graphics::vulkan {
 #pragma endregion
 
 #pragma region Create Synchronization Objects
-        vk::SemaphoreCreateInfo semaphoreInfo{};
+        // Semaphores belong to the presentation targets, one fence per frame covers all of them
         vk::FenceCreateInfo fenceInfo{ vk::FenceCreateFlagBits::eSignaled };
 
-        imageAvailableSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
-        renderFinishedSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
         inFlightFences.reserve(MAX_FRAMES_IN_FLIGHT);
-
         for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-            imageAvailableSemaphores.emplace_back(*device, semaphoreInfo);
-            renderFinishedSemaphores.emplace_back(*device, semaphoreInfo);
             inFlightFences.emplace_back(*device, fenceInfo);
         }
 #pragma endregion
 
-        createSwapchain(window);
-        createDepthImage();
+        vk::PhysicalDeviceLimits limits = physicalDevice->getProperties().limits;
+        supportedSampleCounts = limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+        createTimestampQueries();
+        startupTimeline.end(servicesPhase);
+
+        const uint32_t swapchainPhase = startupTimeline.begin("swapchain and targets");
+        auto [windowWidth, windowHeight] = window.getSize();
+        targets.push_back(std::make_unique<PresentationTarget>(std::move(primarySurface)));
+        initPresentationTarget(*targets.front(), { windowWidth, windowHeight });
+        probeMultisampleMemory(targets.front()->format);
         createDescriptorSetLayout();
-        createGraphicsPipeline();
-        createTextureImage();
-        createTextureImageView();
+        startupTimeline.end(swapchainPhase);
+
+        // The pipeline key needs the swapchain and depth formats, from here it compiles while buffers upload
+        guiPipelineKey = makePipelineKey();
+        ++guiPipelineKeyVersion;
+        std::future<vk::Pipeline> pipelineBuild = jobSystem->submit([this] {
+            auto phase = startupTimeline.scope("pipeline compile");
+            return pipelineCache->getOrCreate(guiPipelineKey);
+        });
+
+        // Every copy and layout transition below shares one submission and one queue wait
+        const uint32_t uploadPhase = startupTimeline.begin("buffers and uploads");
+        beginUploads();
+        createTextureImage(PlaceholderTexture(), placeholderImage);
+        createTextureImageView(placeholderImage);
         createTextureSampler();
         createVertexBuffer();
         createIndexBuffer();
-        createUniformBuffers();
         createRoundedCornerBuffer();
+        createClipBuffers();
+        flushUploads();
         createDescriptorPool();
-        createDescriptorSets();
+        createTargetResources(*targets.front());
+        startupTimeline.end(uploadPhase);
+
+        const uint32_t pipelinePhase = startupTimeline.begin("wait for pipeline");
+        graphicsPipeline = pipelineBuild.get();
+        startupTimeline.end(pipelinePhase);
+        startupTimeline.mark("device ready");
+    }
+
+    GraphicsDevice::~GraphicsDevice() {
+        // Background jobs reference the caches owned by this device
+        if (jobSystem) jobSystem->waitIdle();
+    }
+
+    void GraphicsDevice::stopTrace() {
+        if (!trace) return;
+        // Pipeline builds in flight may still be recording
+        pipelineCache->setTrace(nullptr);
+        jobSystem->waitIdle();
+        trace.reset();
     }
 
     void GraphicsDevice::waitForIdle() const {
@@ -254,37 +361,39 @@ namespace ufox::graphics::vulkan {
         device->waitIdle();
     }
 
-    void GraphicsDevice::createSwapchain(const windowing::sdl::UfoxWindow& window) {
-        vk::SurfaceCapabilitiesKHR capabilities = physicalDevice->getSurfaceCapabilitiesKHR(*surface);
+    void GraphicsDevice::createSwapchain(PresentationTarget& target, const vk::Extent2D& windowExtent) {
+        target.requestedExtent = windowExtent;
+        vk::SurfaceCapabilitiesKHR capabilities = physicalDevice->getSurfaceCapabilitiesKHR(*target.surface);
 
 #pragma region Get Supported Format
-        auto formats = physicalDevice->getSurfaceFormatsKHR(*surface);
+        auto formats = physicalDevice->getSurfaceFormatsKHR(*target.surface);
         vk::SurfaceFormatKHR surfaceFormat;
         for (const auto& format : formats) {
             if (format.format == vk::Format::eB8G8R8A8Srgb && format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear)
                 surfaceFormat = format;
         }
-        swapchainFormat = surfaceFormat.format;
+        target.format = surfaceFormat.format;
 #pragma endregion
 
 #pragma region Get Supported Present Mode
-        auto presentModes = physicalDevice->getSurfacePresentModesKHR(*surface);
+        auto presentModes = physicalDevice->getSurfacePresentModesKHR(*target.surface);
         auto mailboxIt = std::ranges::find_if(presentModes,
     [](const vk::PresentModeKHR& mode) { return mode == vk::PresentModeKHR::eMailbox; });
-        presentMode = mailboxIt != presentModes.end() ? *mailboxIt : useVsync ? vk::PresentModeKHR::eFifo : vk::PresentModeKHR::eImmediate;
+        target.presentMode = mailboxIt != presentModes.end() ? *mailboxIt : useVsync ? vk::PresentModeKHR::eFifo : vk::PresentModeKHR::eImmediate;
 #pragma endregion
 
 #pragma region Get Extent
         if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
-            swapchainExtent = capabilities.currentExtent;
+            target.extent = capabilities.currentExtent;
         }
         else {
-            auto [windowExtentW, windowExtentH] = window.getSize();
-            vk::Extent2D extent { windowExtentW, windowExtentH };
+            vk::Extent2D extent = windowExtent;
             extent.width = std::clamp(extent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
             extent.height = std::clamp(extent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
-            swapchainExtent = extent;
+            target.extent = extent;
         }
+        // Minimized, nothing to present until the window reports a new size
+        if (target.extent.width == 0 || target.extent.height == 0) return;
 #pragma endregion
 
 #pragma region Get Count
@@ -302,16 +411,16 @@ namespace ufox::graphics::vulkan {
 
 #pragma region Create Swapchain
         vk::SwapchainCreateInfoKHR createInfo{};
-        createInfo.setSurface(*surface)
+        createInfo.setSurface(*target.surface)
             .setMinImageCount(imageCount)
-            .setImageFormat(swapchainFormat)
+            .setImageFormat(target.format)
             .setImageColorSpace(surfaceFormat.colorSpace) // Use colorSpace from surfaceFormat
-            .setImageExtent(swapchainExtent)
+            .setImageExtent(target.extent)
             .setImageArrayLayers(1)
             .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
             .setPreTransform(preTransform)
             .setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque)
-            .setPresentMode(presentMode)
+            .setPresentMode(target.presentMode)
             .setClipped(true);
 
         std::array queueIndices = { *queueFamilyIndices.graphics, *queueFamilyIndices.present };
@@ -324,219 +433,361 @@ namespace ufox::graphics::vulkan {
             createInfo.setImageSharingMode(vk::SharingMode::eExclusive);
         }
 
-        swapchain.emplace(*device, createInfo);
+        target.swapchain.emplace(*device, createInfo);
 #pragma endregion
 
 #pragma region Create Image View
-        swapchainImages = swapchain->getImages();
-        swapchainImageViews.reserve(swapchainImages.size());
+        target.images = target.swapchain->getImages();
+        target.imageViews.reserve(target.images.size());
 
         vk::ImageViewCreateInfo viewInfo{};
         viewInfo.setViewType(vk::ImageViewType::e2D)
-            .setFormat(swapchainFormat)
+            .setFormat(target.format)
             .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
 
-        for (const auto& image : swapchainImages) {
+        for (const auto& image : target.images) {
             viewInfo.setImage(image);
-            swapchainImageViews.emplace_back(*device, viewInfo);
+            target.imageViews.emplace_back(*device, viewInfo);
+            if (trace) {
+                trace->record(TraceSwapchainImage{ TraceId(image), static_cast<uint32_t>(target.format), target.extent.width, target.extent.height });
+                trace->record(TraceImageView{ TraceId(*target.imageViews.back()), TraceId(image) });
+            }
         }
 #pragma endregion
 
 
     }
 
-    void GraphicsDevice::createDepthImage() {
+    void GraphicsDevice::createDepthImage(PresentationTarget& target) {
+        if (!useDepth) {
+            target.depthImage.format = vk::Format::eUndefined;
+            target.depthImage.extent = vk::Extent2D{ 0, 0 };
+            return;
+        }
+
         // Find a supported depth format
-        std::vector<vk::Format> candidates = {
+        constexpr std::array candidates = {
             vk::Format::eD32Sfloat,
             vk::Format::eD32SfloatS8Uint,
             vk::Format::eD24UnormS8Uint
         };
-        depthImage.format = findSupportedFormat(
+        target.depthImage.format = findSupportedFormat(
             candidates,
             vk::ImageTiling::eOptimal,
             vk::FormatFeatureFlagBits::eDepthStencilAttachment
         );
 
-        // Set extent to match swapchain
-        depthImage.extent = swapchainExtent;
+        // Set extent to match swapchain, samples must match the color attachment
+        target.depthImage.extent = target.extent;
+        target.depthImage.samples = GetSampleCount(antiAliasing);
 
-        // Create depth image
+        // Depth is cleared on load and never stored, so it can live in tile memory on GPUs that
+        // expose lazily allocated heaps; createImage falls back to plain device-local otherwise.
         createImage(
             vk::ImageTiling::eOptimal,
-            vk::ImageUsageFlagBits::eDepthStencilAttachment,
-            vk::MemoryPropertyFlagBits::eDeviceLocal,
-            depthImage
+            vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransientAttachment,
+            vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated,
+            target.depthImage
         );
 
         // Create image view
         vk::ImageViewCreateInfo viewInfo{};
-        viewInfo.setImage(*depthImage.data)
+        viewInfo.setImage(*target.depthImage.data)
                 .setViewType(vk::ImageViewType::e2D)
-                .setFormat(depthImage.format)
+                .setFormat(target.depthImage.format)
                 .setSubresourceRange({
-                    depthImage.format == vk::Format::eD32Sfloat ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil,
+                    target.depthImage.format == vk::Format::eD32Sfloat ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil,
                     0, 1, 0, 1
                 });
-        depthImage.view.emplace(*device, viewInfo);
+        target.depthImage.view.emplace(*device, viewInfo);
 
         // Transition to depth-stencil attachment layout
         transitionImageLayout(
-            depthImage,
+            target.depthImage,
             vk::ImageLayout::eUndefined,
             vk::ImageLayout::eDepthStencilAttachmentOptimal
         );
     }
 
+    void GraphicsDevice::setDepthEnabled(bool enabled) {
+        if (useDepth == enabled) return;
 
-    void GraphicsDevice::createDescriptorSetLayout() {
-        vk::DescriptorSetLayoutBinding vertexLayoutBinding{};
-        vertexLayoutBinding.setBinding(0)
-            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-            .setDescriptorCount(1)
-            .setStageFlags(vk::ShaderStageFlagBits::eVertex)
-            .setPImmutableSamplers(nullptr);
+        waitForIdle();
+        useDepth = enabled;
+        for (auto& target : targets) {
+            target->depthImage.clear();
+            if (target->swapchain) createDepthImage(*target);
+        }
+
+        // The depth format is part of the variant key, switching back reuses the cached pipeline
+        createGraphicsPipeline();
+    }
+
+    void GraphicsDevice::createColorImage(PresentationTarget& target) {
+        vk::SampleCountFlagBits samples = GetSampleCount(antiAliasing);
+        if (samples == vk::SampleCountFlagBits::e1) {
+            target.colorImage.format = vk::Format::eUndefined;
+            target.colorImage.extent = vk::Extent2D{ 0, 0 };
+            target.colorImage.allocationSize = 0;
+            return;
+        }
+
+        target.colorImage.format = target.format;
+        target.colorImage.extent = target.extent;
+        target.colorImage.samples = samples;
+
+        // Samples are resolved into the swapchain image before the pass ends and never stored, so on tilers
+        // the multisampled image never leaves tile memory
+        createImage(
+            vk::ImageTiling::eOptimal,
+            vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment,
+            vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated,
+            target.colorImage
+        );
+
+        vk::ImageViewCreateInfo viewInfo{};
+        viewInfo.setImage(*target.colorImage.data)
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(target.colorImage.format)
+                .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
+        target.colorImage.view.emplace(*device, viewInfo);
+
+        transitionImageLayout(target.colorImage, vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal);
+    }
+
+    void GraphicsDevice::probeMultisampleMemory(vk::Format format) {
+        multisampleLazilyAllocated = false;
+        auto mode = std::ranges::find_if(ANTI_ALIASING_MODES, [this](AntiAliasing m) {
+            return GetSampleCount(m) != vk::SampleCountFlagBits::e1 && isAntiAliasingSupported(m);
+        });
+        if (mode == ANTI_ALIASING_MODES.end() || format == vk::Format::eUndefined) return;
+
+        // An unbound probe with the color attachment's usage tells which memory type an MSAA mode would land
+        // in without switching to it, memory type bits do not depend on the extent
+        vk::ImageCreateInfo imageInfo{};
+        imageInfo.setImageType(vk::ImageType::e2D)
+                 .setFormat(format)
+                 .setExtent({1, 1, 1})
+                 .setMipLevels(1)
+                 .setArrayLayers(1)
+                 .setSamples(GetSampleCount(*mode))
+                 .setTiling(vk::ImageTiling::eOptimal)
+                 .setInitialLayout(vk::ImageLayout::eUndefined)
+                 .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment)
+                 .setSharingMode(vk::SharingMode::eExclusive);
+        vk::raii::Image probe{ *device, imageInfo };
+
+        vk::MemoryRequirements memoryRequirements = probe.getMemoryRequirements();
+        vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice->getMemoryProperties();
+        multisampleLazilyAllocated = TryFindMemoryType(memoryProperties, memoryRequirements.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated).has_value();
+    }
+
+    bool GraphicsDevice::isAntiAliasingSupported(AntiAliasing mode) const {
+        return static_cast<bool>(supportedSampleCounts & GetSampleCount(mode));
+    }
+
+    bool GraphicsDevice::setAntiAliasing(AntiAliasing mode) {
+        if (!isAntiAliasingSupported(mode)) {
+            fmt::println("{} is not supported by this device", ToString(mode));
+            return false;
+        }
+        if (antiAliasing == mode) return true;
+
+        waitForIdle();
+        antiAliasing = mode;
+        for (auto& target : targets) {
+            target->colorImage.clear();
+            target->depthImage.clear();
+            if (!target->swapchain) continue;
+            createColorImage(*target);
+            createDepthImage(*target);
+        }
+
+        // Sample count is part of the variant key, every mode keeps its own cached pipeline
+        createGraphicsPipeline();
+        return true;
+    }
+
+    std::vector<AntiAliasingCost> GraphicsDevice::getAntiAliasingCosts() const {
+        constexpr vk::DeviceSize colorBytes = 4;
+        const vk::DeviceSize depthBytes = useDepth ? 4 : 0;
+        // Reported for the primary window, other targets scale with their own pixel count
+        const PresentationTarget& primary = *targets.front();
+        const vk::DeviceSize pixels = static_cast<vk::DeviceSize>(primary.extent.width) * primary.extent.height;
+
+        std::vector<AntiAliasingCost> costs;
+        costs.reserve(ANTI_ALIASING_MODES.size());
+        for (size_t i = 0; i < ANTI_ALIASING_MODES.size(); ++i) {
+            AntiAliasing mode = ANTI_ALIASING_MODES[i];
+            auto samples = static_cast<vk::DeviceSize>(GetSampleCount(mode));
+
+            AntiAliasingCost cost{};
+            cost.mode = mode;
+            cost.supported = isAntiAliasingSupported(mode);
+            // The active mode reports what was really allocated, the others an estimate. Analytic has no
+            // multisampled attachments, so nothing of it can be lazily allocated
+            if (mode == antiAliasing) {
+                cost.attachmentBytes = primary.colorImage.allocationSize + (samples > 1 ? primary.depthImage.allocationSize : 0);
+                cost.lazilyAllocated = samples > 1 && primary.colorImage.lazilyAllocated;
+            }
+            else {
+                cost.attachmentBytes = samples > 1 ? pixels * samples * (colorBytes + depthBytes) : 0;
+                cost.lazilyAllocated = samples > 1 && cost.supported && multisampleLazilyAllocated;
+            }
+            cost.gpuFrameMs = gpuFrameMs[i];
+            costs.push_back(cost);
+        }
+        return costs;
+    }
+
+    void GraphicsDevice::createTimestampQueries() {
+        vk::PhysicalDeviceProperties properties = physicalDevice->getProperties();
+        auto queueFamilies = physicalDevice->getQueueFamilyProperties();
+        if (!properties.limits.timestampComputeAndGraphics || queueFamilies[*queueFamilyIndices.graphics].timestampValidBits == 0) {
+            fmt::println("GPU timestamps unavailable, anti-aliasing costs report memory only");
+            return;
+        }
+
+        timestampPeriod = properties.limits.timestampPeriod;
+
+        vk::QueryPoolCreateInfo poolInfo{};
+        poolInfo.setQueryType(vk::QueryType::eTimestamp)
+                .setQueryCount(MAX_FRAMES_IN_FLIGHT * 2);
+        timestampQueryPool.emplace(*device, poolInfo);
+    }
+
+    void GraphicsDevice::registerMetrics() {
+        frameMetrics.frameMs = &metrics.histogram("frame.time_ms", "Time between the starts of consecutive rendered frames");
+        frameMetrics.cpuMs = &metrics.histogram("frame.cpu_ms", "Time spent inside drawFrame, fence wait included");
+        frameMetrics.gpuMs = &metrics.histogram("frame.gpu_ms", "GPU time of the frame's command buffer from timestamp queries");
+        frameMetrics.fenceWaitMs = &metrics.histogram("frame.fence_wait_ms", "Wait for the frame slot's fence, the GPU running behind");
+        frameMetrics.acquireMs = &metrics.histogram("frame.acquire_ms", "acquireNextImage over all windows");
+        frameMetrics.presentMs = &metrics.histogram("frame.present_ms", "presentKHR over all windows");
+        frameMetrics.frames = &metrics.counter("frame.count", "Frames submitted");
+        frameMetrics.stalls = &metrics.counter("frame.stalls", "Frames that started more than 100 ms after the previous one");
+        frameMetrics.skipped = &metrics.counter("frame.skipped", "Frames that acquired no swapchain image and submitted nothing");
+        frameMetrics.swapchainRecreations = &metrics.counter("swapchain.recreations", "Swapchains rebuilt after a resize or an out of date present");
+        frameMetrics.draws = &metrics.counter("render.draws", "Draw calls recorded");
+        frameMetrics.triangles = &metrics.counter("render.triangles", "Triangles submitted");
+        frameMetrics.uploadBytes = &metrics.counter("upload.bytes", "Bytes copied from staging buffers to device memory");
+        frameMetrics.heapAllocations = &metrics.counter("memory.heap_allocations", memory::COUNTS_GLOBAL_ALLOCATIONS
+            ? "Global operator new calls on any thread during drawFrame"
+            : "Engine allocator requests that reached the heap during drawFrame, other heap use is not seen");
+        frameMetrics.descriptorUpdates = &metrics.counter("descriptor.updates", "Descriptor writes");
+        frameMetrics.gpuMemoryBytes = &metrics.gauge("memory.gpu_bytes", "Device memory held by Buffers and Images");
+    }
+
+    void GraphicsDevice::updateDescriptorSets(vk::ArrayProxy<const vk::WriteDescriptorSet> const &writes) const {
+        device->updateDescriptorSets(writes, nullptr);
+        frameMetrics.descriptorUpdates->add(writes.size());
+        if (trace) traceDescriptorWrites(writes);
+    }
+
+    void GraphicsDevice::traceDescriptorWrites(vk::ArrayProxy<const vk::WriteDescriptorSet> const &writes) const {
+        for (const vk::WriteDescriptorSet& write : writes) {
+            for (uint32_t i = 0; i < write.descriptorCount; ++i) {
+                TraceWriteDescriptor record{ TraceId(write.dstSet), write.dstBinding, write.dstArrayElement + i,
+                                             static_cast<uint32_t>(write.descriptorType) };
+                if (write.pBufferInfo) {
+                    const vk::DescriptorBufferInfo& info = write.pBufferInfo[i];
+                    record.buffer = TraceId(info.buffer);
+                    record.offset = info.offset;
+                    record.range = info.range;
+                }
+                else if (write.pImageInfo) {
+                    const vk::DescriptorImageInfo& info = write.pImageInfo[i];
+                    record.view = TraceId(info.imageView);
+                    record.imageLayout = static_cast<uint32_t>(info.imageLayout);
+                }
+                trace->record(record);
+            }
+        }
+    }
+
+    void GraphicsDevice::traceBufferData(const Buffer &buffer, vk::DeviceSize offset, const void *data, vk::DeviceSize size) const {
+        if (!trace) return;
+        trace->record(TraceBufferData{ TraceId(**buffer.data), offset, size }, { static_cast<const std::byte*>(data), static_cast<size_t>(size) });
+    }
+
+    void GraphicsDevice::readTimestamps() {
+        if (!timestampQueryPool || !timestampsWritten[currentFrame]) return;
+        // A skipped frame leaves the slot unwritten, its next visit must not read these results again
+        timestampsWritten[currentFrame] = false;
 
-        vk::DescriptorSetLayoutBinding samplerLayoutBinding{};
-        samplerLayoutBinding.setBinding(1)
-                            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-                            .setDescriptorCount(1)
-                            .setStageFlags(vk::ShaderStageFlagBits::eFragment)
-                            .setPImmutableSamplers(nullptr);
+        // The frame's fence has signaled, so the results are available without waiting
+        auto [result, ticks] = timestampQueryPool->getResult<std::array<uint64_t, 2>>(currentFrame * 2, 2, sizeof(uint64_t),
+                                                                                     vk::QueryResultFlagBits::e64);
+        if (result != vk::Result::eSuccess || ticks[1] < ticks[0]) return;
+
+        float ms = static_cast<float>(ticks[1] - ticks[0]) * timestampPeriod * 1e-6f;
+        frameMetrics.gpuMs->record(ms);
+        float& average = gpuFrameMs[static_cast<size_t>(timestampModes[currentFrame])];
+        average = average < 0.0f ? ms : average * 0.9f + ms * 0.1f;
+    }
 
-        vk::DescriptorSetLayoutBinding roundedCornerLayoutBinding{};
-        roundedCornerLayoutBinding.setBinding(2)
-                                  .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-                                  .setDescriptorCount(1)
-                                  .setStageFlags(vk::ShaderStageFlagBits::eFragment)
-                                  .setPImmutableSamplers(nullptr);
 
-        std::array bindings = { vertexLayoutBinding, samplerLayoutBinding, roundedCornerLayoutBinding };
+    void GraphicsDevice::createDescriptorSetLayout() {
+        // Bindings come straight from the SPIR-V, so editing a shader no longer needs a matching C++ change here
+        const std::string vertexShader = "shaders/shader.vert.spv";
+        uint32_t maxPushConstantsSize = physicalDevice->getProperties().limits.maxPushConstantsSize;
+
+        usePushConstantParams = false;
+        guiFragmentShader = "shaders/shader.frag.spv";
+        if (sizeof(RoundedRectParams) <= maxPushConstantsSize) {
+            const ShaderInterface& pushInterface = layoutCache->get({ vertexShader, "shaders/shader_push.frag.spv" });
+            bool fits = std::ranges::all_of(pushInterface.pushConstantRanges, [maxPushConstantsSize](const auto& range) {
+                return range.offset + range.size <= maxPushConstantsSize;
+            });
+            if (fits && !pushInterface.pushConstantRanges.empty()) {
+                usePushConstantParams = true;
+                guiFragmentShader = "shaders/shader_push.frag.spv";
+            }
+        }
 
-        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
-        layoutInfo.setBindingCount( bindings.size())
-                  .setPBindings(bindings.data());
+        shaderInterface = &layoutCache->get({ vertexShader, guiFragmentShader });
+        if (shaderInterface->setLayouts.empty()) throw std::runtime_error("GUI shaders declare no descriptor sets");
 
-        descriptorSetLayout.emplace(*device, layoutInfo);
+        descriptorSetLayout = shaderInterface->setLayouts.front();
+        pipelineLayout = shaderInterface->pipelineLayout;
     }
 
     void GraphicsDevice::createGraphicsPipeline() {
-        auto vertCode = loadShader("shaders/shader.vert.spv");
-        auto fragCode = loadShader("shaders/shader.frag.spv");
-        vk::raii::ShaderModule vertModule(*device, vk::ShaderModuleCreateInfo{ {}, vertCode.size(), reinterpret_cast<const uint32_t*>(vertCode.data()) });
-        vk::raii::ShaderModule fragModule(*device, vk::ShaderModuleCreateInfo{ {}, fragCode.size(), reinterpret_cast<const uint32_t*>(fragCode.data()) });
-
-        std::array stages = {
-            vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eVertex, *vertModule, "main" },
-            vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eFragment, *fragModule, "main" }
-        };
+        guiPipelineKey = makePipelineKey();
+        ++guiPipelineKeyVersion;
+        graphicsPipeline = pipelineCache->getOrCreate(guiPipelineKey);
+    }
+
+    PipelineKey GraphicsDevice::makePipelineKey() const {
+        PipelineKey key{};
+        key.fragmentShader = guiFragmentShader;
+        key.vertexLayout = guiVertexLayout;
+        key.specialization = renderer::gui::GetLayoutSpecialization(guiVertexLayout);
+        key.blendMode = BlendMode::AlphaBlend;
+        key.colorFormat = targets.front()->format;
+        key.depthFormat = targets.front()->depthImage.format;
+        key.samples = GetSampleCount(antiAliasing);
+        key.layout = pipelineLayout;
+        return key;
+    }
 
-        vk::PipelineVertexInputStateCreateInfo vertexInput{};
-
-        vk::VertexInputBindingDescription bindingDescription{};
-        bindingDescription.setBinding(0)
-                          .setStride(sizeof(Vertex))
-                          .setInputRate(vk::VertexInputRate::eVertex);
-
-        std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions{};
-        attributeDescriptions[0].setBinding(0)
-                                .setLocation(0)
-                                .setFormat(vk::Format::eR32G32B32Sfloat)
-                                .setOffset(0);
-
-        attributeDescriptions[1].setBinding(0)
-                                .setLocation(1)
-                                .setFormat(vk::Format::eR32G32B32A32Sfloat)
-                                .setOffset(offsetof(Vertex, color));
-
-        attributeDescriptions[2].setBinding(0)
-                                .setLocation(2)
-                                .setFormat(vk::Format::eR32G32Sfloat)
-                                .setOffset(offsetof(Vertex, texCoord));
-
-        vertexInput.setVertexBindingDescriptionCount(1)
-                   .setVertexAttributeDescriptionCount( attributeDescriptions.size())
-                   .setPVertexBindingDescriptions(&bindingDescription)
-                   .setPVertexAttributeDescriptions(attributeDescriptions.data());
-
-
-        vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
-        inputAssembly.setTopology(vk::PrimitiveTopology::eTriangleList)
-                     .setPrimitiveRestartEnable(false);
-
-        vk::PipelineViewportStateCreateInfo viewportState{};
-        viewportState.setViewportCount(1).setScissorCount(1);
-
-        vk::PipelineRasterizationStateCreateInfo rasterizer{};
-        rasterizer.setPolygonMode(vk::PolygonMode::eFill)
-                  .setDepthBiasEnable(false)
-                  .setDepthClampEnable(false)
-                  .setRasterizerDiscardEnable(false)
-                  .setLineWidth(1.0f);
-
-        vk::PipelineMultisampleStateCreateInfo multisample{};
-        multisample.setRasterizationSamples(vk::SampleCountFlagBits::e1);
-
-        vk::PipelineColorBlendAttachmentState blendAttachment{};
-        blendAttachment.setBlendEnable(true)
-                       .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha) // Use alpha for color
-                       .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha) // 1 - alpha for background
-                       .setColorBlendOp(vk::BlendOp::eAdd) // Add blended colors
-                       .setSrcAlphaBlendFactor(vk::BlendFactor::eOne) // Preserve alpha
-                       .setDstAlphaBlendFactor(vk::BlendFactor::eZero)
-                       .setAlphaBlendOp(vk::BlendOp::eAdd)
-                       .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-                                          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
-
-        vk::PipelineColorBlendStateCreateInfo blendState{};
-        blendState.setAttachmentCount(1).setPAttachments(&blendAttachment);
-
-        std::array dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor, vk::DynamicState::eCullMode,
-                                     vk::DynamicState::eFrontFace, vk::DynamicState::ePrimitiveTopology };
-        vk::PipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.setDynamicStateCount(dynamicStates.size()).setPDynamicStates(dynamicStates.data());
-
-        vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.setSetLayoutCount(1)
-        .setPSetLayouts(&**descriptorSetLayout);
-
-        pipelineLayout.emplace(*device, pipelineLayoutInfo);
-
-        vk::PipelineRenderingCreateInfo renderingInfo{};
-        renderingInfo.setColorAttachmentCount(1)
-                     .setPColorAttachmentFormats(&swapchainFormat)
-                     .setDepthAttachmentFormat(depthImage.format);
-
-        vk::PipelineDepthStencilStateCreateInfo depthStencil{};
-        depthStencil.setDepthTestEnable(true)
-               .setDepthWriteEnable(true)
-               .setDepthCompareOp(vk::CompareOp::eLess)
-               .setDepthBoundsTestEnable(false)
-               .setStencilTestEnable(false);
-
-        vk::GraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.setStageCount(stages.size())
-                    .setPStages(stages.data())
-                    .setPVertexInputState(&vertexInput)
-                    .setPInputAssemblyState(&inputAssembly)
-                    .setPViewportState(&viewportState)
-                    .setPRasterizationState(&rasterizer)
-                    .setPMultisampleState(&multisample)
-                    .setPColorBlendState(&blendState)
-                    .setPDynamicState(&dynamicState)
-                    .setPDepthStencilState(&depthStencil)
-                    .setLayout(**pipelineLayout)
-                    .setRenderPass(nullptr)
-                    .setSubpass(0)
-                    .setPNext(&renderingInfo);
-
-
-        graphicsPipeline.emplace(*device, nullptr, pipelineInfo);
-    }
-
-    void GraphicsDevice::createTextureImage() {
-        const std::string filename = "Contents/statue-1275469_1280.jpg";
-        std::string path = SDL_GetBasePath() + filename;
+    GraphicsDevice::TexturePixels GraphicsDevice::PlaceholderTexture() {
+        static constexpr std::array PIXEL{ std::byte{128}, std::byte{128}, std::byte{128}, std::byte{255} };
+        return { vk::Format::eR8G8B8A8Srgb, vk::Extent2D{ 1, 1 }, {}, PIXEL };
+    }
+
+    GraphicsDevice::TexturePixels GraphicsDevice::loadTexturePixels() const {
+        const std::string_view assetName = "statue-1275469_1280.jpg";
+        if (const assets::PackEntry* entry = contentPack ? contentPack->find(assetName) : nullptr) {
+            const assets::TextureView texture = contentPack->getTexture(*entry);
+            return {
+                texture.header.format == assets::TextureFormat::Rgba8Srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm,
+                vk::Extent2D{ texture.header.width, texture.header.height }, {}, texture.pixels
+            };
+        }
+
+        // Loose files still work for assets dropped in next to the binary during development
+        std::string path = std::string(SDL_GetBasePath()) + "Contents/" + std::string(assetName);
 
         std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> rawSurface
         {IMG_Load(path.c_str()), SDL_DestroySurface};
@@ -548,34 +799,74 @@ namespace ufox::graphics::vulkan {
         if (!convSurface)
             throw std::runtime_error(std::string("Failed to convert texture: ") + SDL_GetError());
 
-        textureImage.format = vk::Format::eR8G8B8A8Srgb;
-        textureImage.extent = vk::Extent2D{static_cast<uint32_t>(convSurface->w), static_cast<uint32_t>(convSurface->h)};
-        vk::DeviceSize imageSize = textureImage.extent.width * textureImage.extent.height * 4;
+        TexturePixels texture{ vk::Format::eR8G8B8A8Srgb, vk::Extent2D{static_cast<uint32_t>(convSurface->w), static_cast<uint32_t>(convSurface->h)}, {}, {} };
+        const size_t rowSize = size_t{texture.extent.width} * 4;
+        texture.storage.resize(rowSize * texture.extent.height);
+        for (uint32_t y = 0; y < texture.extent.height; ++y)
+            memcpy(texture.storage.data() + y * rowSize, static_cast<const std::byte*>(convSurface->pixels) + static_cast<size_t>(y) * convSurface->pitch, rowSize);
+        texture.pixels = texture.storage;
+        return texture;
+    }
+
+    void GraphicsDevice::createTextureImage(const TexturePixels& texture, Image& image) {
+        image.format = texture.format;
+        image.extent = texture.extent;
+        std::span<const std::byte> pixels = texture.pixels;
+        vk::DeviceSize imageSize = pixels.size();
 
         Buffer stagingBuffer{};
         createBuffer(imageSize, vk::BufferUsageFlagBits::eTransferSrc,
             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer);
 
-        auto pData = static_cast<uint8_t *>( stagingBuffer.memory->mapMemory( 0, imageSize ) );
-        memcpy( pData, convSurface->pixels,  imageSize);
+        // Pack pixels go straight from the file mapping into staging memory
+        auto pData = static_cast<std::byte *>( stagingBuffer.memory->mapMemory( 0, imageSize ) );
+        memcpy( pData, pixels.data(), imageSize);
         stagingBuffer.memory->unmapMemory();
+        traceBufferData(stagingBuffer, 0, pixels.data(), imageSize);
 
         createImage(vk::ImageTiling::eOptimal,vk::ImageUsageFlagBits::eTransferDst|vk::ImageUsageFlagBits::eSampled,
-        vk::MemoryPropertyFlagBits::eDeviceLocal, textureImage);
+        vk::MemoryPropertyFlagBits::eDeviceLocal, image);
+
+        transitionImageLayout(image,vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+        copyBufferToImage(stagingBuffer, image);
+        transitionImageLayout(image,vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+        retireStaging(std::move(stagingBuffer));
+    }
+
+    void GraphicsDevice::finishTextureLoad() {
+        // The first load belongs to startup, later ones are restreams after an eviction
+        std::optional<profiling::Timeline::Scope> phase{};
+        if (!textureId) phase.emplace(startupTimeline, startupTimeline.begin("texture upload"));
 
-        transitionImageLayout(textureImage,vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-        copyBufferToImage(stagingBuffer, textureImage);
-        transitionImageLayout(textureImage,vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+        TexturePixels texture{};
+        try {
+            texture = pendingTexture.get();
+        }
+        catch (const std::exception& e) {
+            // Keep drawing with the placeholder rather than taking the renderer down
+            fmt::println("Failed to load texture: {}", e.what());
+            if (textureId) residency->finishStream(*textureId, std::nullopt);
+            return;
+        }
+
+        // The placeholder is still bound by frames in flight
+        waitForIdle();
+        createTextureImage(texture, textureImage);
+        createTextureImageView(textureImage);
+        updateTextureDescriptors();
+        if (textureId) residency->finishStream(*textureId, textureImage.allocationSize);
+        else registerTextureResidency();
     }
 
-    void GraphicsDevice::createTextureImageView() {
+    void GraphicsDevice::createTextureImageView(Image& image) {
         vk::ImageViewCreateInfo viewInfo{};
-        viewInfo.setImage(*textureImage.data)
+        viewInfo.setImage(*image.data)
                 .setViewType(vk::ImageViewType::e2D)
-                .setFormat(textureImage.format)
+                .setFormat(image.format)
                 .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
 
-        textureImage.view.emplace(*device, viewInfo);
+        image.view.emplace(*device, viewInfo);
+        if (trace) trace->record(TraceImageView{ TraceId(**image.view), TraceId(**image.data) });
     }
 
     void GraphicsDevice::createTextureSampler() {
@@ -604,15 +895,16 @@ namespace ufox::graphics::vulkan {
     }
 
     void GraphicsDevice::createVertexBuffer() {
-        vk::DeviceSize bufferSize = sizeof(TestRect);
+        vk::DeviceSize bufferSize = std::size(TestRect) * renderer::gui::GetVertexStride(guiVertexLayout);
 
         Buffer stagingBuffer{};
         createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer);
 
-        // copy the vertex and color data into that device memory
+        // copy the vertex and color data into that device memory, encoded for the pipeline's vertex layout
         auto pData = static_cast<uint8_t *>( stagingBuffer.memory->mapMemory( 0, bufferSize ) );
-        memcpy( pData, TestRect, bufferSize );
+        renderer::gui::WriteVertices(guiVertexLayout, TestRect, pData);
+        traceBufferData(stagingBuffer, 0, pData, bufferSize);
         stagingBuffer.memory->unmapMemory();
 
         createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferDst|vk::BufferUsageFlagBits::eVertexBuffer,
@@ -620,6 +912,7 @@ namespace ufox::graphics::vulkan {
             vertexBuffer);
 
         copyBuffer(stagingBuffer, vertexBuffer, bufferSize);
+        retireStaging(std::move(stagingBuffer));
     }
 
     void GraphicsDevice::createIndexBuffer() {
@@ -633,19 +926,21 @@ namespace ufox::graphics::vulkan {
         auto pData = static_cast<uint8_t *>( stagingBuffer.memory->mapMemory( 0, bufferSize ) );
         memcpy( pData, indices, bufferSize );
         stagingBuffer.memory->unmapMemory();
+        traceBufferData(stagingBuffer, 0, indices, bufferSize);
 
         createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferDst|vk::BufferUsageFlagBits::eIndexBuffer,
             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
             indexBuffer);
 
         copyBuffer(stagingBuffer, indexBuffer, bufferSize);
+        retireStaging(std::move(stagingBuffer));
     }
 
-    void GraphicsDevice::createUniformBuffers() {
+    void GraphicsDevice::createUniformBuffers(PresentationTarget& target) {
         constexpr vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
 
-        uniformBuffers.reserve(MAX_FRAMES_IN_FLIGHT); // Create elements
-        uniformBuffersMapped.reserve(MAX_FRAMES_IN_FLIGHT);
+        target.uniformBuffers.reserve(MAX_FRAMES_IN_FLIGHT); // Create elements
+        target.uniformBuffersMapped.reserve(MAX_FRAMES_IN_FLIGHT);
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
             Buffer buffer{};
@@ -658,13 +953,15 @@ namespace ufox::graphics::vulkan {
                 throw std::runtime_error("Buffer memory is not initialized for buffer " + std::to_string(i));
             }
             auto mapped = static_cast<uint8_t *>(buffer.memory->mapMemory(0, bufferSize));
-            uniformBuffers.emplace_back(std::move(buffer));
-            uniformBuffersMapped.emplace_back(mapped);
+            target.uniformBuffers.emplace_back(std::move(buffer));
+            target.uniformBuffersMapped.emplace_back(mapped);
         }
     }
 
     void GraphicsDevice::createRoundedCornerBuffer() {
-         constexpr vk::DeviceSize bufferSize = sizeof(RoundedRectParams);
+        if (usePushConstantParams) return;
+
+        constexpr vk::DeviceSize bufferSize = sizeof(RoundedRectParams);
 
         roundCornerBuffers.reserve(MAX_FRAMES_IN_FLIGHT); // Create elements
         roundCornerBuffersMapped.reserve(MAX_FRAMES_IN_FLIGHT);
@@ -685,103 +982,186 @@ namespace ufox::graphics::vulkan {
         }
     }
 
-    void GraphicsDevice::updateUniformBuffer(uint32_t currentImage) const {
+    void GraphicsDevice::createClipBuffers() {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        // TestRect draws unclipped, every vertex points at entry 0
+        constexpr vk::DeviceSize vertexClipSize = std::size(TestRect) * sizeof(uint32_t);
+        createBuffer(vertexClipSize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, vertexClipBuffer);
+        void* vertexClips = vertexClipBuffer.memory->mapMemory(0, vertexClipSize);
+        memset(vertexClips, 0, vertexClipSize);
+        traceBufferData(vertexClipBuffer, 0, vertexClips, vertexClipSize);
+        vertexClipBuffer.memory->unmapMemory();
+
+        constexpr vk::DeviceSize clipSize = sizeof(ClipParams) * MAX_CLIP_REGIONS;
+        clipRegions.reserve(MAX_CLIP_REGIONS);
+        clipBuffers.reserve(MAX_FRAMES_IN_FLIGHT);
+        clipBuffersMapped.reserve(MAX_FRAMES_IN_FLIGHT);
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            Buffer buffer{};
+            createBuffer(clipSize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, buffer);
+            auto mapped = static_cast<ClipParams*>(buffer.memory->mapMemory(0, clipSize));
+            mapped[0] = NoClip;
+            traceBufferData(buffer, 0, mapped, sizeof(ClipParams));
+            clipBuffers.emplace_back(std::move(buffer));
+            clipBuffersMapped.emplace_back(mapped);
+        }
+    }
+
+    void GraphicsDevice::setClipRegions(std::span<const ClipParams> regions) {
+        regions = regions.first(std::min<size_t>(regions.size(), MAX_CLIP_REGIONS));
+        clipRegions.assign(regions.begin(), regions.end());
+        if (clipRegions.empty()) clipRegions.push_back(NoClip);
+    }
+
+    void GraphicsDevice::updateUniformBuffer(const PresentationTarget& target, uint32_t frame) const {
         UniformBufferObject ubo{};
         ubo.model = glm::translate(glm::mat4(1.0f), glm::vec3(0+10, 0+10, 0.0f)) *
-                            glm::scale(glm::mat4(1.0f), glm::vec3(swapchainExtent.width -20, swapchainExtent.height-20, 100));
+                            glm::scale(glm::mat4(1.0f), glm::vec3(target.extent.width -20, target.extent.height-20, 100));
         ubo.view = glm::mat4(1.0f);
         ubo.proj = glm::ortho(
-        0.0f, static_cast<float>(swapchainExtent.width),
-        0.0f, static_cast<float>(swapchainExtent.height), // Swap bottom and top
+        0.0f, static_cast<float>(target.extent.width),
+        0.0f, static_cast<float>(target.extent.height), // Swap bottom and top
         -1.0f, 1.0f);
 
-        memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
-
-        RoundedRectParams params{};
-        // params.cornerRadius = glm::vec4(18.0f, 18.0f, 18.0f, 18.0f);
-        // params.borderThickness = glm::vec4(5.0f, 5.0f, 5.0f, 5.0f);
-        // params.borderTopColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        // params.borderRightColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        // params.borderBottomColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        // params.borderLeftColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        params.cornerRadius = glm::vec4(18.0f, 18.0f, 18.0f, 18.0f);
-        params.borderThickness = glm::vec4(18.0f, 18.0f, 18.0f, 18.0f);
-        params.borderTopColor = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f);
-        params.borderRightColor = glm::vec4(0.0f, 1.0f, 1.0f, 1.0f);
-        params.borderBottomColor = glm::vec4(1.0f, 1.0f, 0.0f, 1.0f);
-        params.borderLeftColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-
-        memcpy(roundCornerBuffersMapped[currentImage], &params, sizeof(params));
-
+        memcpy(target.uniformBuffersMapped[frame], &ubo, sizeof(ubo));
+        traceBufferData(target.uniformBuffers[frame], 0, &ubo, sizeof(ubo));
     }
 
     void GraphicsDevice::createDescriptorPool() {
-        std::array<vk::DescriptorPoolSize, 3> poolSize{};
-        poolSize[0].setType(vk::DescriptorType::eUniformBuffer)
-                   .setDescriptorCount(MAX_FRAMES_IN_FLIGHT);
-        poolSize[1].setType(vk::DescriptorType::eCombinedImageSampler)
-                   .setDescriptorCount(MAX_FRAMES_IN_FLIGHT);
-        poolSize[2].setType(vk::DescriptorType::eUniformBuffer)
-                   .setDescriptorCount(MAX_FRAMES_IN_FLIGHT);
+        std::vector<vk::DescriptorPoolSize> poolSize = shaderInterface->getPoolSizes(MAX_FRAMES_IN_FLIGHT * MAX_PRESENTATION_TARGETS);
 
         vk::DescriptorPoolCreateInfo poolInfo{};
         poolInfo.setPoolSizeCount(poolSize.size())
                 .setPPoolSizes(poolSize.data())
-                .setMaxSets(MAX_FRAMES_IN_FLIGHT)
+                .setMaxSets(MAX_FRAMES_IN_FLIGHT * MAX_PRESENTATION_TARGETS)
                 .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
 
         descriptorPool.emplace(*device, poolInfo);
     }
 
-    void GraphicsDevice::createDescriptorSets() {
-        std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, *descriptorSetLayout);
+    void GraphicsDevice::createDescriptorSets(PresentationTarget& target) {
+        memory::FrameVector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout, getFrameAllocator());
         vk::DescriptorSetAllocateInfo allocInfo{};
         allocInfo.setDescriptorPool(*descriptorPool)
                  .setDescriptorSetCount(MAX_FRAMES_IN_FLIGHT)
                  .setPSetLayouts(layouts.data());
 
-        descriptorSets.reserve(MAX_FRAMES_IN_FLIGHT);
-        descriptorSets = device->allocateDescriptorSets(allocInfo);
+        target.descriptorSets = device->allocateDescriptorSets(allocInfo);
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
             vk::DescriptorBufferInfo bufferInfo{};
-            bufferInfo.setBuffer(*uniformBuffers[i].data)
+            bufferInfo.setBuffer(*target.uniformBuffers[i].data)
                       .setOffset(0)
                       .setRange(sizeof(UniformBufferObject));
 
             vk::DescriptorImageInfo imageInfo{};
-            imageInfo.setImageView(*textureImage.view)
+            imageInfo.setImageView(getBoundTextureView())
                      .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
                      .setSampler(*textureSampler);
 
-            vk::DescriptorBufferInfo roundCornerInfo{};
-            roundCornerInfo.setBuffer(*roundCornerBuffers[i].data)
-                           .setOffset(0)
-                           .setRange(sizeof(RoundedRectParams));
-
-
-            std::array<vk::WriteDescriptorSet,3> write{};
-            write[0].setDstSet(*descriptorSets[i])
+            memory::FrameVector<vk::WriteDescriptorSet> write(2, getFrameAllocator());
+            write[0].setDstSet(*target.descriptorSets[i])
                     .setDstBinding(0)
                     .setDstArrayElement(0)
                     .setDescriptorType(vk::DescriptorType::eUniformBuffer)
                     .setDescriptorCount(1)
                     .setPBufferInfo(&bufferInfo);
-            write[1].setDstSet(*descriptorSets[i])
+            write[1].setDstSet(*target.descriptorSets[i])
                     .setDstBinding(1)
                     .setDstArrayElement(0)
                     .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
                     .setDescriptorCount(1)
                     .setPImageInfo(&imageInfo);
-            write[2].setDstSet(*descriptorSets[i])
-                    .setDstBinding(2)
+
+            vk::DescriptorBufferInfo vertexClipInfo{ *vertexClipBuffer.data, 0, vk::WholeSize };
+            write.emplace_back().setDstSet(*target.descriptorSets[i])
+                    .setDstBinding(3)
                     .setDstArrayElement(0)
-                    .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                    .setDescriptorType(vk::DescriptorType::eStorageBuffer)
                     .setDescriptorCount(1)
-                    .setPBufferInfo(&roundCornerInfo);
+                    .setPBufferInfo(&vertexClipInfo);
+
+            vk::DescriptorBufferInfo clipInfo{ *clipBuffers[i].data, 0, vk::WholeSize };
+            write.emplace_back().setDstSet(*target.descriptorSets[i])
+                    .setDstBinding(4)
+                    .setDstArrayElement(0)
+                    .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                    .setDescriptorCount(1)
+                    .setPBufferInfo(&clipInfo);
+
+            vk::DescriptorBufferInfo roundCornerInfo{};
+            if (!usePushConstantParams) {
+                roundCornerInfo.setBuffer(*roundCornerBuffers[i].data)
+                               .setOffset(0)
+                               .setRange(sizeof(RoundedRectParams));
+
+                write.emplace_back().setDstSet(*target.descriptorSets[i])
+                        .setDstBinding(2)
+                        .setDstArrayElement(0)
+                        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                        .setDescriptorCount(1)
+                        .setPBufferInfo(&roundCornerInfo);
+            }
+
+            updateDescriptorSets(write);
+        }
+    }
+
+    vk::ImageView GraphicsDevice::getBoundTextureView() const {
+        return textureImage.view ? **textureImage.view : **placeholderImage.view;
+    }
+
+    void GraphicsDevice::updateTextureDescriptors() {
+        vk::DescriptorImageInfo imageInfo{};
+        imageInfo.setImageView(getBoundTextureView())
+                 .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+                 .setSampler(*textureSampler);
+
+        memory::FrameVector<vk::WriteDescriptorSet> write(getFrameAllocator());
+        for (auto& target : targets) {
+            for (auto& descriptorSet : target->descriptorSets) {
+                write.emplace_back().setDstSet(*descriptorSet)
+                        .setDstBinding(1)
+                        .setDstArrayElement(0)
+                        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                        .setDescriptorCount(1)
+                        .setPImageInfo(&imageInfo);
+            }
+        }
+        updateDescriptorSets(write);
+    }
 
-            device->updateDescriptorSets(write, nullptr);
+    void GraphicsDevice::registerTextureResidency() {
+        // The statue has a single mip, so trimming it evicts it outright and the next use reloads it from disk
+        textureId = residency->add("statue", 1, textureImage.allocationSize,
+                                   [this](TextureId, uint32_t baseMip) -> std::optional<vk::DeviceSize> {
+            if (baseMip > 0) {
+                // Descriptor sets of every frame slot point at the view, they fall back to the placeholder
+                waitForIdle();
+                textureImage.clear();
+                updateTextureDescriptors();
+                return 0;
+            }
+            // Decoding runs on a worker like the startup load, finishTextureLoad uploads it once it lands
+            if (!pendingTexture.valid())
+                pendingTexture = jobSystem->submit([this] { return loadTexturePixels(); });
+            return std::nullopt;
+        });
+    }
+
+    void GraphicsDevice::allocateMemory(const vk::MemoryAllocateInfo &allocateInfo, MemoryCategory category,
+                                        std::optional<vk::raii::DeviceMemory> &memory, MemoryAllocation &allocation) {
+        try {
+            memory.emplace(*device, allocateInfo);
+        }
+        catch (const vk::OutOfDeviceMemoryError&) {
+            // Evict textures that are not needed by frames in flight and retry once
+            if (!residency || !residency->makeRoom(allocateInfo.allocationSize, frameNumber)) throw;
+            memory.emplace(*device, allocateInfo);
         }
+        allocation = MemoryAllocation(*memoryTracker, category, memoryTracker->getHeapIndex(allocateInfo.memoryTypeIndex),
+                                      allocateInfo.allocationSize);
     }
 
     void GraphicsDevice::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage,
@@ -797,8 +1177,9 @@ namespace ufox::graphics::vulkan {
         vk::MemoryRequirements memoryRequirements = buffer.data->getMemoryRequirements();
         vk::MemoryAllocateInfo memoryAllocateInfo( memoryRequirements.size, FindMemoryType( physicalDevice->getMemoryProperties(),
                                                    memoryRequirements.memoryTypeBits, properties ) );
-        buffer.memory.emplace(*device, memoryAllocateInfo);
+        allocateMemory(memoryAllocateInfo, CategorizeBuffer(usage, properties), buffer.memory, buffer.allocation);
         buffer.data->bindMemory( *buffer.memory, 0 );
+        if (trace) trace->record(TraceCreateBuffer{ TraceId(**buffer.data), size, static_cast<uint32_t>(usage), static_cast<uint32_t>(properties) });
     }
 
     void GraphicsDevice::createImage(vk::ImageTiling tiling,
@@ -810,30 +1191,69 @@ namespace ufox::graphics::vulkan {
                  .setExtent({image.extent.width, image.extent.height, 1})
                  .setMipLevels(1)
                  .setArrayLayers(1)
-                 .setSamples(vk::SampleCountFlagBits::e1)
+                 .setSamples(image.samples)
                  .setTiling(tiling)
                  .setInitialLayout(vk::ImageLayout::eUndefined)
                  .setUsage(usage)
-                 .setSamples(vk::SampleCountFlagBits::e1)
                  .setSharingMode(vk::SharingMode::eExclusive);
 
         image.data.emplace(*device, imageInfo);
 
         vk::MemoryRequirements memoryRequirements = image.data->getMemoryRequirements();
-        vk::MemoryAllocateInfo memoryAllocateInfo( memoryRequirements.size, FindMemoryType( physicalDevice->getMemoryProperties(),
-                                                   memoryRequirements.memoryTypeBits, properties ) );
-        image.memory.emplace(*device, memoryAllocateInfo);
+        vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice->getMemoryProperties();
+        auto memoryType = TryFindMemoryType(memoryProperties, memoryRequirements.memoryTypeBits, properties);
+        if (!memoryType && (properties & vk::MemoryPropertyFlagBits::eLazilyAllocated)) {
+            // Lazily allocated memory is only a preference, most desktop GPUs do not expose it
+            memoryType = TryFindMemoryType(memoryProperties, memoryRequirements.memoryTypeBits,
+                                           properties & ~vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eLazilyAllocated));
+        }
+        if (!memoryType) throw std::runtime_error("Failed to find a suitable memory type for image");
+
+        vk::MemoryAllocateInfo memoryAllocateInfo( memoryRequirements.size, *memoryType );
+        allocateMemory(memoryAllocateInfo, CategorizeImage(usage), image.memory, image.allocation);
+        image.allocationSize = memoryRequirements.size;
+        image.lazilyAllocated = static_cast<bool>(memoryProperties.memoryTypes[*memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated);
         image.data->bindMemory( *image.memory, 0 );
+        if (trace) trace->record(TraceCreateImage{ TraceId(**image.data), static_cast<uint32_t>(image.format), image.extent.width,
+                                                   image.extent.height, static_cast<uint32_t>(image.samples),
+                                                   static_cast<uint32_t>(usage), static_cast<uint32_t>(properties) });
     }
 
     void GraphicsDevice::copyBuffer(const Buffer& srcBuffer, const Buffer& dstBuffer, const vk::DeviceSize& size) const {
+        recordTransfer([&](const vk::raii::CommandBuffer& cmd) {
+            vk::BufferCopy copyRegion{};
+            copyRegion.setSize(size);
+            cmd.copyBuffer(*srcBuffer.data, *dstBuffer.data, { copyRegion });
+        });
+        frameMetrics.uploadBytes->add(size);
+        if (trace) trace->record(TraceCopyBuffer{ TraceId(**srcBuffer.data), TraceId(**dstBuffer.data), size });
+    }
+
+    void GraphicsDevice::recordTransfer(const std::function<void(const vk::raii::CommandBuffer&)>& record) const {
+        // Inside an upload batch everything lands in one submission, otherwise submit and wait right away
+        if (uploadCommands) {
+            record(*uploadCommands);
+            return;
+        }
         vk::raii::CommandBuffer cmd = beginSingleTimeCommands();
+        record(cmd);
+        endSingleTimeCommands(cmd);
+    }
 
-        vk::BufferCopy copyRegion{};
-        copyRegion.setSize(size);
-        cmd.copyBuffer(*srcBuffer.data, *dstBuffer.data, { copyRegion });
+    void GraphicsDevice::beginUploads() {
+        uploadCommands.emplace(beginSingleTimeCommands());
+    }
 
-        endSingleTimeCommands(cmd);
+    void GraphicsDevice::flushUploads() {
+        if (!uploadCommands) return;
+        endSingleTimeCommands(*uploadCommands);
+        uploadCommands.reset();
+        uploadStaging.clear();
+    }
+
+    void GraphicsDevice::retireStaging(Buffer&& staging) {
+        // Recorded copies still read from it until the batch is flushed
+        if (uploadCommands) uploadStaging.push_back(std::move(staging));
     }
 
     vk::raii::CommandBuffer GraphicsDevice::beginSingleTimeCommands() const {
@@ -861,7 +1281,6 @@ namespace ufox::graphics::vulkan {
     }
 
     void GraphicsDevice::transitionImageLayout(const Image& image, vk::ImageLayout oldLayout,vk::ImageLayout newLayout) const {
-        vk::raii::CommandBuffer cmd = beginSingleTimeCommands();
 
     vk::ImageMemoryBarrier barrier{};
     barrier.setOldLayout(oldLayout)
@@ -870,9 +1289,9 @@ namespace ufox::graphics::vulkan {
            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
            .setImage(*image.data)
            .setSubresourceRange({
-               image.format == vk::Format::eR8G8B8A8Srgb ? vk::ImageAspectFlagBits::eColor :
-               (image.format == vk::Format::eD32Sfloat ? vk::ImageAspectFlagBits::eDepth :
-                vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil),
+               image.format == vk::Format::eD32Sfloat ? vk::ImageAspectFlagBits::eDepth :
+               (image.format == vk::Format::eD32SfloatS8Uint || image.format == vk::Format::eD24UnormS8Uint ?
+                vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil : vk::ImageAspectFlagBits::eColor),
                0, 1, 0, 1
            });
 
@@ -894,18 +1313,21 @@ namespace ufox::graphics::vulkan {
                .setDstAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
         sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
         destinationStage = vk::PipelineStageFlagBits::eEarlyFragmentTests;
+    } else if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eColorAttachmentOptimal) {
+        barrier.setSrcAccessMask({})
+               .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
+        destinationStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     } else {
         throw std::invalid_argument("Unsupported layout transition!");
     }
 
-    cmd.pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, { barrier });
-
-    endSingleTimeCommands(cmd);
+    recordTransfer([&](const vk::raii::CommandBuffer& cmd) {
+        cmd.pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, { barrier });
+    });
     }
 
     void GraphicsDevice::copyBufferToImage(const Buffer& buffer, const Image& image) const {
-        vk::raii::CommandBuffer cmd = beginSingleTimeCommands();
-
         vk::BufferImageCopy region{};
         region.setImageSubresource({ vk::ImageAspectFlagBits::eColor, 0, 0, 1 })
               .setImageOffset({ 0, 0, 0 })
@@ -914,12 +1336,15 @@ namespace ufox::graphics::vulkan {
               .setBufferRowLength(0)
               .setBufferImageHeight(0);
 
-        cmd.copyBufferToImage(*buffer.data, *image.data, vk::ImageLayout::eTransferDstOptimal, { region });
-
-        endSingleTimeCommands(cmd);
+        recordTransfer([&](const vk::raii::CommandBuffer& cmd) {
+            cmd.copyBufferToImage(*buffer.data, *image.data, vk::ImageLayout::eTransferDstOptimal, { region });
+        });
+        // Textures are RGBA8, one mip
+        frameMetrics.uploadBytes->add(vk::DeviceSize{image.extent.width} * image.extent.height * 4);
+        if (trace) trace->record(TraceCopyBufferToImage{ TraceId(**buffer.data), TraceId(**image.data) });
     }
 
-    vk::Format GraphicsDevice::findSupportedFormat(const std::vector<vk::Format> &candidates, vk::ImageTiling tiling,
+    vk::Format GraphicsDevice::findSupportedFormat(std::span<const vk::Format> candidates, vk::ImageTiling tiling,
         vk::FormatFeatureFlags features) const {
 
         for(vk::Format format : candidates) {
@@ -936,129 +1361,427 @@ namespace ufox::graphics::vulkan {
     }
 
     void GraphicsDevice::recreateSwapchain(const windowing::sdl::UfoxWindow& window) {
+        auto [width, height] = window.getSize();
+        recreateSwapchain(vk::Extent2D{ width, height });
+    }
+
+    void GraphicsDevice::recreateSwapchain(const vk::Extent2D& windowExtent) {
+        recreateSwapchain(*targets.front(), windowExtent);
+    }
+
+    void GraphicsDevice::recreateSwapchain(PresentationTarget& target, const vk::Extent2D& windowExtent) {
         waitForIdle();
-        depthImage.clear();
-        swapchainImageViews.clear();
-        swapchain.reset();
-        createSwapchain(window);
-        createDepthImage();
+        frameMetrics.swapchainRecreations->add();
+        target.resizePending = false;
+        target.depthImage.clear();
+        target.colorImage.clear();
+        target.imageViews.clear();
+        target.swapchain.reset();
+        createSwapchain(target, windowExtent);
+        if (!target.swapchain) return;
+        createColorImage(target);
+        createDepthImage(target);
     }
 
-    void GraphicsDevice::drawFrame(const windowing::sdl::UfoxWindow& window) {
-        if (!enableRender) return;
+    void GraphicsDevice::initPresentationTarget(PresentationTarget &target, const vk::Extent2D &windowExtent) {
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        target.imageAvailableSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
+        target.renderFinishedSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+            target.imageAvailableSemaphores.emplace_back(*device, semaphoreInfo);
+            target.renderFinishedSemaphores.emplace_back(*device, semaphoreInfo);
+        }
 
-        [[maybe_unused]] auto waitResult = device->waitForFences(*inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        createSwapchain(target, windowExtent);
+        if (!target.swapchain) return;
+        createColorImage(target);
+        createDepthImage(target);
+    }
 
-        auto [result, imageIndex] = swapchain->acquireNextImage(UINT64_MAX, *imageAvailableSemaphores[currentFrame], nullptr);
-        currentImage = imageIndex;
+    void GraphicsDevice::createTargetResources(PresentationTarget &target) {
+        createUniformBuffers(target);
+        createDescriptorSets(target);
+    }
 
-        if (result == vk::Result::eErrorOutOfDateKHR) {
-            recreateSwapchain(window);
-            return;
+    PresentationTarget& GraphicsDevice::addWindow(const windowing::sdl::UfoxWindow &window) {
+        if (targets.size() >= MAX_PRESENTATION_TARGETS)
+            throw std::runtime_error(fmt::format("At most {} windows can share a device", MAX_PRESENTATION_TARGETS));
+
+        VkSurfaceKHR rawSurface;
+        if (!SDL_Vulkan_CreateSurface(window.get(), **instance, nullptr, &rawSurface))
+            throw windowing::sdl::SDLException("Failed to create surface");
+        vk::raii::SurfaceKHR surface(*instance, rawSurface);
+
+        // The present queue was picked for the primary window, every other surface has to accept it as well
+        if (!physicalDevice->getSurfaceSupportKHR(*queueFamilyIndices.present, *surface))
+            throw std::runtime_error("The present queue cannot present to this window");
+
+        auto [width, height] = window.getSize();
+        auto created = std::make_unique<PresentationTarget>(std::move(surface));
+        initPresentationTarget(*created, { width, height });
+        createTargetResources(*created);
+        PresentationTarget& target = *targets.emplace_back(std::move(created));
+
+        // A new swapchain format is one more pipeline variant, it builds in the background until ready
+        if (target.format != guiPipelineKey.colorFormat) {
+            PipelineKey key = guiPipelineKey;
+            key.colorFormat = target.format;
+            pipelineCache->prewarm(key);
+        }
+        return target;
+    }
+
+    void GraphicsDevice::removeWindow(const PresentationTarget &target) {
+        if (&target == targets.front().get()) throw std::invalid_argument("The primary window lives as long as the device");
+
+        // Frames in flight may still wait on its semaphores or present its images
+        waitForIdle();
+        std::erase_if(targets, [&](const std::unique_ptr<PresentationTarget>& t) { return t.get() == &target; });
+    }
+
+    bool GraphicsDevice::acquireImage(PresentationTarget &target) {
+        target.acquired = false;
+        if (!target.swapchain) return false;
+
+        vk::Result result;
+        uint32_t imageIndex = 0;
+        try {
+            std::tie(result, imageIndex) = target.swapchain->acquireNextImage(UINT64_MAX, *target.imageAvailableSemaphores[currentFrame], nullptr);
+        }
+        catch (const vk::OutOfDateKHRError&) {
+            result = vk::Result::eErrorOutOfDateKHR;
         }
 
+        if (result == vk::Result::eErrorOutOfDateKHR) {
+            recreateSwapchain(target, target.requestedExtent);
+            return false;
+        }
         if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR) {
             throw std::runtime_error("Failed to acquire swapchain image");
         }
 
-        device->resetFences(*inFlightFences[currentFrame]);
-        vk::raii::CommandBuffer& cmd = commandBuffers[currentFrame];
-        cmd.reset();
+        target.imageIndex = imageIndex;
+        target.acquired = true;
+        return true;
+    }
 
-        vk::CommandBufferBeginInfo beginInfo{};
-        cmd.begin(beginInfo);
+    void GraphicsDevice::recordTarget(const vk::raii::CommandBuffer &cmd, PresentationTarget &target) {
+        const uint32_t imageIndex = target.imageIndex;
 
-        TransitionImageLayout(cmd, swapchainImages[imageIndex], swapchainFormat,
+        TransitionImageLayout(cmd, target.images[imageIndex], target.format,
             vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal,
             vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eColorAttachmentWrite,
-            vk::PipelineStageFlagBits2::eTopOfPipe, vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+            vk::PipelineStageFlagBits2::eTopOfPipe, vk::PipelineStageFlagBits2::eColorAttachmentOutput, trace.get());
 
 
         vk::RenderingAttachmentInfo colorAttachment{};
-        colorAttachment.setImageView(*swapchainImageViews[imageIndex])
+        colorAttachment.setImageView(*target.imageViews[imageIndex])
             .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
             .setLoadOp(vk::AttachmentLoadOp::eClear)
             .setStoreOp(vk::AttachmentStoreOp::eStore)
             .setClearValue({ std::array{0.2f, 0.2f, 0.2f, 1.0f} });
 
+        if (target.colorImage.view) {
+            // Render into the transient multisampled image and resolve into the swapchain image at the end of the pass
+            colorAttachment.setImageView(*target.colorImage.view)
+                .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+                .setResolveMode(vk::ResolveModeFlagBits::eAverage)
+                .setResolveImageView(*target.imageViews[imageIndex])
+                .setResolveImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
+        }
+
         vk::RenderingAttachmentInfo depthAttachment{};
-        depthAttachment.setImageView(*depthImage.view)
-                       .setImageLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+        if (useDepth) depthAttachment.setImageView(*target.depthImage.view);
+        depthAttachment.setImageLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
                        .setLoadOp(vk::AttachmentLoadOp::eClear)
                        .setStoreOp(vk::AttachmentStoreOp::eDontCare)
                        .setClearValue(vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0)));
 
 
         vk::RenderingInfo renderingInfo{};
-        renderingInfo.setRenderArea({ {0, 0}, swapchainExtent })
+        renderingInfo.setRenderArea({ {0, 0}, target.extent })
             .setLayerCount(1)
             .setColorAttachmentCount(1)
             .setPColorAttachments(&colorAttachment)
-            .setPDepthAttachment(&depthAttachment);
+            .setPDepthAttachment(useDepth ? &depthAttachment : nullptr);
 
         cmd.beginRendering(renderingInfo);
 
-        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *graphicsPipeline);
-
-        cmd.setViewport(0, vk::Viewport{ 0.0f, 0.0f, static_cast<float>(swapchainExtent.width), static_cast<float>(swapchainExtent.height), 0.0f, 1.0f });
-        cmd.setScissor(0, vk::Rect2D{ {0, 0}, swapchainExtent });
-        cmd.setCullMode(vk::CullModeFlagBits::eNone);
-        cmd.setFrontFace(vk::FrontFace::eClockwise);
-        cmd.setPrimitiveTopology(vk::PrimitiveTopology::eTriangleList);
-
-        // cmd.clearColorImage(swapchainImages[imageIndex], vk::ImageLayout::eUndefined, vk::ClearColorValue{0.023f,0.033f,0.033f,1.0f},
-        //             vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0,1,0,1});
+        cmd.setDepthTestEnable(useDepth);
+        cmd.setDepthWriteEnable(useDepth);
+        cmd.setDepthCompareOp(vk::CompareOp::eLess);
+
+        if (trace) {
+            const vk::Image swapchainImage = target.images[imageIndex];
+            const bool multisampled = target.colorImage.view.has_value();
+            trace->record(TraceBeginRendering{
+                TraceId(multisampled ? **target.colorImage.data : swapchainImage),
+                multisampled ? TraceId(swapchainImage) : 0,
+                useDepth ? TraceId(**target.depthImage.data) : 0,
+                target.extent.width, target.extent.height, { 0.2f, 0.2f, 0.2f, 1.0f } });
+            trace->record(TraceSetDepthState{ useDepth, useDepth, static_cast<uint32_t>(vk::CompareOp::eLess) });
+        }
 
-        vk::Buffer vertexBuffers[] = {*vertexBuffer.data};
-        vk::DeviceSize offsets[] = {0};
+        // Targets whose swapchain format differs from the primary one use their own variant of the GUI pipeline
+        vk::Pipeline pipeline = graphicsPipeline;
+        if (target.format != guiPipelineKey.colorFormat) {
+            // Copying the key allocates its shader paths, only do it when the base key or the format changed
+            if (target.pipelineKeyVersion != guiPipelineKeyVersion || target.pipelineKey.colorFormat != target.format) {
+                target.pipelineKey = guiPipelineKey;
+                target.pipelineKey.colorFormat = target.format;
+                target.pipelineKeyVersion = guiPipelineKeyVersion;
+            }
+            pipeline = pipelineCache->request(target.pipelineKey);
+        }
 
-        cmd.bindVertexBuffers( 0, vertexBuffers, offsets );
-        cmd.bindIndexBuffer( *indexBuffer.data, 0, vk::IndexType::eUint16 );
-        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipelineLayout, 0, *descriptorSets[currentFrame], nullptr);
+        renderer::gui::DrawList drawList(getFrameAllocator(), useDepth);
+        if (pipeline) {
+            renderer::gui::DrawCommand draw{};
+            draw.pipeline = pipeline;
+            draw.layout = pipelineLayout;
+            draw.descriptorSet = *target.descriptorSets[currentFrame];
+            draw.vertexBuffer = *vertexBuffer.data;
+            draw.indexBuffer = *indexBuffer.data;
+            draw.indexType = vk::IndexType::eUint16;
+            draw.scissor = vk::Rect2D{ {0, 0}, target.extent };
+            draw.indexCount = static_cast<uint32_t>(std::size(indices));
+
+            if (usePushConstantParams) {
+                draw.pushConstantStages = shaderInterface->pushConstantRanges.front().stageFlags;
+                drawList.add(draw, roundedRectParams);
+            }
+            else {
+                drawList.add(draw);
+            }
+        }
 
-        cmd.drawIndexed(static_cast<uint32_t>(std::size(indices)), 1, 0, 0, 0);
+        drawList.compile();
+        drawList.record(cmd, vk::Viewport{ 0.0f, 0.0f, static_cast<float>(target.extent.width), static_cast<float>(target.extent.height), 0.0f, 1.0f }, drawStats, trace.get());
 
         cmd.endRendering();
+        if (trace) trace->record(TraceEndRendering{});
 
-        TransitionImageLayout(cmd, swapchainImages[imageIndex], swapchainFormat,
+        TransitionImageLayout(cmd, target.images[imageIndex], target.format,
             vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::ePresentSrcKHR,
             vk::AccessFlagBits2::eColorAttachmentWrite, vk::AccessFlagBits2::eNone,
-            vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::PipelineStageFlagBits2::eBottomOfPipe);
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::PipelineStageFlagBits2::eBottomOfPipe, trace.get());
+
+        updateUniformBuffer(target, currentFrame);
+    }
+
+    void GraphicsDevice::reloadChangedShaders() {
+        if (pendingShaderReload.valid()) {
+            if (pendingShaderReload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+            std::vector<std::string> changed;
+            try {
+                changed = pendingShaderReload.get();
+            }
+            catch (const std::exception& e) {
+                fmt::println("Shader reload failed: {}", e.what());
+                return;
+            }
+
+            for (const auto& shader : changed) layoutCache->invalidate(shader);
+            shaderInterface = &layoutCache->get({ guiPipelineKey.vertexShader, guiPipelineKey.fragmentShader });
+            if (shaderInterface->pipelineLayout != pipelineLayout) {
+                fmt::println("Shader interface changed, restart to apply the new bindings");
+                return;
+            }
+
+            for (const auto& shader : changed) pipelineCache->reload(shader);
+            return;
+        }
+
+        auto changed = shaderCompiler->pollChanges();
+        if (changed.empty()) return;
+
+        // Compile off the render thread, the pipelines themselves are rebuilt by PipelineCache::reload
+        pendingShaderReload = jobSystem->submit([this, changed] {
+            for (const auto& shader : changed) (void)shaderCompiler->load(shader);
+            return changed;
+        });
+    }
+
+    void GraphicsDevice::drawFrame(const windowing::sdl::UfoxWindow& window) {
+        auto [width, height] = window.getSize();
+        drawFrame(vk::Extent2D{ width, height });
+    }
+
+    void GraphicsDevice::drawFrame(const vk::Extent2D& windowExtent) {
+        using Clock = std::chrono::steady_clock;
+        const auto elapsedMs = [](Clock::time_point from, Clock::time_point to) {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        };
+
+        if (!enableRender) {
+            // Time spent minimized is not a stall
+            lastFrameStart.reset();
+            return;
+        }
+
+        const Clock::time_point frameStart = Clock::now();
+        if (lastFrameStart) {
+            const double frameMs = elapsedMs(*lastFrameStart, frameStart);
+            frameMetrics.frameMs->record(frameMs);
+            if (frameMs > STALL_THRESHOLD_MS) frameMetrics.stalls->add();
+        }
+        lastFrameStart = frameStart;
+
+        [[maybe_unused]] auto waitResult = device->waitForFences(*inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        frameMetrics.fenceWaitMs->record(elapsedMs(frameStart, Clock::now()));
+
+        // CPU data of this frame slot is no longer referenced once its fence signaled
+        const memory::AllocationStats heapBefore = memory::GetAllocationStats();
+        frameArenas->beginFrame(currentFrame);
+        readTimestamps();
+
+        if (pendingTexture.valid() && pendingTexture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            finishTextureLoad();
+
+        if (frameNumber % BUDGET_CHECK_INTERVAL == 0) {
+            residency->update(frameNumber, getFrameAllocator());
+            frameMetrics.gpuMemoryBytes->set(static_cast<double>(memoryTracker->getTrackedBytes()));
+        }
+        if (textureId) residency->use(*textureId, frameNumber);
+
+        reloadChangedShaders();
+        // The number residency and metrics saw this frame, the trace records it too
+        const uint64_t frame = frameNumber++;
+        pipelineCache->beginFrame(frame, MAX_FRAMES_IN_FLIGHT);
+        graphicsPipeline = pipelineCache->request(guiPipelineKey);
+
+        // The primary window is sized by the caller, other windows are resized through PresentationTarget::resize
+        PresentationTarget& primary = *targets.front();
+        if (primary.requestedExtent != windowExtent) {
+            primary.requestedExtent = windowExtent;
+            primary.resizePending = true;
+        }
+
+        memory::FrameVector<PresentationTarget*> acquired(getFrameAllocator());
+        double acquireMs = 0.0;
+        for (auto& target : targets) {
+            if (target->resizePending) recreateSwapchain(*target, target->requestedExtent);
+            const Clock::time_point acquireStart = Clock::now();
+            if (acquireImage(*target)) acquired.push_back(target.get());
+            acquireMs += elapsedMs(acquireStart, Clock::now());
+        }
+        frameMetrics.acquireMs->record(acquireMs);
+        // Leave the fence signaled, nothing is submitted this frame
+        if (acquired.empty()) {
+            // The slot is not advanced either, handing the number out again keeps frame distances equal to submissions
+            frameNumber = frame;
+            frameMetrics.skipped->add();
+            frameMetrics.cpuMs->record(elapsedMs(frameStart, Clock::now()));
+            return;
+        }
+
+        device->resetFences(*inFlightFences[currentFrame]);
+        vk::raii::CommandBuffer& cmd = commandBuffers[currentFrame];
+        cmd.reset();
 
+        vk::CommandBufferBeginInfo beginInfo{};
+        cmd.begin(beginInfo);
+        if (trace) trace->record(TraceBeginFrame{ frame });
+
+        if (timestampQueryPool) {
+            cmd.resetQueryPool(*timestampQueryPool, currentFrame * 2, 2);
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, *timestampQueryPool, currentFrame * 2);
+        }
 
+        // All windows go into one command buffer, DrawList::record accumulates into drawStats
+        drawStats = {};
+        for (PresentationTarget* target : acquired) recordTarget(cmd, *target);
+
+        if (timestampQueryPool) {
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eColorAttachmentOutput, *timestampQueryPool, currentFrame * 2 + 1);
+            timestampModes[currentFrame] = antiAliasing;
+            timestampsWritten[currentFrame] = true;
+        }
 
         cmd.end();
 
-        updateUniformBuffer(currentFrame);
+        if (!usePushConstantParams) {
+            memcpy(roundCornerBuffersMapped[currentFrame], &roundedRectParams, sizeof(roundedRectParams));
+            traceBufferData(roundCornerBuffers[currentFrame], 0, &roundedRectParams, sizeof(roundedRectParams));
+        }
+        const vk::DeviceSize clipSize = clipRegions.size() * sizeof(ClipParams);
+        memcpy(clipBuffersMapped[currentFrame], clipRegions.data(), clipSize);
+        traceBufferData(clipBuffers[currentFrame], 0, clipRegions.data(), clipSize);
+
+        memory::FrameVector<vk::Semaphore> waitSemaphores(getFrameAllocator());
+        memory::FrameVector<vk::PipelineStageFlags> waitStages(getFrameAllocator());
+        memory::FrameVector<vk::Semaphore> signalSemaphores(getFrameAllocator());
+        memory::FrameVector<vk::SwapchainKHR> swapchains(getFrameAllocator());
+        memory::FrameVector<uint32_t> imageIndices(getFrameAllocator());
+        for (PresentationTarget* target : acquired) {
+            waitSemaphores.push_back(*target->imageAvailableSemaphores[currentFrame]);
+            waitStages.push_back(vk::PipelineStageFlagBits::eTopOfPipe);
+            signalSemaphores.push_back(*target->renderFinishedSemaphores[currentFrame]);
+            swapchains.push_back(**target->swapchain);
+            imageIndices.push_back(target->imageIndex);
+        }
 
         vk::SubmitInfo submitInfo{};
-        vk::PipelineStageFlags waitStage{ vk::PipelineStageFlagBits::eTopOfPipe }; // Fixed from TopOfPipe
-        submitInfo.setWaitSemaphoreCount(1)
-            .setPWaitSemaphores(&(*imageAvailableSemaphores[currentFrame]))
-            .setPWaitDstStageMask(&waitStage)
+        submitInfo.setWaitSemaphoreCount(static_cast<uint32_t>(waitSemaphores.size()))
+            .setPWaitSemaphores(waitSemaphores.data())
+            .setPWaitDstStageMask(waitStages.data())
             .setCommandBufferCount(1)
             .setPCommandBuffers(&(*cmd))
-            .setSignalSemaphoreCount(1)
-            .setPSignalSemaphores(&(*renderFinishedSemaphores[currentFrame]));
+            .setSignalSemaphoreCount(static_cast<uint32_t>(signalSemaphores.size()))
+            .setPSignalSemaphores(signalSemaphores.data());
 
         graphicsQueue->submit(submitInfo, *inFlightFences[currentFrame]);
+        if (trace) trace->record(TraceSubmit{ static_cast<uint32_t>(acquired.size()) });
 
+        // One present call for every window, per swapchain results tell which of them went stale
+        memory::FrameVector<vk::Result> presentResults(acquired.size(), vk::Result::eSuccess, getFrameAllocator());
         vk::PresentInfoKHR presentInfo{};
-        presentInfo.setWaitSemaphoreCount(1)
-            .setPWaitSemaphores(&*renderFinishedSemaphores[currentFrame])
-            .setSwapchainCount(1)
-            .setPSwapchains(&**swapchain)
-            .setPImageIndices(&imageIndex);
-
-        vk::Result presentResult = presentQueue->presentKHR(presentInfo);
-        if (presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR) {
-            recreateSwapchain(window);
+        presentInfo.setWaitSemaphoreCount(static_cast<uint32_t>(signalSemaphores.size()))
+            .setPWaitSemaphores(signalSemaphores.data())
+            .setSwapchainCount(static_cast<uint32_t>(swapchains.size()))
+            .setPSwapchains(swapchains.data())
+            .setPImageIndices(imageIndices.data())
+            .setPResults(presentResults.data());
+
+        vk::Result presentResult;
+        const Clock::time_point presentStart = Clock::now();
+        try {
+            presentResult = presentQueue->presentKHR(presentInfo);
+        }
+        catch (const vk::OutOfDateKHRError&) {
+            presentResult = vk::Result::eErrorOutOfDateKHR;
         }
-        else if (presentResult != vk::Result::eSuccess) {
+        frameMetrics.presentMs->record(elapsedMs(presentStart, Clock::now()));
+        if (presentResult != vk::Result::eSuccess && presentResult != vk::Result::eSuboptimalKHR &&
+            presentResult != vk::Result::eErrorOutOfDateKHR) {
             throw std::runtime_error("Failed to present swapchain image");
         }
 
+        for (size_t i = 0; i < acquired.size(); ++i) {
+            const vk::Result result = presentResults[i];
+            if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR) {
+                acquired[i]->resizePending = true;
+            }
+            else if (result != vk::Result::eSuccess) {
+                throw std::runtime_error("Failed to present swapchain image");
+            }
+        }
+
+        frameHeapAllocations = memory::GetAllocationStats().count - heapBefore.count;
         currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+
+        frameMetrics.frames->add();
+        frameMetrics.draws->add(drawStats.draws);
+        frameMetrics.triangles->add(drawStats.triangles);
+        frameMetrics.heapAllocations->add(frameHeapAllocations);
+        frameMetrics.cpuMs->record(elapsedMs(frameStart, Clock::now()));
+
+        if (!firstFramePresented) {
+            firstFramePresented = true;
+            startupTimeline.mark("first frame");
+            startupTimeline.report("Startup timeline");
+        }
     }
 }
 
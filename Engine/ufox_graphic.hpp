@@ -4,12 +4,14 @@
 
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include <array>
+#include <span>
 #include <fmt/base.h>
 #include <SDL3/SDL_vulkan.h>
 #include <SDL3_image/SDL_image.h>
@@ -19,6 +21,18 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <chrono>
+#include <future>
+#include "Engine/ufox_job_system.hpp"
+#include "Engine/ufox_memory.hpp"
+#include "Engine/ufox_timeline.hpp"
+#include "Engine/ufox_metrics.hpp"
+#include "Engine/ufox_asset_pack.hpp"
+#include "Engine/ufox_gpu_memory.hpp"
+#include "Engine/ufox_gui_draw_list.hpp"
+#include "Engine/ufox_pipeline_cache.hpp"
+#include "Engine/ufox_pipeline_layout_cache.hpp"
+#include "Engine/ufox_tools_shader_compiler.hpp"
+#include "Engine/ufox_trace.hpp"
 
 
 namespace ufox::graphics {
@@ -27,6 +41,33 @@ namespace ufox::graphics {
         glm::vec3 position;
         glm::vec4 color;
         glm::vec2 texCoord;
+
+        static vk::VertexInputBindingDescription getBindingDescription() {
+            vk::VertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 0;
+            bindingDescription.stride = sizeof(Vertex);
+            bindingDescription.inputRate = vk::VertexInputRate::eVertex;
+            return bindingDescription;
+        }
+
+        static std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions() {
+            std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions{};
+            attributeDescriptions[0].binding = 0;
+            attributeDescriptions[0].location = 0;
+            attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
+            attributeDescriptions[0].offset = offsetof(Vertex, position);
+
+            attributeDescriptions[1].binding = 0;
+            attributeDescriptions[1].location = 1;
+            attributeDescriptions[1].format = vk::Format::eR32G32B32A32Sfloat;
+            attributeDescriptions[1].offset = offsetof(Vertex, color);
+
+            attributeDescriptions[2].binding = 0;
+            attributeDescriptions[2].location = 2;
+            attributeDescriptions[2].format = vk::Format::eR32G32Sfloat;
+            attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
+            return attributeDescriptions;
+        }
     };
 
     static constexpr Vertex TestRect[] = {
@@ -50,22 +91,32 @@ namespace ufox::graphics {
         glm::vec4 borderRightColor;
         glm::vec4 borderBottomColor;
         glm::vec4 borderLeftColor;
+    };
+
+    static_assert(sizeof(RoundedRectParams) == 96, "RoundedRectParams must match the shader blocks");
 
+    // One entry of the GUI clip table, mirrors ClipRegion in Shaders/rounded_rect.glsl (std430). Draws select an
+    // entry per vertex, so the clip never enters push constants or uniforms and differently clipped draws merge.
+    struct ClipParams {
+        glm::vec4 rect;               // x, y, width, height in framebuffer pixels, negative width disables clipping
+        glm::vec4 radius;             // per-corner radius of the clip, same order as RoundedRectParams::cornerRadius
     };
+
+    // Entry 0 of every clip table
+    static constexpr ClipParams NoClip{ {0.0f, 0.0f, -1.0f, -1.0f}, {0.0f, 0.0f, 0.0f, 0.0f} };
 }
 
 namespace ufox::graphics::vulkan {
 
     static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 
+    static std::optional<uint32_t> TryFindMemoryType(const vk::PhysicalDeviceMemoryProperties & memoryProperties, uint32_t typeBits, vk::MemoryPropertyFlags requirementsMask );
     static uint32_t FindMemoryType(const vk::PhysicalDeviceMemoryProperties & memoryProperties, uint32_t typeBits, vk::MemoryPropertyFlags requirementsMask );
 
     static void TransitionImageLayout(const vk::raii::CommandBuffer& cmd, const vk::Image& image, const vk::Format& format,
             vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
             vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
-            vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage);
-
-    static std::vector<char> loadShader(const std::string& filename);
+            vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage, TraceWriter* trace = nullptr);
 
     struct Image {
         std::optional<vk::raii::Image> data{};
@@ -73,20 +124,46 @@ namespace ufox::graphics::vulkan {
         std::optional<vk::raii::ImageView> view{};
         vk::Format format{ vk::Format::eUndefined};
         vk::Extent2D extent{ 0, 0 };
+        vk::SampleCountFlagBits samples{ vk::SampleCountFlagBits::e1 };
+        vk::DeviceSize allocationSize{ 0 };
+        bool lazilyAllocated{ false };
+        MemoryAllocation allocation{};
 
         void clear() {
             view.reset();
             data.reset();
             memory.reset();
+            allocation.reset();
         }
     };
 
     struct Buffer {
         std::optional<vk::raii::Buffer> data{};
         std::optional<vk::raii::DeviceMemory> memory{};
+        MemoryAllocation allocation{};
+    };
+
+
+
+    enum class AntiAliasing : uint8_t {
+        Analytic,   // single sample, edges come from the SDF coverage in the fragment shader
+        Msaa2,
+        Msaa4,
+        Msaa8,
     };
 
+    static constexpr std::array ANTI_ALIASING_MODES = { AntiAliasing::Analytic, AntiAliasing::Msaa2, AntiAliasing::Msaa4, AntiAliasing::Msaa8 };
 
+    [[nodiscard]] vk::SampleCountFlagBits GetSampleCount(AntiAliasing mode);
+    [[nodiscard]] const char* ToString(AntiAliasing mode);
+
+    struct AntiAliasingCost {
+        AntiAliasing mode;
+        bool supported;
+        vk::DeviceSize attachmentBytes;     // multisampled color + depth at the current extent, 0 for Analytic
+        bool lazilyAllocated;               // attachments live in tile memory, attachmentBytes is not really spent
+        float gpuFrameMs;                   // smoothed GPU time of the render pass, negative until measured
+    };
 
     struct QueueFamilyIndices
     {
@@ -96,10 +173,57 @@ namespace ufox::graphics::vulkan {
 
     static bool AreExtensionsSupported(const std::vector<const char*>& required, const std::vector<vk::ExtensionProperties>& available);
 
+    // Everything that belongs to one window: surface, swapchain, per-frame semaphores, the multisampled and depth
+    // attachments sized to it and the uniforms that hold its projection. Pipelines, textures and geometry stay on
+    // the GraphicsDevice and are shared by every target.
+    class PresentationTarget {
+    public:
+        explicit PresentationTarget(vk::raii::SurfaceKHR&& surface) : surface{std::move(surface)} {}
+
+        PresentationTarget(const PresentationTarget&) = delete;
+        PresentationTarget& operator=(const PresentationTarget&) = delete;
+
+        // Applied by the next drawFrame, call it when the window reports a new size
+        void resize(const vk::Extent2D& windowExtent) { requestedExtent = windowExtent; resizePending = true; }
+
+        [[nodiscard]] vk::Format getFormat() const { return format; }
+        [[nodiscard]] vk::Extent2D getExtent() const { return extent; }
+
+    private:
+        friend class GraphicsDevice;
+
+        vk::raii::SurfaceKHR surface;
+        std::optional<vk::raii::SwapchainKHR> swapchain{};
+        std::vector<vk::Image> images;
+        std::vector<vk::raii::ImageView> imageViews;
+        vk::Format format{ vk::Format::eUndefined };
+        vk::PresentModeKHR presentMode{ vk::PresentModeKHR::eFifo };
+        vk::Extent2D extent{ 0, 0 };
+        vk::Extent2D requestedExtent{ 0, 0 };
+        bool resizePending{false};
+
+        Image colorImage{};
+        Image depthImage{};
+
+        std::vector<vk::raii::Semaphore> imageAvailableSemaphores;
+        std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+        std::vector<Buffer> uniformBuffers;
+        std::vector<uint8_t *> uniformBuffersMapped;
+        std::vector<vk::raii::DescriptorSet> descriptorSets;
+
+        // Image acquired for the frame being recorded
+        uint32_t imageIndex{0};
+        bool acquired{false};
+
+        // GUI pipeline variant for a format other than the primary one, kept here so frames do not copy the key
+        PipelineKey pipelineKey{};
+        uint64_t pipelineKeyVersion{0};
+    };
+
     class GraphicsDevice {
     public:
         GraphicsDevice(const windowing::sdl::UfoxWindow& window, const char* engineName, uint32_t engineVersion, const char* appName, uint32_t appVersion);
-        ~GraphicsDevice() = default;
+        ~GraphicsDevice();
 
         // Delete copy constructors
         GraphicsDevice(const GraphicsDevice&) = delete;
@@ -112,8 +236,37 @@ namespace ufox::graphics::vulkan {
         bool useVsync{true};
         bool enableRender{true};
 
+        // Pure 2D GUI draws in painter's order and needs no depth buffer.
+        [[nodiscard]] bool isDepthEnabled() const { return useDepth; }
+        void setDepthEnabled(bool enabled);
+
+        // MSAA resolves into the swapchain image inside dynamic rendering, the multisampled attachments are
+        // transient. Unsupported sample counts are rejected and keep the current mode.
+        [[nodiscard]] AntiAliasing getAntiAliasing() const { return antiAliasing; }
+        [[nodiscard]] bool isAntiAliasingSupported(AntiAliasing mode) const;
+        bool setAntiAliasing(AntiAliasing mode);
+        // Memory and measured GPU time per mode, modes that were never active report gpuFrameMs < 0
+        [[nodiscard]] std::vector<AntiAliasingCost> getAntiAliasingCosts() const;
+
+        // Per-draw parameters travel as push constants when the device allows, otherwise through the
+        // per-frame uniform buffers at binding 2
+        [[nodiscard]] bool usesPushConstantParams() const { return usePushConstantParams; }
+        void setRoundedRectParams(const RoundedRectParams& params) { roundedRectParams = params; }
+
+        // The window passed to the constructor is the primary target. Extra windows share the device, pipelines and
+        // textures; all targets are drawn into one command buffer and presented by a single presentKHR.
+        // Adding and removing targets must not race drawFrame, call them from the render thread.
+        PresentationTarget& addWindow(const windowing::sdl::UfoxWindow& window);
+        void removeWindow(const PresentationTarget& target);
+        [[nodiscard]] PresentationTarget& getPrimaryTarget() { return *targets.front(); }
+        [[nodiscard]] size_t getTargetCount() const { return targets.size(); }
+
         void recreateSwapchain(const windowing::sdl::UfoxWindow& window);
         void drawFrame(const windowing::sdl::UfoxWindow& window);
+        // Extent overloads for threads that must not touch the SDL window, see EngineRuntime. Both act on the
+        // primary target, drawFrame still renders every target.
+        void recreateSwapchain(const vk::Extent2D& windowExtent);
+        void drawFrame(const vk::Extent2D& windowExtent);
         void waitForIdle() const;
 
         void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, Buffer& buffer);
@@ -124,42 +277,161 @@ namespace ufox::graphics::vulkan {
         void endSingleTimeCommands(const vk::raii::CommandBuffer& cmd) const;
         void transitionImageLayout(const Image& image,vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
         void copyBufferToImage(const Buffer &buffer, const Image &image) const;
-        [[nodiscard]] vk::Format findSupportedFormat(const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features) const;
+        [[nodiscard]] vk::Format findSupportedFormat(std::span<const vk::Format> candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features) const;
+
+        // Advances once per submitted drawFrame, before anything is recorded. Whatever a frame stopped using may be
+        // reused once the counter moved MAX_FRAMES_IN_FLIGHT past the value it read.
+        [[nodiscard]] uint64_t getFrameNumber() const { return frameNumber; }
+        // Scratch memory valid until this frame slot comes around again, per-frame containers should use it
+        [[nodiscard]] std::pmr::memory_resource* getFrameAllocator() { return &frameArenas->current(); }
+        // Heap allocations during the last drawFrame, 0 in steady state. Every global operator new in builds with
+        // UFOX_COUNT_ALLOCATIONS, only those through the engine allocators otherwise.
+        [[nodiscard]] uint64_t getFrameHeapAllocations() const { return frameHeapAllocations; }
+        // Every Buffer and Image allocation by category and heap, plus heap budgets
+        [[nodiscard]] const MemoryTracker& getMemoryTracker() const { return *memoryTracker; }
+        [[nodiscard]] TextureResidencyManager& getResidencyManager() { return *residency; }
+
+        // Phases of the constructor and the background startup jobs, up to the first presented frame
+        [[nodiscard]] const profiling::Timeline& getStartupTimeline() const { return startupTimeline; }
+
+        // Draws and bound-state changes recorded by the last drawFrame
+        [[nodiscard]] const renderer::gui::DrawStats& getDrawStats() const { return drawStats; }
+        // Frame phase timings and running totals of the render loop, see registerMetrics for the names.
+        // Subsystems register their own metrics here too, MetricsExporter dumps them periodically.
+        [[nodiscard]] profiling::MetricsRegistry& getMetrics() { return metrics; }
+        [[nodiscard]] const profiling::MetricsRegistry& getMetrics() const { return metrics; }
+        static constexpr uint32_t MAX_CLIP_REGIONS = 4096;
+        // Clip table of the next frame, usually ClipStack::getTable. Entry 0 must be NoClip; copied into the frame's
+        // buffer once its fence signaled, entries past MAX_CLIP_REGIONS are dropped and draw unclipped.
+        void setClipRegions(std::span<const ClipParams> regions);
+        // The clip table the GUI shaders read at binding 4, for helpers that allocate their own descriptor sets
+        [[nodiscard]] const Buffer& getClipBuffer(uint32_t frameIndex) const { return clipBuffers[frameIndex]; }
+        // device.updateDescriptorSets that feeds the descriptor update counter, GUI helpers write their sets here
+        void updateDescriptorSets(vk::ArrayProxy<const vk::WriteDescriptorSet> const& writes) const;
+
+        // Set when the device was created with UFOX_TRACE=<path>: resources, uploads, pipelines, descriptor writes and
+        // every frame's commands are logged for Tools/ufox_trace_replay.cpp. Capture cannot start later, the objects
+        // a frame uses are all created by the constructor.
+        [[nodiscard]] TraceWriter* getTrace() const { return trace.get(); }
+        // Flushes and closes the log, the device keeps running untraced. Call it from the render thread.
+        void stopTrace();
+
+        // Base key for the swapchain pass; widgets override shaders, layout, blend mode or specialization
+        [[nodiscard]] PipelineKey makePipelineKey() const;
+        // Changes whenever makePipelineKey would differ besides the primary target's color format, which callers compare
+        [[nodiscard]] uint64_t getPipelineKeyVersion() const { return guiPipelineKeyVersion; }
+        [[nodiscard]] PipelineCache& getPipelineCache() { return *pipelineCache; }
+        [[nodiscard]] PipelineLayoutCache& getLayoutCache() { return *layoutCache; }
+        [[nodiscard]] tools::shader::ShaderCompiler& getShaderCompiler() { return *shaderCompiler; }
+        [[nodiscard]] const vk::raii::Device& getDevice() const { return *device; }
+        [[nodiscard]] jobs::JobSystem& getJobSystem() { return *jobSystem; }
+        [[nodiscard]] bool supportsDrawIndirectCount() const { return useDrawIndirectCount; }
+        [[nodiscard]] bool supportsMultiDrawIndirect() const { return useMultiDrawIndirect; }
+        [[nodiscard]] bool supportsDrawIndirectFirstInstance() const { return useDrawIndirectFirstInstance; }
 
     private:
+        static constexpr size_t FRAME_ARENA_SIZE = 256 * 1024;
+
+        static constexpr uint64_t BUDGET_CHECK_INTERVAL = 30;
+        // Frames further apart than this count as a stall in the metrics
+        static constexpr double STALL_THRESHOLD_MS = 100.0;
+        // Sizes the descriptor pool, every target owns one set per frame in flight
+        static constexpr uint32_t MAX_PRESENTATION_TARGETS = 8;
+
+        struct TexturePixels {
+            vk::Format format{};
+            vk::Extent2D extent{};
+            std::vector<std::byte> storage{};
+            // Either storage or a span into the content pack mapping
+            std::span<const std::byte> pixels{};
+        };
+
+        // Outlives the job system, startup jobs record into it
+        profiling::Timeline startupTimeline{};
+        bool firstFramePresented{false};
+
+        // Registered once by registerMetrics, the render loop records through these without a lookup
+        struct FrameMetrics {
+            profiling::Histogram* frameMs{nullptr};
+            profiling::Histogram* cpuMs{nullptr};
+            profiling::Histogram* gpuMs{nullptr};
+            profiling::Histogram* fenceWaitMs{nullptr};
+            profiling::Histogram* acquireMs{nullptr};
+            profiling::Histogram* presentMs{nullptr};
+            profiling::Counter* frames{nullptr};
+            profiling::Counter* stalls{nullptr};
+            profiling::Counter* skipped{nullptr};
+            profiling::Counter* swapchainRecreations{nullptr};
+            profiling::Counter* draws{nullptr};
+            profiling::Counter* triangles{nullptr};
+            profiling::Counter* uploadBytes{nullptr};
+            profiling::Counter* heapAllocations{nullptr};
+            profiling::Counter* descriptorUpdates{nullptr};
+            profiling::Gauge* gpuMemoryBytes{nullptr};
+        };
+        profiling::MetricsRegistry metrics{};
+        FrameMetrics frameMetrics{};
+        // Outlives the job system, pipeline builds record into it
+        std::unique_ptr<TraceWriter> trace{};
+        // Start of the previous drawFrame that rendered, reset while rendering is disabled
+        std::optional<std::chrono::steady_clock::time_point> lastFrameStart{};
+        std::optional<jobs::JobSystem> jobSystem{};
+        std::optional<memory::FrameArenas> frameArenas{};
+        uint64_t frameHeapAllocations{0};
+        renderer::gui::DrawStats drawStats{};
+
         //Instance properties
         std::optional<vk::raii::Context> context{};
         std::optional<vk::raii::Instance> instance{};
-        std::optional<vk::raii::SurfaceKHR> surface{};
         std::optional <vk::raii::PhysicalDevice> physicalDevice{};
         std::optional <vk::raii::Device> device{};
+        // Declared before every Buffer and Image so their accounting handles never outlive it
+        std::optional<MemoryTracker> memoryTracker{};
+        std::optional<TextureResidencyManager> residency{};
         QueueFamilyIndices queueFamilyIndices{ std::nullopt, std::nullopt };
+        bool useDrawIndirectCount{false};
+        bool useMultiDrawIndirect{false};
+        bool useDrawIndirectFirstInstance{false};
         std::optional<vk::raii::Queue> graphicsQueue{};
         std::optional<vk::raii::Queue> presentQueue{};
         std::optional<vk::raii::CommandPool> commandPool{};
         std::vector<vk::raii::CommandBuffer> commandBuffers;
-        std::vector<vk::raii::Semaphore> imageAvailableSemaphores;
-        std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+        // Open between beginUploads and flushUploads, staging buffers stay alive until the batch completes
+        std::optional<vk::raii::CommandBuffer> uploadCommands{};
+        std::vector<Buffer> uploadStaging;
         std::vector<vk::raii::Fence> inFlightFences;
 
-        //Swapchain properties
-        std::optional<vk::raii::SwapchainKHR> swapchain{};
-        std::vector<vk::Image> swapchainImages;
-        std::vector<vk::raii::ImageView> swapchainImageViews;
-        vk::Format swapchainFormat{ vk::Format::eUndefined };
-        vk::PresentModeKHR presentMode{ vk::PresentModeKHR::eFifo};
-        vk::Extent2D swapchainExtent{ 0, 0 };
-
-        Image depthImage{};
 
-        std::optional<vk::raii::DescriptorSetLayout> descriptorSetLayout{};
-        std::optional<vk::raii::PipelineLayout> pipelineLayout{};
-        std::optional<vk::raii::Pipeline> graphicsPipeline{};
+        bool useDepth{false};
+        AntiAliasing antiAliasing{AntiAliasing::Analytic};
+        vk::SampleCountFlags supportedSampleCounts{vk::SampleCountFlagBits::e1};
+        bool multisampleLazilyAllocated{false};
+        std::optional<vk::raii::QueryPool> timestampQueryPool{};
+        float timestampPeriod{0.0f};
+        std::array<AntiAliasing, MAX_FRAMES_IN_FLIGHT> timestampModes{};
+        std::array<bool, MAX_FRAMES_IN_FLIGHT> timestampsWritten{};
+        std::array<float, ANTI_ALIASING_MODES.size()> gpuFrameMs{ -1.0f, -1.0f, -1.0f, -1.0f };
+
+        std::optional<tools::shader::ShaderCompiler> shaderCompiler{};
+        std::future<std::vector<std::string>> pendingShaderReload{};
+        std::optional<PipelineLayoutCache> layoutCache{};
+        const ShaderInterface* shaderInterface{nullptr};
+        vk::DescriptorSetLayout descriptorSetLayout{};
+        vk::PipelineLayout pipelineLayout{};
+        std::optional<PipelineCache> pipelineCache{};
+        PipelineKey guiPipelineKey{};
+        // Bumped whenever guiPipelineKey is rebuilt, tells targets their variant key is stale
+        uint64_t guiPipelineKeyVersion{0};
+        std::string guiFragmentShader{"shaders/shader.frag.spv"};
+        VertexLayout guiVertexLayout{VertexLayout::GuiPacked};
+        bool usePushConstantParams{false};
+        vk::Pipeline graphicsPipeline{};
         std::optional<vk::raii::DescriptorPool> descriptorPool{};
-        std::vector<vk::raii::DescriptorSet> descriptorSets;
+        // Primary window first. Declared after the pool since targets own descriptor sets allocated from it
+        std::vector<std::unique_ptr<PresentationTarget>> targets;
 
         uint32_t currentFrame{ 0 };
-        uint32_t currentImage{ 0 };
+        uint64_t frameNumber{ 0 };
 
 
 
@@ -167,29 +439,72 @@ namespace ufox::graphics::vulkan {
             0, 1, 2, 2, 3, 0,
         };
 
+        std::optional<assets::AssetPack> contentPack{};
+        // Bound in place of textureImage while it is loading or evicted
+        Image placeholderImage{};
         Image textureImage{};
+        std::future<TexturePixels> pendingTexture{};
+        // Set once the real texture replaced the startup placeholder
+        std::optional<TextureId> textureId{};
         std::optional<vk::raii::Sampler> textureSampler{};
         Buffer vertexBuffer{};
         Buffer indexBuffer{};
-        std::vector<Buffer> uniformBuffers;
-        std::vector<uint8_t *> uniformBuffersMapped;
         std::vector<Buffer> roundCornerBuffers;
         std::vector<uint8_t *> roundCornerBuffersMapped;
-
-        void createSwapchain(const windowing::sdl::UfoxWindow& window);
-        void createDepthImage();
+        RoundedRectParams roundedRectParams{
+            {18.0f, 18.0f, 18.0f, 18.0f},
+            {18.0f, 18.0f, 18.0f, 18.0f},
+            {1.0f, 0.0f, 1.0f, 1.0f},
+            {0.0f, 1.0f, 1.0f, 1.0f},
+            {1.0f, 1.0f, 0.0f, 1.0f},
+            {1.0f, 1.0f, 1.0f, 1.0f},
+        };
+        // Clip index of every vertex in vertexBuffer, read by shader.vert at binding 3
+        Buffer vertexClipBuffer{};
+        std::vector<Buffer> clipBuffers;
+        std::vector<ClipParams*> clipBuffersMapped;
+        std::vector<ClipParams> clipRegions{ NoClip };
+
+        void initPresentationTarget(PresentationTarget& target, const vk::Extent2D& windowExtent);
+        void createTargetResources(PresentationTarget& target);
+        void createSwapchain(PresentationTarget& target, const vk::Extent2D& windowExtent);
+        void recreateSwapchain(PresentationTarget& target, const vk::Extent2D& windowExtent);
+        bool acquireImage(PresentationTarget& target);
+        void recordTarget(const vk::raii::CommandBuffer& cmd, PresentationTarget& target);
+        void createDepthImage(PresentationTarget& target);
+        void allocateMemory(const vk::MemoryAllocateInfo& allocateInfo, MemoryCategory category,
+                            std::optional<vk::raii::DeviceMemory>& memory, MemoryAllocation& allocation);
+        void registerTextureResidency();
+        void updateTextureDescriptors();
+        void createColorImage(PresentationTarget& target);
+        void probeMultisampleMemory(vk::Format format);
+        void registerMetrics();
+        void traceDescriptorWrites(vk::ArrayProxy<const vk::WriteDescriptorSet> const& writes) const;
+        void traceBufferData(const Buffer& buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size) const;
+        void createTimestampQueries();
+        void readTimestamps();
         void createDescriptorSetLayout();
         void createGraphicsPipeline();
-        void createTextureImage();
-        void createTextureImageView();
+        [[nodiscard]] static TexturePixels PlaceholderTexture();
+        [[nodiscard]] TexturePixels loadTexturePixels() const;
+        void createTextureImage(const TexturePixels& texture, Image& image);
+        void finishTextureLoad();
+        void recordTransfer(const std::function<void(const vk::raii::CommandBuffer&)>& record) const;
+        void beginUploads();
+        void flushUploads();
+        void retireStaging(Buffer&& staging);
+        void createTextureImageView(Image& image);
+        [[nodiscard]] vk::ImageView getBoundTextureView() const;
         void createTextureSampler();
         void createVertexBuffer();
+        void createClipBuffers();
         void createIndexBuffer();
-        void createUniformBuffers();
+        void createUniformBuffers(PresentationTarget& target);
         void createRoundedCornerBuffer();
-        void updateUniformBuffer(uint32_t currentImage) const;
+        void updateUniformBuffer(const PresentationTarget& target, uint32_t frame) const;
         void createDescriptorPool();
-        void createDescriptorSets();
+        void createDescriptorSets(PresentationTarget& target);
+        void reloadChangedShaders();
     };
 
 }
@@ -0,0 +1,184 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_cull.hpp"
+
+namespace ufox::renderer::gui {
+    using graphics::vulkan::MAX_FRAMES_IN_FLIGHT;
+
+    GuiCullPass::GuiCullPass(graphics::vulkan::GraphicsDevice &gpu, uint32_t maxInstances) :
+        gpu{gpu}, maxInstances{std::max(maxInstances, 1u)}, useDrawIndirectCount{gpu.supportsDrawIndirectCount()},
+        useMultiDrawIndirect{gpu.supportsMultiDrawIndirect()}, useFirstInstance{gpu.supportsDrawIndirectFirstInstance()} {
+        createPipeline();
+        createBuffers();
+        createDescriptorSets();
+    }
+
+    uint32_t GuiCullPass::upload(uint32_t frameIndex, std::span<const CullInstance> instances) {
+        FrameResources& frame = frames[frameIndex];
+        frame.droppedCount = static_cast<uint32_t>(instances.size() - std::min<size_t>(instances.size(), maxInstances));
+        instances = instances.first(instances.size() - frame.droppedCount);
+        memcpy(frame.instancesMapped, instances.data(), instances.size_bytes());
+        frame.instanceCount = static_cast<uint32_t>(instances.size());
+        return frame.instanceCount;
+    }
+
+    void GuiCullPass::record(const vk::raii::CommandBuffer &cmd, uint32_t frameIndex, const vk::Rect2D &viewport) const {
+        const FrameResources& frame = frames[frameIndex];
+
+        cmd.fillBuffer(*frame.counters.data, 0, vk::WholeSize, 0);
+
+        vk::MemoryBarrier2 clearBarrier{};
+        clearBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                    .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                    .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                    .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+        cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(clearBarrier));
+
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, shaderInterface->pipelineLayout, 0, *descriptorSets[frameIndex], nullptr);
+
+        CullParams params{};
+        params.viewport = glm::vec4(viewport.offset.x, viewport.offset.y, viewport.extent.width, viewport.extent.height);
+        params.instanceCount = frame.instanceCount;
+
+        vk::MemoryBarrier2 passBarrier{};
+        passBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                   .setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+                   .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                   .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+
+        const vk::ShaderStageFlags stages = shaderInterface->pushConstantRanges.front().stageFlags;
+        uint32_t groupCount = std::max((frame.instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1u);
+        for (uint32_t pass = 0; pass < 3; ++pass) {
+            params.pass = pass;
+            cmd.pushConstants<CullParams>(shaderInterface->pipelineLayout, stages, 0, params);
+            cmd.dispatch(pass == 1 ? 1 : groupCount, 1, 1);
+            if (pass < 2) cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(passBarrier));
+        }
+
+        vk::MemoryBarrier2 drawBarrier{};
+        drawBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                   .setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+                   .setDstStageMask(vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eVertexShader |
+                                    vk::PipelineStageFlagBits2::eHost)
+                   .setDstAccessMask(vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eShaderStorageRead |
+                                     vk::AccessFlagBits2::eHostRead);
+        cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(drawBarrier));
+    }
+
+    void GuiCullPass::draw(const vk::raii::CommandBuffer &cmd, uint32_t frameIndex) const {
+        const FrameResources& frame = frames[frameIndex];
+        if (frame.instanceCount == 0) return;
+
+        constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+        if (useDrawIndirectCount) {
+            cmd.drawIndexedIndirectCount(*frame.commands.data, 0, *frame.counters.data, 0, frame.instanceCount, stride);
+        }
+        else if (useMultiDrawIndirect) {
+            // The scatter pass zeroes every slot past the survivors, so the full range is safe to draw
+            cmd.drawIndexedIndirect(*frame.commands.data, 0, frame.instanceCount, stride);
+        }
+        else {
+            // drawCount above 1 needs multiDrawIndirect, the empty tail slots still make every call safe
+            for (uint32_t i = 0; i < frame.instanceCount; ++i)
+                cmd.drawIndexedIndirect(*frame.commands.data, vk::DeviceSize{i} * stride, 1, stride);
+        }
+    }
+
+    CullStats GuiCullPass::readStats(uint32_t frameIndex) const {
+        const FrameResources& frame = frames[frameIndex];
+        CullStats stats{};
+        stats.submitted = frame.instanceCount;
+        stats.visible = frame.countersMapped[0];
+        stats.culled = frame.countersMapped[1];
+        stats.dropped = frame.droppedCount;
+        return stats;
+    }
+
+    void GuiCullPass::createPipeline() {
+        const std::string shader = "shaders/gui_cull.comp.spv";
+        shaderInterface = &gpu.getLayoutCache().get({ shader });
+        if (shaderInterface->pushConstantRanges.empty()) throw std::runtime_error("gui_cull.comp declares no push constants");
+
+        tools::shader::SpirvBinary code = gpu.getShaderCompiler().load(shader);
+        vk::raii::ShaderModule module(gpu.getDevice(), vk::ShaderModuleCreateInfo{ {}, code->size() * sizeof(uint32_t), code->data() });
+
+        // FIRST_INSTANCE, a VkBool32
+        const vk::Bool32 firstInstance = useFirstInstance ? VK_TRUE : VK_FALSE;
+        const vk::SpecializationMapEntry entry{ 0, 0, sizeof(vk::Bool32) };
+        const vk::SpecializationInfo specialization{ 1, &entry, sizeof(firstInstance), &firstInstance };
+
+        vk::ComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.setStage({ {}, vk::ShaderStageFlagBits::eCompute, *module, "main", &specialization })
+                    .setLayout(shaderInterface->pipelineLayout);
+        pipeline.emplace(gpu.getDevice(), nullptr, pipelineInfo);
+    }
+
+    void GuiCullPass::createBuffers() {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        const uint32_t maxGroups = (maxInstances + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+
+        frames.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& frame : frames) {
+            vk::DeviceSize instanceSize = sizeof(CullInstance) * maxInstances;
+            gpu.createBuffer(instanceSize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, frame.instances);
+            frame.instancesMapped = static_cast<CullInstance*>(frame.instances.memory->mapMemory(0, instanceSize));
+
+            gpu.createBuffer(sizeof(vk::DrawIndexedIndirectCommand) * maxInstances,
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, frame.commands);
+
+            // Host visible so the culled count can be read back once the frame's fence signals
+            gpu.createBuffer(sizeof(uint32_t) * 2,
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                hostVisible, frame.counters);
+            frame.countersMapped = static_cast<const uint32_t*>(frame.counters.memory->mapMemory(0, sizeof(uint32_t) * 2));
+
+            gpu.createBuffer(sizeof(uint32_t) * maxGroups, vk::BufferUsageFlagBits::eStorageBuffer,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, frame.groupOffsets);
+
+            gpu.createBuffer(sizeof(uint32_t) * maxInstances,
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, frame.drawInstances);
+        }
+    }
+
+    void GuiCullPass::createDescriptorSets() {
+        std::vector<vk::DescriptorPoolSize> poolSizes = shaderInterface->getPoolSizes(MAX_FRAMES_IN_FLIGHT);
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.setPoolSizes(poolSizes)
+                .setMaxSets(MAX_FRAMES_IN_FLIGHT)
+                .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+        descriptorPool.emplace(gpu.getDevice(), poolInfo);
+
+        std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, shaderInterface->setLayouts.front());
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.setDescriptorPool(*descriptorPool)
+                 .setSetLayouts(layouts);
+        descriptorSets = gpu.getDevice().allocateDescriptorSets(allocInfo);
+
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+            const FrameResources& frame = frames[i];
+            std::array bufferInfos = {
+                vk::DescriptorBufferInfo{ *frame.instances.data, 0, vk::WholeSize },
+                vk::DescriptorBufferInfo{ *frame.commands.data, 0, vk::WholeSize },
+                vk::DescriptorBufferInfo{ *frame.counters.data, 0, vk::WholeSize },
+                vk::DescriptorBufferInfo{ *frame.groupOffsets.data, 0, vk::WholeSize },
+                vk::DescriptorBufferInfo{ *frame.drawInstances.data, 0, vk::WholeSize },
+            };
+
+            std::array<vk::WriteDescriptorSet, 5> writes{};
+            for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+                writes[binding].setDstSet(*descriptorSets[i])
+                               .setDstBinding(binding)
+                               .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                               .setDescriptorCount(1)
+                               .setPBufferInfo(&bufferInfos[binding]);
+            }
+            gpu.updateDescriptorSets(writes);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <span>
+#include <glm/glm.hpp>
+#include <Engine/ufox_graphic.hpp>
+
+namespace ufox::renderer::gui {
+
+    // Mirrors GuiInstance in Shaders/gui_cull.comp (std430)
+    struct CullInstance {
+        glm::vec4 rect;         // x, y, width, height in pixels
+        glm::vec4 clip;         // x, y, width, height in pixels
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        int32_t vertexOffset;
+        uint32_t padding;
+    };
+
+    static_assert(sizeof(CullInstance) == 48, "CullInstance must match the std430 layout in gui_cull.comp");
+
+    struct CullStats {
+        uint32_t submitted{0};
+        uint32_t visible{0};
+        uint32_t culled{0};
+        // Instances past maxInstances that upload had to leave out
+        uint32_t dropped{0};
+    };
+
+    // Culls GUI instances on the GPU and draws the survivors with drawIndexedIndirectCount, so a scroll view with
+    // thousands of children costs the CPU one memcpy and a handful of commands per frame.
+    class GuiCullPass {
+    public:
+        GuiCullPass(graphics::vulkan::GraphicsDevice& gpu, uint32_t maxInstances);
+
+        // Instances for frameIndex, the frame's fence must have signaled. Returns how many were taken, anything past
+        // maxInstances is left out and counted in CullStats::dropped.
+        uint32_t upload(uint32_t frameIndex, std::span<const CullInstance> instances);
+        // Records the culling dispatches, call outside dynamic rendering
+        void record(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, const vk::Rect2D& viewport) const;
+        // Draws the survivors with whatever pipeline and index buffer the caller has bound
+        void draw(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex) const;
+        // Results of the last submission of frameIndex, valid after its fence signaled
+        [[nodiscard]] CullStats readStats(uint32_t frameIndex) const;
+
+        [[nodiscard]] const graphics::vulkan::Buffer& getInstanceBuffer(uint32_t frameIndex) const { return frames[frameIndex].instances; }
+        // The compacted VkDrawIndexedIndirectCommands, a transfer source so tests can read them back. firstInstance is
+        // the instance index only where the device supports drawIndirectFirstInstance, 0 otherwise.
+        [[nodiscard]] const graphics::vulkan::Buffer& getCommandBuffer(uint32_t frameIndex) const { return frames[frameIndex].commands; }
+        // Instance index of every compacted command. Vertex shaders without firstInstance read it with gl_DrawID, which
+        // counts slots under drawIndirectCount and multiDrawIndirect but restarts at 0 in the one-call-per-slot fallback.
+        [[nodiscard]] const graphics::vulkan::Buffer& getDrawInstanceBuffer(uint32_t frameIndex) const { return frames[frameIndex].drawInstances; }
+        [[nodiscard]] bool writesFirstInstance() const { return useFirstInstance; }
+
+    private:
+        static constexpr uint32_t WORKGROUP_SIZE = 256;
+
+        struct CullParams {
+            glm::vec4 viewport;
+            uint32_t instanceCount;
+            uint32_t pass;
+        };
+
+        struct FrameResources {
+            graphics::vulkan::Buffer instances{};
+            CullInstance* instancesMapped{nullptr};
+            graphics::vulkan::Buffer commands{};
+            graphics::vulkan::Buffer counters{};
+            const uint32_t* countersMapped{nullptr};
+            graphics::vulkan::Buffer groupOffsets{};
+            graphics::vulkan::Buffer drawInstances{};
+            uint32_t instanceCount{0};
+            uint32_t droppedCount{0};
+        };
+
+        graphics::vulkan::GraphicsDevice& gpu;
+        uint32_t maxInstances;
+        bool useDrawIndirectCount;
+        bool useMultiDrawIndirect;
+        bool useFirstInstance;
+        const graphics::vulkan::ShaderInterface* shaderInterface{nullptr};
+        std::optional<vk::raii::Pipeline> pipeline{};
+        std::optional<vk::raii::DescriptorPool> descriptorPool{};
+        std::vector<vk::raii::DescriptorSet> descriptorSets;
+        std::vector<FrameResources> frames;
+
+        void createPipeline();
+        void createBuffers();
+        void createDescriptorSets();
+    };
+}
@@ -0,0 +1,188 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_draw_list.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ufox::renderer::gui {
+    namespace {
+        constexpr uint32_t LAYER_SHIFT = 56;
+        constexpr uint32_t TRANSPARENT_SHIFT = 55;
+        constexpr uint32_t PIPELINE_SHIFT = 39;
+        constexpr uint32_t TEXTURE_SHIFT = 23;
+        constexpr uint32_t SEQUENCE_SHIFT = 23;
+        constexpr uint64_t ID_MASK = 0xFFFF;
+        constexpr uint64_t DEPTH_MASK = (1ull << 23) - 1;
+
+        template<typename T>
+        uint64_t FindOrAddId(std::pmr::vector<T>& ids, T handle) {
+            auto it = std::ranges::find(ids, handle);
+            if (it != ids.end()) return static_cast<uint64_t>(it - ids.begin());
+            ids.push_back(handle);
+            return ids.size() - 1;
+        }
+    }
+
+    DrawList::DrawList(std::pmr::memory_resource *resource, bool depthTested) :
+        entries{resource}, pushData{resource}, pipelineIds{resource}, textureIds{resource}, depthTested{depthTested} {}
+
+    void DrawList::add(const DrawCommand &command, std::span<const std::byte> pushConstants) {
+        if (command.indexCount == 0) return;
+
+        Entry entry{};
+        entry.sequence = submitted++;
+        entry.key = makeKey(command, entry.sequence);
+        entry.command = command;
+        entry.pushOffset = static_cast<uint32_t>(pushData.size());
+        entry.pushSize = static_cast<uint32_t>(pushConstants.size());
+        pushData.insert(pushData.end(), pushConstants.begin(), pushConstants.end());
+        entries.push_back(entry);
+        compiled = false;
+    }
+
+    uint64_t DrawList::makeKey(const DrawCommand &command, uint32_t sequence) {
+        uint64_t key = static_cast<uint64_t>(command.layer) << LAYER_SHIFT;
+
+        if (!depthTested) {
+            // Nothing resolves overlap but draw order, opaque draws must not jump ahead of what they cover
+            return key | static_cast<uint64_t>(sequence) << SEQUENCE_SHIFT;
+        }
+
+        if (command.transparent) {
+            // Submission order is the only order that keeps blending correct
+            return key | 1ull << TRANSPARENT_SHIFT | static_cast<uint64_t>(sequence) << SEQUENCE_SHIFT;
+        }
+
+        uint64_t pipelineId = FindOrAddId(pipelineIds, command.pipeline) & ID_MASK;
+        uint64_t textureId = FindOrAddId(textureIds, command.descriptorSet) & ID_MASK;
+        uint64_t depth = static_cast<uint64_t>(std::clamp(command.depth, 0.0f, 1.0f) * static_cast<float>(DEPTH_MASK)) & DEPTH_MASK;
+        return key | pipelineId << PIPELINE_SHIFT | textureId << TEXTURE_SHIFT | depth;
+    }
+
+    bool DrawList::canMerge(const Entry &a, const Entry &b) const {
+        const DrawCommand& x = a.command;
+        const DrawCommand& y = b.command;
+        if (x.pipeline != y.pipeline || x.layout != y.layout || x.descriptorSet != y.descriptorSet) return false;
+        if (x.vertexBuffer != y.vertexBuffer || x.indexBuffer != y.indexBuffer || x.indexType != y.indexType) return false;
+        if (x.scissor != y.scissor || x.vertexOffset != y.vertexOffset || x.layer != y.layer) return false;
+        if (x.firstIndex + x.indexCount != y.firstIndex) return false;
+
+        std::span<const std::byte> pushA = getPushConstants(a);
+        std::span<const std::byte> pushB = getPushConstants(b);
+        return pushA.size() == pushB.size() && std::memcmp(pushA.data(), pushB.data(), pushA.size()) == 0;
+    }
+
+    std::span<const std::byte> DrawList::getPushConstants(const Entry &entry) const {
+        return std::span{ pushData }.subspan(entry.pushOffset, entry.pushSize);
+    }
+
+    void DrawList::compile() {
+        if (compiled) return;
+
+        // Sequence breaks ties so equal opaque keys keep a deterministic order without a stable sort's buffer
+        std::ranges::sort(entries, [](const Entry& a, const Entry& b) {
+            return a.key != b.key ? a.key < b.key : a.sequence < b.sequence;
+        });
+
+        size_t write = 0;
+        for (size_t read = 0; read < entries.size(); ++read) {
+            if (write > 0 && canMerge(entries[write - 1], entries[read])) {
+                entries[write - 1].command.indexCount += entries[read].command.indexCount;
+                continue;
+            }
+            entries[write++] = entries[read];
+        }
+        entries.resize(write);
+        compiled = true;
+    }
+
+    void DrawList::record(const vk::raii::CommandBuffer &cmd, const vk::Viewport &viewport, DrawStats &stats,
+                          graphics::vulkan::TraceWriter *trace) const {
+        using namespace graphics::vulkan;
+
+        stats.submitted += submitted;
+        if (entries.empty()) return;
+
+        // Dynamic state every GUI pipeline declares, it survives pipeline binds so it is set once per pass
+        cmd.setViewport(0, viewport);
+        if (trace) trace->record(TraceSetViewport{ viewport.x, viewport.y, viewport.width, viewport.height, viewport.minDepth, viewport.maxDepth });
+        cmd.setCullMode(vk::CullModeFlagBits::eNone);
+        cmd.setFrontFace(vk::FrontFace::eClockwise);
+        cmd.setPrimitiveTopology(vk::PrimitiveTopology::eTriangleList);
+
+        vk::Pipeline pipeline{};
+        vk::PipelineLayout layout{};
+        vk::DescriptorSet descriptorSet{};
+        vk::Buffer vertexBuffer{};
+        vk::Buffer indexBuffer{};
+        vk::IndexType indexType{};
+        vk::Rect2D scissor{};
+        bool hasScissor = false;
+        std::span<const std::byte> pushConstants{};
+        bool hasPushConstants = false;
+
+        for (const Entry& entry : entries) {
+            const DrawCommand& draw = entry.command;
+
+            if (draw.pipeline != pipeline) {
+                cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, draw.pipeline);
+                pipeline = draw.pipeline;
+                ++stats.pipelineBinds;
+                if (trace) trace->record(TraceBindPipeline{ TraceId(draw.pipeline) });
+            }
+
+            // Sets and push constants bound through another layout may be disturbed, rebind after a layout change
+            bool layoutChanged = draw.layout != layout;
+            layout = draw.layout;
+
+            if (draw.descriptorSet && (layoutChanged || draw.descriptorSet != descriptorSet)) {
+                cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, draw.layout, 0, draw.descriptorSet, nullptr);
+                descriptorSet = draw.descriptorSet;
+                ++stats.descriptorSetBinds;
+                if (trace) trace->record(TraceBindDescriptorSet{ TraceId(draw.descriptorSet) });
+            }
+
+            if (draw.vertexBuffer != vertexBuffer) {
+                cmd.bindVertexBuffers(0, draw.vertexBuffer, vk::DeviceSize{0});
+                vertexBuffer = draw.vertexBuffer;
+                ++stats.vertexBufferBinds;
+                if (trace) trace->record(TraceBindVertexBuffer{ TraceId(draw.vertexBuffer) });
+            }
+
+            if (draw.indexBuffer != indexBuffer || draw.indexType != indexType) {
+                cmd.bindIndexBuffer(draw.indexBuffer, 0, draw.indexType);
+                indexBuffer = draw.indexBuffer;
+                indexType = draw.indexType;
+                ++stats.indexBufferBinds;
+                if (trace) trace->record(TraceBindIndexBuffer{ TraceId(draw.indexBuffer), static_cast<uint32_t>(draw.indexType) });
+            }
+
+            if (!hasScissor || draw.scissor != scissor) {
+                cmd.setScissor(0, draw.scissor);
+                scissor = draw.scissor;
+                hasScissor = true;
+                ++stats.scissorChanges;
+                if (trace) trace->record(TraceSetScissor{ draw.scissor.offset.x, draw.scissor.offset.y, draw.scissor.extent.width, draw.scissor.extent.height });
+            }
+
+            std::span<const std::byte> push = getPushConstants(entry);
+            if (!push.empty() && (layoutChanged || !hasPushConstants || push.size() != pushConstants.size() ||
+                                  std::memcmp(push.data(), pushConstants.data(), push.size()) != 0)) {
+                cmd.pushConstants<std::byte>(draw.layout, draw.pushConstantStages, 0, push);
+                pushConstants = push;
+                hasPushConstants = true;
+                ++stats.pushConstantUpdates;
+                if (trace) trace->record(TracePushConstants{ static_cast<uint32_t>(draw.pushConstantStages), static_cast<uint32_t>(push.size()) }, push);
+            }
+
+            cmd.drawIndexed(draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+            if (trace) trace->record(TraceDrawIndexed{ draw.indexCount, draw.firstIndex, draw.vertexOffset });
+            ++stats.draws;
+            stats.triangles += draw.indexCount / 3;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+#include "Engine/ufox_trace.hpp"
+
+namespace ufox::renderer::gui {
+
+    struct DrawCommand {
+        vk::Pipeline pipeline{};
+        vk::PipelineLayout layout{};
+        vk::DescriptorSet descriptorSet{};          // texture / material set bound at set 0
+        vk::Buffer vertexBuffer{};
+        vk::Buffer indexBuffer{};
+        vk::IndexType indexType{vk::IndexType::eUint16};
+        vk::ShaderStageFlags pushConstantStages{};
+        vk::Rect2D scissor{};
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        int32_t vertexOffset{0};
+        uint8_t layer{0};                           // drawn in ascending order
+        float depth{0.0f};                          // 0 near .. 1 far, orders opaque draws front to back
+        bool transparent{true};                     // GUI blends by default, kept in submission order
+    };
+
+    struct DrawStats {
+        uint32_t submitted{0};
+        uint32_t draws{0};
+        uint32_t triangles{0};
+        uint32_t pipelineBinds{0};
+        uint32_t descriptorSetBinds{0};
+        uint32_t vertexBufferBinds{0};
+        uint32_t indexBufferBinds{0};
+        uint32_t scissorChanges{0};
+        uint32_t pushConstantUpdates{0};
+
+        [[nodiscard]] uint32_t getStateChanges() const {
+            return pipelineBinds + descriptorSetBinds + vertexBufferBinds + indexBufferBinds + scissorChanges + pushConstantUpdates;
+        }
+    };
+
+    // Collects the frame's draws, orders them by a 64-bit key and records them with only the state that differs
+    // from the previous draw. Key layout, most significant first:
+    //   layer:8 | transparent:1 | opaque: pipeline:16 texture:16 depth:23 | transparent: submission:32 pad:23
+    // Opaque draws group by pipeline and texture only when the pass tests and writes depth, the depth buffer then
+    // resolves overlap. Without it every draw keeps painter's order within its layer: layer:8 | pad:1 | submission:32.
+    // Storage comes from the memory resource handed in, normally the frame arena.
+    class DrawList {
+    public:
+        explicit DrawList(std::pmr::memory_resource* resource = std::pmr::get_default_resource(), bool depthTested = false);
+
+        void add(const DrawCommand& command, std::span<const std::byte> pushConstants = {});
+        template<typename T>
+        void add(const DrawCommand& command, const T& pushConstants) {
+            add(command, std::as_bytes(std::span{ &pushConstants, 1 }));
+        }
+
+        // Sorts and merges adjacent draws that share every piece of state and continue each other's index range
+        void compile();
+        // Sets the dynamic state shared by all GUI pipelines once, then replays the compiled list. Every command
+        // recorded is mirrored into trace when one is given.
+        void record(const vk::raii::CommandBuffer& cmd, const vk::Viewport& viewport, DrawStats& stats,
+                    graphics::vulkan::TraceWriter* trace = nullptr) const;
+
+        [[nodiscard]] size_t size() const { return entries.size(); }
+        // In recorded order once compile() ran
+        [[nodiscard]] const DrawCommand& getCommand(size_t index) const { return entries[index].command; }
+        [[nodiscard]] bool empty() const { return entries.empty(); }
+
+    private:
+        struct Entry {
+            uint64_t key;
+            uint32_t sequence;
+            DrawCommand command;
+            uint32_t pushOffset;
+            uint32_t pushSize;
+        };
+
+        std::pmr::vector<Entry> entries;
+        std::pmr::vector<std::byte> pushData;
+        std::pmr::vector<vk::Pipeline> pipelineIds;
+        std::pmr::vector<vk::DescriptorSet> textureIds;
+        uint32_t submitted{0};
+        bool depthTested{false};
+        bool compiled{false};
+
+        [[nodiscard]] uint64_t makeKey(const DrawCommand& command, uint32_t sequence);
+        [[nodiscard]] bool canMerge(const Entry& a, const Entry& b) const;
+        [[nodiscard]] std::span<const std::byte> getPushConstants(const Entry& entry) const;
+    };
+}
@@ -0,0 +1,348 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_effects.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ufox::renderer::gui {
+    using graphics::vulkan::MAX_FRAMES_IN_FLIGHT;
+
+    namespace {
+        // Three sigma hold everything but 0.3% of a Gaussian
+        constexpr float SHADOW_EXTENT_SIGMAS = 3.0f;
+
+        vk::Extent2D LevelExtent(const vk::Extent2D& source, uint32_t level) {
+            return { std::max(source.width >> level, 1u), std::max(source.height >> level, 1u) };
+        }
+
+        void ImageBarrier(const vk::raii::CommandBuffer& cmd, vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                          vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
+                          vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage) {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.setImage(image)
+                   .setOldLayout(oldLayout)
+                   .setNewLayout(newLayout)
+                   .setSrcStageMask(srcStage)
+                   .setDstStageMask(dstStage)
+                   .setSrcAccessMask(srcAccess)
+                   .setDstAccessMask(dstAccess)
+                   .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                   .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                   .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
+            cmd.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barrier));
+        }
+    }
+
+    EffectsRenderer::EffectsRenderer(graphics::vulkan::GraphicsDevice &gpu, graphics::vulkan::RenderTargetPool &pool, uint32_t maxEffects) :
+        gpu{gpu}, pool{pool}, maxEffects{std::max(maxEffects, 1u)} {
+        createPipelines();
+        createBuffers();
+        createDescriptorSets();
+    }
+
+    uint32_t EffectsRenderer::GetBlurLevels(float radius) {
+        // A chain of depth n blurs about 2^(n + 1) pixels at full resolution
+        const float levels = std::ceil(std::log2(std::max(radius, 1.0f) * 0.5f));
+        return static_cast<uint32_t>(std::clamp(levels, 1.0f, static_cast<float>(MAX_BLUR_LEVELS)));
+    }
+
+    void EffectsRenderer::beginFrame(uint32_t frameIndex) {
+        this->frameIndex = frameIndex;
+        effectCount = 0;
+        backdropBlocks.clear();
+        levelRadius.fill(0.0f);
+        stats = {};
+    }
+
+    bool EffectsRenderer::dropShadow(DrawList &drawList, const Rect &rect, glm::vec4 cornerRadius, const DropShadow &shadow,
+                                     const vk::Rect2D &scissor, const vk::Extent2D &framebuffer, uint8_t layer) {
+        const float sigma = std::max(shadow.blurRadius, 0.0f) * 0.5f;
+        const glm::vec2 halfSize = glm::max(rect.size * 0.5f + shadow.spread, glm::vec2(0.0f));
+        if (halfSize.x <= 0.0f || halfSize.y <= 0.0f || shadow.color.a <= 0.0f) return true;
+
+        vk::Pipeline pipeline = gpu.getPipelineCache().request(shadowKey);
+        if (!pipeline) return false;
+
+        const glm::vec2 center = rect.position + rect.size * 0.5f + shadow.offset;
+        const glm::vec2 halfExtent = halfSize + sigma * SHADOW_EXTENT_SIGMAS + 1.0f;
+        auto block = addQuad(drawList, pipeline, *shadowInterface, *shadowSets[frameIndex], center, halfExtent, shadow.color,
+                             scissor, framebuffer, layer);
+        if (!block) return false;
+
+        glm::vec4* data = frames[frameIndex].effectsMapped + *block;
+        data[0] = glm::vec4(halfSize, sigma, 0.0f);
+        data[1] = glm::max(cornerRadius + shadow.spread, glm::vec4(0.0f));
+        ++stats.shadows;
+        return true;
+    }
+
+    bool EffectsRenderer::backdrop(DrawList &drawList, const Rect &rect, glm::vec4 cornerRadius, const BackdropFilter &filter,
+                                   const vk::Rect2D &scissor, const vk::Extent2D &framebuffer, uint8_t layer) {
+        const glm::vec2 halfSize = rect.size * 0.5f;
+        if (halfSize.x <= 0.0f || halfSize.y <= 0.0f) return true;
+
+        vk::Pipeline pipeline = gpu.getPipelineCache().request(backdropKey);
+        if (!pipeline) return false;
+
+        const uint32_t depth = GetBlurLevels(filter.blurRadius);
+        auto block = addQuad(drawList, pipeline, *backdropInterface, *backdropSets[frameIndex * MAX_BLUR_LEVELS + depth - 1],
+                             rect.position + halfSize, halfSize + 1.0f, filter.tint, scissor, framebuffer, layer);
+        if (!block) return false;
+
+        glm::vec4* data = frames[frameIndex].effectsMapped + *block;
+        data[0] = glm::vec4(halfSize, 0.0f, 0.0f);
+        data[1] = cornerRadius;
+        backdropBlocks.push_back(*block);
+        levelRadius[depth - 1] = std::max(levelRadius[depth - 1], filter.blurRadius);
+        ++stats.backdrops;
+        return true;
+    }
+
+    std::optional<uint32_t> EffectsRenderer::addQuad(DrawList &drawList, vk::Pipeline pipeline, const graphics::vulkan::ShaderInterface &shaderInterface,
+                                                     vk::DescriptorSet descriptorSet, glm::vec2 center, glm::vec2 halfExtent, glm::vec4 color,
+                                                     const vk::Rect2D &scissor, const vk::Extent2D &framebuffer, uint8_t layer) {
+        if (effectCount >= maxEffects) return std::nullopt;
+        const uint32_t index = effectCount++;
+        const uint32_t block = index * EFFECT_BLOCK;
+
+        uint8_t rgba[4];
+        for (int c = 0; c < 4; ++c) rgba[c] = static_cast<uint8_t>(std::round(std::clamp(color[c], 0.0f, 1.0f) * 255.0f));
+
+        const glm::vec2 corners[4] = { -halfExtent, { halfExtent.x, -halfExtent.y }, halfExtent, { -halfExtent.x, halfExtent.y } };
+        PathVertex* vertices = frames[frameIndex].verticesMapped + index * 4;
+        for (int i = 0; i < 4; ++i) {
+            const glm::vec2 position = center + corners[i];
+            vertices[i] = PathVertex{ { position.x, position.y }, { rgba[0], rgba[1], rgba[2], rgba[3] },
+                                      { corners[i].x, corners[i].y }, block };
+        }
+
+        // Consecutive effects of one kind continue each other's index range and merge into one draw
+        DrawCommand draw{};
+        draw.pipeline = pipeline;
+        draw.layout = shaderInterface.pipelineLayout;
+        draw.descriptorSet = descriptorSet;
+        draw.vertexBuffer = *frames[frameIndex].vertices.data;
+        draw.indexBuffer = *indices.data;
+        draw.indexType = vk::IndexType::eUint32;
+        draw.pushConstantStages = shaderInterface.pushConstantRanges.front().stageFlags;
+        draw.scissor = scissor;
+        draw.firstIndex = index * 6;
+        draw.indexCount = 6;
+        draw.layer = layer;
+
+        const PassConstants constants{ glm::vec2(1.0f / static_cast<float>(framebuffer.width), 1.0f / static_cast<float>(framebuffer.height)) };
+        drawList.add(draw, constants);
+        return block;
+    }
+
+    void EffectsRenderer::record(const vk::raii::CommandBuffer &cmd, const graphics::vulkan::Image &source, glm::vec2 origin) {
+        if (backdropBlocks.empty()) return;
+
+        const glm::vec4 placement(origin, 1.0f / static_cast<float>(source.extent.width), 1.0f / static_cast<float>(source.extent.height));
+        for (uint32_t block : backdropBlocks) frames[frameIndex].effectsMapped[block + 2] = placement;
+
+        uint32_t maxDepth = 0;
+        for (uint32_t depth = 1; depth <= MAX_BLUR_LEVELS; ++depth) {
+            if (levelRadius[depth - 1] > 0.0f) maxDepth = depth;
+        }
+        if (maxDepth == 0) maxDepth = 1;
+
+        // Whatever rendered the source must be done before the first pass samples it
+        vk::MemoryBarrier2 sourceBarrier{};
+        sourceBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput | vk::PipelineStageFlagBits2::eComputeShader)
+                     .setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eShaderStorageWrite)
+                     .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                     .setDstAccessMask(vk::AccessFlagBits2::eShaderSampledRead);
+        cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(sourceBarrier));
+
+        cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *blurPipeline);
+        const vk::ShaderStageFlags pushStages = blurInterface->pushConstantRanges.front().stageFlags;
+        uint32_t passIndex = 0;
+
+        std::vector<graphics::vulkan::RenderTarget> targets;
+        auto dispatch = [&](vk::ImageView input, const graphics::vulkan::RenderTarget& output, float offset, bool upsample) {
+            const graphics::vulkan::Image& image = *output.image;
+            ImageBarrier(cmd, *image.data, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral,
+                vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eShaderStorageWrite,
+                vk::PipelineStageFlagBits2::eComputeShader, vk::PipelineStageFlagBits2::eComputeShader);
+
+            const vk::DescriptorSet descriptorSet = *blurSets[frameIndex * MAX_BLUR_PASSES + passIndex++];
+            vk::DescriptorImageInfo inputInfo{ **sampler, input, vk::ImageLayout::eShaderReadOnlyOptimal };
+            vk::DescriptorImageInfo outputInfo{ {}, *image.view, vk::ImageLayout::eGeneral };
+            std::array<vk::WriteDescriptorSet, 2> writes{};
+            writes[0].setDstSet(descriptorSet).setDstBinding(0)
+                     .setDescriptorType(vk::DescriptorType::eCombinedImageSampler).setDescriptorCount(1).setPImageInfo(&inputInfo);
+            writes[1].setDstSet(descriptorSet).setDstBinding(1)
+                     .setDescriptorType(vk::DescriptorType::eStorageImage).setDescriptorCount(1).setPImageInfo(&outputInfo);
+            gpu.updateDescriptorSets(writes);
+
+            const BlurPass pass{ glm::vec2(0.5f / static_cast<float>(image.extent.width), 0.5f / static_cast<float>(image.extent.height)),
+                                 offset, upsample ? 1u : 0u };
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, blurInterface->pipelineLayout, 0, descriptorSet, nullptr);
+            cmd.pushConstants<BlurPass>(blurInterface->pipelineLayout, pushStages, 0, pass);
+            cmd.dispatch((image.extent.width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, (image.extent.height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+
+            ImageBarrier(cmd, *image.data, vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::AccessFlagBits2::eShaderStorageWrite, vk::AccessFlagBits2::eShaderSampledRead,
+                vk::PipelineStageFlagBits2::eComputeShader, vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eFragmentShader);
+        };
+
+        auto acquire = [&](uint32_t level) -> graphics::vulkan::RenderTarget& {
+            return targets.emplace_back(pool.acquire({ BLUR_FORMAT, LevelExtent(source.extent, level),
+                vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled }));
+        };
+
+        // Shared downsampling chain, deep enough for the widest blur of the frame
+        targets.reserve(MAX_BLUR_PASSES);
+        std::array<vk::ImageView, MAX_BLUR_LEVELS + 1> down{};
+        down[0] = *source.view;
+        for (uint32_t level = 1; level <= maxDepth; ++level) {
+            const graphics::vulkan::RenderTarget& target = acquire(level);
+            dispatch(down[level - 1], target, 1.0f, false);
+            down[level] = *target.image->view;
+        }
+
+        // One upsampling chain per depth in use, back to half resolution. The offset scales the kernel between
+        // the radii two depths cover.
+        for (uint32_t depth = 1; depth <= MAX_BLUR_LEVELS; ++depth) {
+            const float radius = levelRadius[depth - 1];
+            if (radius <= 0.0f) continue;
+            const float offset = std::clamp(radius / static_cast<float>(2u << depth), 0.5f, 2.0f);
+
+            vk::ImageView result = down[depth];
+            for (uint32_t level = depth - 1; level >= 1; --level) {
+                const graphics::vulkan::RenderTarget& target = acquire(level);
+                dispatch(result, target, offset, true);
+                result = *target.image->view;
+            }
+
+            vk::DescriptorImageInfo imageInfo{ **sampler, result, vk::ImageLayout::eShaderReadOnlyOptimal };
+            vk::WriteDescriptorSet write{};
+            write.setDstSet(*backdropSets[frameIndex * MAX_BLUR_LEVELS + depth - 1])
+                 .setDstBinding(1)
+                 .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                 .setDescriptorCount(1)
+                 .setPImageInfo(&imageInfo);
+            gpu.updateDescriptorSets(write);
+        }
+
+        // Back to the pool right away, it hands them out again only after the frames in flight are done
+        for (auto& target : targets) pool.release(std::move(target));
+        stats.blurPasses = passIndex;
+    }
+
+    void EffectsRenderer::createPipelines() {
+        const std::string blurShader = "shaders/blur.comp.spv";
+        blurInterface = &gpu.getLayoutCache().get({ blurShader });
+        if (blurInterface->pushConstantRanges.empty()) throw std::runtime_error("blur.comp declares no push constants");
+
+        tools::shader::SpirvBinary code = gpu.getShaderCompiler().load(blurShader);
+        vk::raii::ShaderModule module(gpu.getDevice(), vk::ShaderModuleCreateInfo{ {}, code->size() * sizeof(uint32_t), code->data() });
+
+        vk::ComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.setStage({ {}, vk::ShaderStageFlagBits::eCompute, *module, "main" })
+                    .setLayout(blurInterface->pipelineLayout);
+        blurPipeline.emplace(gpu.getDevice(), nullptr, pipelineInfo);
+
+        // Both effects reuse the bounding-quad vertex shader and vertex layout of PathRenderer
+        auto makeKey = [&](const std::string& fragmentShader, const graphics::vulkan::ShaderInterface*& shaderInterface) {
+            shaderInterface = &gpu.getLayoutCache().get({ "shaders/path.vert.spv", fragmentShader });
+            if (shaderInterface->pushConstantRanges.empty()) throw std::runtime_error("path.vert declares no push constants");
+
+            graphics::vulkan::PipelineKey key = gpu.makePipelineKey();
+            key.vertexShader = "shaders/path.vert.spv";
+            key.fragmentShader = fragmentShader;
+            key.vertexLayout = graphics::vulkan::VertexLayout::Path;
+            key.layout = shaderInterface->pipelineLayout;
+            key.specialization.clear();
+            gpu.getPipelineCache().prewarm(key);
+            return key;
+        };
+        shadowKey = makeKey("shaders/shadow.frag.spv", shadowInterface);
+        backdropKey = makeKey("shaders/backdrop.frag.spv", backdropInterface);
+
+        vk::SamplerCreateInfo samplerInfo{};
+        samplerInfo.setMagFilter(vk::Filter::eLinear)
+                   .setMinFilter(vk::Filter::eLinear)
+                   .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+                   .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+                   .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+                   .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+                   .setMaxLod(0.0f);
+        sampler.emplace(gpu.getDevice(), samplerInfo);
+    }
+
+    void EffectsRenderer::createBuffers() {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        const vk::DeviceSize indexSize = sizeof(uint32_t) * 6 * maxEffects;
+        gpu.createBuffer(indexSize, vk::BufferUsageFlagBits::eIndexBuffer, hostVisible, indices);
+        auto* indexData = static_cast<uint32_t*>(indices.memory->mapMemory(0, indexSize));
+        for (uint32_t quad = 0; quad < maxEffects; ++quad) {
+            const uint32_t base = quad * 4;
+            const uint32_t pattern[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+            std::copy_n(pattern, 6, indexData + quad * 6);
+        }
+        indices.memory->unmapMemory();
+
+        frames.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& frame : frames) {
+            const vk::DeviceSize vertexSize = sizeof(PathVertex) * 4 * maxEffects;
+            gpu.createBuffer(vertexSize, vk::BufferUsageFlagBits::eVertexBuffer, hostVisible, frame.vertices);
+            frame.verticesMapped = static_cast<PathVertex*>(frame.vertices.memory->mapMemory(0, vertexSize));
+
+            const vk::DeviceSize effectSize = sizeof(glm::vec4) * EFFECT_BLOCK * maxEffects;
+            gpu.createBuffer(effectSize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, frame.effects);
+            frame.effectsMapped = static_cast<glm::vec4*>(frame.effects.memory->mapMemory(0, effectSize));
+        }
+    }
+
+    void EffectsRenderer::createDescriptorSets() {
+        const uint32_t blurCount = MAX_BLUR_PASSES * MAX_FRAMES_IN_FLIGHT;
+        const uint32_t backdropCount = MAX_BLUR_LEVELS * MAX_FRAMES_IN_FLIGHT;
+        const uint32_t shadowCount = MAX_FRAMES_IN_FLIGHT;
+
+        // One pool for all three interfaces, sized by the sum of what each needs
+        std::vector<vk::DescriptorPoolSize> poolSizes = blurInterface->getPoolSizes(blurCount);
+        for (const auto& size : backdropInterface->getPoolSizes(backdropCount)) poolSizes.push_back(size);
+        for (const auto& size : shadowInterface->getPoolSizes(shadowCount)) poolSizes.push_back(size);
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.setPoolSizes(poolSizes)
+                .setMaxSets(blurCount + backdropCount + shadowCount)
+                .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+        descriptorPool.emplace(gpu.getDevice(), poolInfo);
+
+        auto allocate = [&](const graphics::vulkan::ShaderInterface& shaderInterface, uint32_t count) {
+            std::vector<vk::DescriptorSetLayout> layouts(count, shaderInterface.setLayouts.front());
+            vk::DescriptorSetAllocateInfo allocInfo{};
+            allocInfo.setDescriptorPool(*descriptorPool)
+                     .setSetLayouts(layouts);
+            return gpu.getDevice().allocateDescriptorSets(allocInfo);
+        };
+        blurSets = allocate(*blurInterface, blurCount);
+        backdropSets = allocate(*backdropInterface, backdropCount);
+        shadowSets = allocate(*shadowInterface, shadowCount);
+
+        // Effect data never moves, the blurred images are bound by record()
+        std::vector<vk::DescriptorBufferInfo> bufferInfos;
+        bufferInfos.reserve(MAX_FRAMES_IN_FLIGHT);
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+            const vk::DescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back(*frames[frame].effects.data, 0, vk::WholeSize);
+            auto write = [&](const vk::raii::DescriptorSet& descriptorSet) {
+                writes.emplace_back().setDstSet(*descriptorSet)
+                        .setDstBinding(0)
+                        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                        .setDescriptorCount(1)
+                        .setPBufferInfo(&bufferInfo);
+            };
+            write(shadowSets[frame]);
+            for (uint32_t depth = 0; depth < MAX_BLUR_LEVELS; ++depth) write(backdropSets[frame * MAX_BLUR_LEVELS + depth]);
+        }
+        gpu.updateDescriptorSets(writes);
+    }
+}
@@ -0,0 +1,109 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <optional>
+#include <vector>
+#include <glm/glm.hpp>
+#include <Engine/ufox_graphic.hpp>
+#include <Engine/ufox_gui_renderer.hpp>
+#include <Engine/ufox_render_target_pool.hpp>
+
+namespace ufox::renderer::gui {
+
+    struct EffectStats {
+        uint32_t shadows{0};
+        uint32_t backdrops{0};
+        uint32_t blurPasses{0};     // compute dispatches recorded by the last record()
+    };
+
+    // Drop shadows and backdrop blur for GUI nodes. Shadows are analytic, one quad each with no extra pass.
+    // Backdrops sample a dual-Kawase blur of a source image computed on a half resolution chain: the downsampling
+    // passes are shared by every backdrop of the frame, only blur radii that need a different chain depth add
+    // upsampling passes. Effects are added to the caller's DrawList right away so they keep painter's order.
+    class EffectsRenderer {
+    public:
+        static constexpr uint32_t MAX_BLUR_LEVELS = 5;
+
+        EffectsRenderer(graphics::vulkan::GraphicsDevice& gpu, graphics::vulkan::RenderTargetPool& pool, uint32_t maxEffects = 1024);
+
+        EffectsRenderer(const EffectsRenderer&) = delete;
+        EffectsRenderer& operator=(const EffectsRenderer&) = delete;
+
+        // Call once per frame slot after its fence signaled
+        void beginFrame(uint32_t frameIndex);
+
+        // Rects in framebuffer pixels, cornerRadius in the order of RoundedRectParams. Both return false when the
+        // effect was dropped this frame: capacity reached or its pipeline still compiling.
+        bool dropShadow(DrawList& drawList, const Rect& rect, glm::vec4 cornerRadius, const DropShadow& shadow,
+                        const vk::Rect2D& scissor, const vk::Extent2D& framebuffer, uint8_t layer = 0);
+        bool backdrop(DrawList& drawList, const Rect& rect, glm::vec4 cornerRadius, const BackdropFilter& filter,
+                      const vk::Rect2D& scissor, const vk::Extent2D& framebuffer, uint8_t layer = 0);
+
+        // Blurs source for the backdrops added this frame. source holds what is drawn behind them, placed at origin
+        // in framebuffer pixels and in eShaderReadOnlyOptimal. Call outside dynamic rendering and before the
+        // DrawList holding the backdrops is recorded, their descriptor sets are written here.
+        void record(const vk::raii::CommandBuffer& cmd, const graphics::vulkan::Image& source, glm::vec2 origin = glm::vec2(0.0f));
+
+        [[nodiscard]] const EffectStats& getStats() const { return stats; }
+        // Chain depth a blur radius needs, each level halves the resolution
+        [[nodiscard]] static uint32_t GetBlurLevels(float radius);
+
+    private:
+        static constexpr uint32_t WORKGROUP_SIZE = 8;
+        static constexpr uint32_t EFFECT_BLOCK = 3;         // vec4s per effect
+        static constexpr vk::Format BLUR_FORMAT = vk::Format::eR16G16B16A16Sfloat;
+        // Downsampling plus one upsampling chain per depth: n + (1 + 2 + ... + n - 1)
+        static constexpr uint32_t MAX_BLUR_PASSES = MAX_BLUR_LEVELS * (MAX_BLUR_LEVELS + 1) / 2;
+
+        struct BlurPass {
+            glm::vec2 halfPixel;
+            float offset;
+            uint32_t upsample;
+        };
+
+        struct PassConstants {
+            glm::vec2 inverseViewport;
+        };
+
+        struct FrameResources {
+            graphics::vulkan::Buffer vertices{};
+            PathVertex* verticesMapped{nullptr};
+            graphics::vulkan::Buffer effects{};
+            glm::vec4* effectsMapped{nullptr};
+        };
+
+        graphics::vulkan::GraphicsDevice& gpu;
+        graphics::vulkan::RenderTargetPool& pool;
+        uint32_t maxEffects;
+        const graphics::vulkan::ShaderInterface* blurInterface{nullptr};
+        const graphics::vulkan::ShaderInterface* shadowInterface{nullptr};
+        const graphics::vulkan::ShaderInterface* backdropInterface{nullptr};
+        graphics::vulkan::PipelineKey shadowKey{};
+        graphics::vulkan::PipelineKey backdropKey{};
+        std::optional<vk::raii::Pipeline> blurPipeline{};
+        std::optional<vk::raii::Sampler> sampler{};
+        std::optional<vk::raii::DescriptorPool> descriptorPool{};
+        std::vector<vk::raii::DescriptorSet> blurSets;          // frame * MAX_BLUR_PASSES + pass
+        std::vector<vk::raii::DescriptorSet> shadowSets;        // per frame
+        std::vector<vk::raii::DescriptorSet> backdropSets;      // frame * MAX_BLUR_LEVELS + depth - 1
+        std::vector<FrameResources> frames;
+        graphics::vulkan::Buffer indices{};
+
+        uint32_t frameIndex{0};
+        uint32_t effectCount{0};
+        // Blocks of this frame's backdrops, their source placement is only known in record()
+        std::vector<uint32_t> backdropBlocks;
+        std::array<float, MAX_BLUR_LEVELS> levelRadius{};       // largest radius requested per depth, 0 if unused
+        EffectStats stats{};
+
+        [[nodiscard]] std::optional<uint32_t> addQuad(DrawList& drawList, vk::Pipeline pipeline, const graphics::vulkan::ShaderInterface& shaderInterface,
+                                                      vk::DescriptorSet descriptorSet, glm::vec2 center, glm::vec2 halfExtent, glm::vec4 color,
+                                                      const vk::Rect2D& scissor, const vk::Extent2D& framebuffer, uint8_t layer);
+        void createPipelines();
+        void createBuffers();
+        void createDescriptorSets();
+    };
+}
@@ -0,0 +1,128 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_hit_test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ufox::renderer::gui {
+    HitTestGrid::HitTestGrid(float cellSize) : requestedCellSize{std::max(cellSize, 1.0f)}, cellSize{requestedCellSize} {}
+
+    void HitTestGrid::build(std::span<const HitElement> elements) {
+        clear();
+
+        struct Bounds {
+            glm::vec2 min;
+            glm::vec2 max;
+            uint32_t element;
+        };
+
+        // Clip first so scrolled-out children never land in a cell
+        std::vector<Bounds> bounds;
+        bounds.reserve(elements.size());
+        glm::vec2 lo{std::numeric_limits<float>::max()};
+        glm::vec2 hi{std::numeric_limits<float>::lowest()};
+        for (uint32_t i = 0; i < elements.size(); ++i) {
+            const HitElement& element = elements[i];
+            glm::vec2 min = glm::max(element.rect.position, element.clip.position);
+            glm::vec2 max = glm::min(element.rect.position + element.rect.size, element.clip.position + element.clip.size);
+            if (max.x <= min.x || max.y <= min.y) continue;
+
+            bounds.push_back({min, max, i});
+            lo = glm::min(lo, min);
+            hi = glm::max(hi, max);
+        }
+        if (bounds.empty()) return;
+
+        // Topmost first, later elements win ties like they would when painted
+        std::ranges::sort(bounds, [&elements](const Bounds& a, const Bounds& b) {
+            int32_t za = elements[a.element].zOrder;
+            int32_t zb = elements[b.element].zOrder;
+            return za != zb ? za > zb : a.element > b.element;
+        });
+
+        origin = lo;
+        extent = hi - lo;
+        cellSize = requestedCellSize;
+        while (static_cast<double>(std::ceil(extent.x / cellSize)) * std::ceil(extent.y / cellSize) > MAX_CELLS)
+            cellSize *= 2.0f;
+        inverseCellSize = 1.0f / cellSize;
+        columns = std::max(static_cast<uint32_t>(std::ceil(extent.x * inverseCellSize)), 1u);
+        rows = std::max(static_cast<uint32_t>(std::ceil(extent.y * inverseCellSize)), 1u);
+
+        auto cellRange = [this](const Bounds& b) {
+            const glm::ivec2 maxCell(columns - 1, rows - 1);
+            glm::uvec2 first(glm::clamp(glm::ivec2((b.min - origin) * inverseCellSize), glm::ivec2(0), maxCell));
+            glm::uvec2 last(glm::clamp(glm::ivec2((b.max - origin) * inverseCellSize), glm::ivec2(0), maxCell));
+            return std::pair{first, last};
+        };
+
+        // Counting pass then fill pass keeps every cell's entries contiguous
+        cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+        for (const Bounds& b : bounds) {
+            auto [first, last] = cellRange(b);
+            for (uint32_t y = first.y; y <= last.y; ++y)
+                for (uint32_t x = first.x; x <= last.x; ++x)
+                    ++cellStart[y * columns + x + 1];
+        }
+        for (size_t i = 1; i < cellStart.size(); ++i)
+            cellStart[i] += cellStart[i - 1];
+
+        entries.resize(cellStart.back());
+        std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+        for (const Bounds& b : bounds) {
+            auto [first, last] = cellRange(b);
+            CellEntry entry{b.min, b.max, elements[b.element].id};
+            for (uint32_t y = first.y; y <= last.y; ++y)
+                for (uint32_t x = first.x; x <= last.x; ++x)
+                    entries[cursor[y * columns + x]++] = entry;
+        }
+
+        elementCount = bounds.size();
+    }
+
+    void HitTestGrid::clear() {
+        columns = 0;
+        rows = 0;
+        elementCount = 0;
+        cellStart.clear();
+        entries.clear();
+    }
+
+    std::optional<uint32_t> HitTestGrid::hitTest(glm::vec2 point) const {
+        int32_t cell = cellIndex(point);
+        if (cell < 0) return std::nullopt;
+
+        for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+            const CellEntry& entry = entries[i];
+            if (point.x >= entry.min.x && point.x < entry.max.x && point.y >= entry.min.y && point.y < entry.max.y)
+                return entry.id;
+        }
+        return std::nullopt;
+    }
+
+    void HitTestGrid::hitTestAll(glm::vec2 point, std::vector<uint32_t>& hits) const {
+        hits.clear();
+        int32_t cell = cellIndex(point);
+        if (cell < 0) return;
+
+        for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+            const CellEntry& entry = entries[i];
+            if (point.x >= entry.min.x && point.x < entry.max.x && point.y >= entry.min.y && point.y < entry.max.y)
+                hits.push_back(entry.id);
+        }
+    }
+
+    int32_t HitTestGrid::cellIndex(glm::vec2 point) const {
+        if (columns == 0) return -1;
+        glm::vec2 local = point - origin;
+        if (local.x < 0.0f || local.y < 0.0f || local.x >= extent.x || local.y >= extent.y) return -1;
+
+        uint32_t x = std::min(static_cast<uint32_t>(local.x * inverseCellSize), columns - 1);
+        uint32_t y = std::min(static_cast<uint32_t>(local.y * inverseCellSize), rows - 1);
+        return static_cast<int32_t>(y * columns + x);
+    }
+}
@@ -0,0 +1,63 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <optional>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include <Engine/ufox_gui_renderer.hpp>
+
+namespace ufox::renderer::gui {
+
+    struct HitElement {
+        uint32_t id;
+        Rect rect;
+        Rect clip;              // the element only receives hits inside rect and clip
+        int32_t zOrder;         // higher is on top, ties go to the element added last
+    };
+
+    // Uniform grid over laid-out rects answering "what is under the cursor" without walking the widget tree.
+    // Each cell stores the clipped bounds of the elements touching it, sorted topmost first, so a query reads a
+    // single contiguous run and stops at the first hit.
+    class HitTestGrid {
+    public:
+        explicit HitTestGrid(float cellSize = 64.0f);
+
+        // Rebuilds from scratch, call after layout changes. O(n) plus the sort by z-order
+        void build(std::span<const HitElement> elements);
+        void clear();
+
+        // Id of the topmost element containing point, in the same space as InputSystem::getMousePosition
+        [[nodiscard]] std::optional<uint32_t> hitTest(glm::vec2 point) const;
+        // Ids of every element containing point, topmost first
+        void hitTestAll(glm::vec2 point, std::vector<uint32_t>& hits) const;
+
+        [[nodiscard]] size_t size() const { return elementCount; }
+        [[nodiscard]] float getCellSize() const { return cellSize; }
+
+    private:
+        // Keeps the grid bounded when a few elements span huge areas, cell size grows instead
+        static constexpr uint32_t MAX_CELLS = 1u << 18;
+
+        struct CellEntry {
+            glm::vec2 min;
+            glm::vec2 max;
+            uint32_t id;
+        };
+
+        float requestedCellSize;
+        float cellSize;
+        float inverseCellSize{0.0f};
+        glm::vec2 origin{0.0f};
+        glm::vec2 extent{0.0f};
+        uint32_t columns{0};
+        uint32_t rows{0};
+        size_t elementCount{0};
+        std::vector<uint32_t> cellStart;    // columns * rows + 1 offsets into entries
+        std::vector<CellEntry> entries;
+
+        [[nodiscard]] int32_t cellIndex(glm::vec2 point) const;
+    };
+}
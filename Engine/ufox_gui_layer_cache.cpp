@@ -0,0 +1,394 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_layer_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ufox::renderer::gui {
+    using graphics::vulkan::MAX_FRAMES_IN_FLIGHT;
+
+    namespace {
+        void TransitionLayer(const vk::raii::CommandBuffer& cmd, vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                             vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
+                             vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage) {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.setImage(image)
+                   .setOldLayout(oldLayout)
+                   .setNewLayout(newLayout)
+                   .setSrcStageMask(srcStage)
+                   .setDstStageMask(dstStage)
+                   .setSrcAccessMask(srcAccess)
+                   .setDstAccessMask(dstAccess)
+                   .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                   .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                   .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
+            cmd.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barrier));
+        }
+
+        // Every format a GUI target uses is 8-bit RGBA
+        vk::DeviceSize EstimateBytes(const vk::Extent2D& extent) {
+            return static_cast<vk::DeviceSize>(extent.width) * extent.height * 4;
+        }
+    }
+
+    LayerCache::LayerCache(graphics::vulkan::GraphicsDevice &gpu, graphics::vulkan::RenderTargetPool &pool, uint32_t maxLayers,
+                           vk::DeviceSize budget) :
+        gpu{gpu}, pool{pool}, maxLayers{std::max(maxLayers, 1u)}, budget{budget}, format{gpu.getPrimaryTarget().getFormat()} {
+        updatePipelineKeys();
+        shaderInterface = &gpu.getLayoutCache().get({ compositeKey.vertexShader, compositeKey.fragmentShader });
+        if (shaderInterface->setLayouts.empty()) throw std::runtime_error("GUI shaders declare no descriptor sets");
+
+        layers.resize(this->maxLayers);
+        createSampler();
+        createBuffers();
+        createDescriptorSets();
+    }
+
+    void LayerCache::updatePipelineKeys() {
+        pipelineKeyVersion = gpu.getPipelineKeyVersion();
+
+        // Composites go through the swapchain pass with the regular rounded-rect shaders, layers are already premultiplied
+        compositeKey = gpu.makePipelineKey();
+        compositeKey.blendMode = graphics::vulkan::BlendMode::Premultiplied;
+
+        // Same shaders and vertex layout as the swapchain pass, minus MSAA and depth
+        layerKey = gpu.makePipelineKey();
+        layerKey.colorFormat = format;
+        layerKey.depthFormat = vk::Format::eUndefined;
+        layerKey.samples = vk::SampleCountFlagBits::e1;
+        layerKey.blendMode = graphics::vulkan::BlendMode::Layer;
+
+        gpu.getPipelineCache().prewarm(compositeKey);
+        gpu.getPipelineCache().prewarm(layerKey);
+    }
+
+    LayerId LayerCache::createLayer() {
+        auto it = std::ranges::find_if(layers, [](const Layer& layer) { return !layer.alive; });
+        if (it == layers.end()) throw std::runtime_error("LayerCache: all " + std::to_string(maxLayers) + " layers are in use");
+
+        *it = Layer{};
+        it->alive = true;
+        return static_cast<LayerId>(it - layers.begin());
+    }
+
+    void LayerCache::destroyLayer(LayerId id) {
+        Layer& layer = layers.at(id);
+        releaseTarget(layer);
+        layer.alive = false;
+    }
+
+    void LayerCache::invalidate(LayerId id) {
+        layers.at(id).invalidated = true;
+    }
+
+    void LayerCache::beginFrame(uint32_t frameIndex) {
+        this->frameIndex = frameIndex;
+        ++frameNumber;
+        pending.clear();
+
+        // The base key carries the sample count and formats of the swapchain pass, which change with the
+        // anti-aliasing mode or a recreated swapchain
+        if (pipelineKeyVersion != gpu.getPipelineKeyVersion() || compositeKey.colorFormat != gpu.getPrimaryTarget().getFormat())
+            updatePipelineKeys();
+        stats.composited = 0;
+        stats.rendered = 0;
+        stats.direct = 0;
+        stats.evicted = 0;
+
+        for (Layer& layer : layers) {
+            if (!layer.target.valid() || layer.lastDrawn + EVICT_AFTER_FRAMES > frameNumber) continue;
+            releaseTarget(layer);
+            ++stats.evicted;
+        }
+    }
+
+    void LayerCache::draw(LayerId id, const Rect &bounds, const LayerRecorder &recorder, DrawList &drawList,
+                          const vk::Rect2D &scissor, const vk::Extent2D &framebuffer, glm::vec4 cornerRadius, uint8_t layer) {
+        Layer& state = layers.at(id);
+        if (!state.alive) throw std::runtime_error("LayerCache: drawing a destroyed layer");
+
+        // Whole pixels, so the cached image maps texel to pixel
+        const glm::vec2 position = glm::round(bounds.position);
+        const vk::Extent2D extent{ static_cast<uint32_t>(std::ceil(std::max(bounds.size.x, 0.0f))),
+                                   static_cast<uint32_t>(std::ceil(std::max(bounds.size.y, 0.0f))) };
+        if (extent != state.extent) {
+            state.extent = extent;
+            state.invalidated = true;
+        }
+
+        state.lastDrawn = frameNumber;
+        state.invalidationRate += ((state.invalidated ? 1.0f : 0.0f) - state.invalidationRate) * INVALIDATION_SMOOTHING;
+        if (state.invalidated) {
+            state.invalidated = false;
+            state.contentValid = false;
+            state.stableFrames = 0;
+        }
+        else {
+            ++state.stableFrames;
+        }
+
+        vk::Pipeline pipeline = shouldCache(id) ? gpu.getPipelineCache().request(compositeKey) : vk::Pipeline{};
+        if (!pipeline) {
+            releaseTarget(state);
+            LayerContext context{ position, framebuffer, gpu.makePipelineKey(), frameIndex, false };
+            const size_t before = drawList.size();
+            recorder(drawList, context);
+            state.drawCount = static_cast<uint32_t>(drawList.size() - before);
+            ++stats.direct;
+            return;
+        }
+
+        if (!state.contentValid) {
+            // The previous image may still be sampled by frames in flight, render into a fresh one
+            graphics::vulkan::RenderTarget target = pool.acquire({ format, extent,
+                vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled });
+            releaseTarget(state);
+            state.target = std::move(target);
+            stats.bytes += state.target.image->allocationSize;
+
+            PendingLayer& render = pending.emplace_back(PendingLayer{ id, DrawList{} });
+            LayerContext context{ glm::vec2(0.0f), extent, layerKey, frameIndex, true };
+            recorder(render.drawList, context);
+            state.contentValid = context.complete;
+            ++stats.rendered;
+        }
+
+        composite(id, position, drawList, scissor, framebuffer, cornerRadius, layer, pipeline);
+    }
+
+    void LayerCache::record(const vk::raii::CommandBuffer &cmd, DrawStats &drawStats) {
+        for (PendingLayer& render : pending) {
+            const Layer& layer = layers[render.id];
+            if (!layer.alive || !layer.target.valid()) continue;
+            const graphics::vulkan::Image& image = *layer.target.image;
+
+            TransitionLayer(cmd, *image.data, vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal,
+                vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eColorAttachmentWrite,
+                vk::PipelineStageFlagBits2::eFragmentShader, vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+
+            vk::RenderingAttachmentInfo colorAttachment{};
+            colorAttachment.setImageView(*image.view)
+                .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                .setLoadOp(vk::AttachmentLoadOp::eClear)
+                .setStoreOp(vk::AttachmentStoreOp::eStore)
+                .setClearValue({ std::array{0.0f, 0.0f, 0.0f, 0.0f} });
+
+            vk::RenderingInfo renderingInfo{};
+            renderingInfo.setRenderArea({ {0, 0}, image.extent })
+                .setLayerCount(1)
+                .setColorAttachments(colorAttachment);
+
+            cmd.beginRendering(renderingInfo);
+            cmd.setDepthTestEnable(false);
+            cmd.setDepthWriteEnable(false);
+            cmd.setDepthCompareOp(vk::CompareOp::eLess);
+
+            render.drawList.compile();
+            render.drawList.record(cmd, vk::Viewport{ 0.0f, 0.0f, static_cast<float>(image.extent.width), static_cast<float>(image.extent.height), 0.0f, 1.0f }, drawStats);
+
+            cmd.endRendering();
+
+            TransitionLayer(cmd, *image.data, vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::AccessFlagBits2::eColorAttachmentWrite, vk::AccessFlagBits2::eShaderSampledRead,
+                vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::PipelineStageFlagBits2::eFragmentShader);
+        }
+        pending.clear();
+    }
+
+    bool LayerCache::shouldCache(LayerId id) {
+        const Layer& layer = layers[id];
+        const uint64_t pixels = static_cast<uint64_t>(layer.extent.width) * layer.extent.height;
+        if (pixels == 0 || pixels > MAX_LAYER_PIXELS) return false;
+        // Animated subtrees would be rendered twice per change, once offscreen and once as a composite
+        if (layer.invalidationRate > MAX_INVALIDATION_RATE) return false;
+        if (layer.contentValid) return true;
+        if (layer.stableFrames < MIN_STABLE_FRAMES || layer.drawCount < MIN_DRAWS) return false;
+        return reserve(id, EstimateBytes(layer.extent));
+    }
+
+    bool LayerCache::reserve(LayerId id, vk::DeviceSize bytes) {
+        const Layer& layer = layers[id];
+        auto required = [&] {
+            vk::DeviceSize held = layer.target.valid() ? layer.target.image->allocationSize : 0;
+            return stats.bytes - held + bytes;
+        };
+        if (required() <= budget) return true;
+
+        // Least recently drawn layers that are not part of this frame make room first
+        std::vector<LayerId> candidates;
+        for (LayerId other = 0; other < layers.size(); ++other) {
+            if (other != id && layers[other].target.valid() && layers[other].lastDrawn < frameNumber) candidates.push_back(other);
+        }
+        std::ranges::sort(candidates, {}, [&](LayerId other) { return layers[other].lastDrawn; });
+        for (LayerId other : candidates) {
+            releaseTarget(layers[other]);
+            ++stats.evicted;
+            if (required() <= budget) return true;
+        }
+        return false;
+    }
+
+    void LayerCache::releaseTarget(Layer &layer) {
+        layer.contentValid = false;
+        if (!layer.target.valid()) return;
+        stats.bytes -= layer.target.image->allocationSize;
+        pool.release(std::move(layer.target));
+        layer.target = {};
+        // Sets of other frame slots may still reference the old view, each is rewritten before its slot uses it
+        layer.boundViews.fill(vk::ImageView{});
+    }
+
+    void LayerCache::composite(LayerId id, glm::vec2 position, DrawList &drawList, const vk::Rect2D &scissor,
+                               const vk::Extent2D &framebuffer, glm::vec4 cornerRadius, uint8_t layer, vk::Pipeline pipeline) {
+        Layer& state = layers[id];
+        uint8_t* slot = uniformBuffersMapped[frameIndex] + id * UNIFORM_SLOT * 2;
+
+        graphics::UniformBufferObject ubo{};
+        ubo.model = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f)) *
+                    glm::scale(glm::mat4(1.0f), glm::vec3(state.extent.width, state.extent.height, 1.0f));
+        ubo.view = glm::mat4(1.0f);
+        ubo.proj = glm::ortho(0.0f, static_cast<float>(framebuffer.width), 0.0f, static_cast<float>(framebuffer.height), -1.0f, 1.0f);
+        memcpy(slot, &ubo, sizeof(ubo));
+
+        // No border and no shader clip (the quad's clip stream is all entry 0), the layer already holds its subtree
+        // clipped; clipping the composite is the scissor's job since the shader clip would only fade alpha and
+        // break premultiplied colors
+        graphics::RoundedRectParams params{};
+        params.cornerRadius = cornerRadius;
+
+        vk::raii::DescriptorSet& descriptorSet = descriptorSets[frameIndex * maxLayers + id];
+        const vk::ImageView view = *state.target.image->view;
+        if (state.boundViews[frameIndex] != view) {
+            vk::DescriptorImageInfo imageInfo{ **sampler, view, vk::ImageLayout::eShaderReadOnlyOptimal };
+            vk::WriteDescriptorSet write{};
+            write.setDstSet(*descriptorSet)
+                 .setDstBinding(1)
+                 .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                 .setDescriptorCount(1)
+                 .setPImageInfo(&imageInfo);
+            gpu.updateDescriptorSets(write);
+            state.boundViews[frameIndex] = view;
+        }
+
+        DrawCommand draw{};
+        draw.pipeline = pipeline;
+        draw.layout = shaderInterface->pipelineLayout;
+        draw.descriptorSet = *descriptorSet;
+        draw.vertexBuffer = *vertexBuffer.data;
+        draw.indexBuffer = *indexBuffer.data;
+        draw.indexType = vk::IndexType::eUint16;
+        draw.scissor = scissor;
+        draw.indexCount = 6;
+        draw.layer = layer;
+
+        if (gpu.usesPushConstantParams()) {
+            draw.pushConstantStages = shaderInterface->pushConstantRanges.front().stageFlags;
+            drawList.add(draw, params);
+        }
+        else {
+            memcpy(slot + UNIFORM_SLOT, &params, sizeof(params));
+            drawList.add(draw);
+        }
+        ++stats.composited;
+    }
+
+    void LayerCache::createSampler() {
+        vk::SamplerCreateInfo samplerInfo{};
+        samplerInfo.setMagFilter(vk::Filter::eLinear)
+                   .setMinFilter(vk::Filter::eLinear)
+                   .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+                   .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+                   .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+                   .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+                   .setMaxLod(0.0f);
+        sampler.emplace(gpu.getDevice(), samplerInfo);
+    }
+
+    void LayerCache::createBuffers() {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        // Two slots per layer: the transform at binding 0 and, without push constants, RoundedRectParams at binding 2
+        const vk::DeviceSize uniformSize = UNIFORM_SLOT * 2 * maxLayers;
+        uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& buffer : uniformBuffers) {
+            gpu.createBuffer(uniformSize, vk::BufferUsageFlagBits::eUniformBuffer, hostVisible, buffer);
+            uniformBuffersMapped.push_back(static_cast<uint8_t*>(buffer.memory->mapMemory(0, uniformSize)));
+        }
+
+        const vk::DeviceSize vertexSize = std::size(graphics::TestRect) * GetVertexStride(compositeKey.vertexLayout);
+        gpu.createBuffer(vertexSize, vk::BufferUsageFlagBits::eVertexBuffer, hostVisible, vertexBuffer);
+        WriteVertices(compositeKey.vertexLayout, graphics::TestRect, vertexBuffer.memory->mapMemory(0, vertexSize));
+        vertexBuffer.memory->unmapMemory();
+
+        constexpr vk::DeviceSize vertexClipSize = std::size(graphics::TestRect) * sizeof(uint32_t);
+        gpu.createBuffer(vertexClipSize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, vertexClipBuffer);
+        memset(vertexClipBuffer.memory->mapMemory(0, vertexClipSize), 0, vertexClipSize);
+        vertexClipBuffer.memory->unmapMemory();
+
+        constexpr uint16_t quad[6] = { 0, 1, 2, 2, 3, 0 };
+        gpu.createBuffer(sizeof(quad), vk::BufferUsageFlagBits::eIndexBuffer, hostVisible, indexBuffer);
+        memcpy(indexBuffer.memory->mapMemory(0, sizeof(quad)), quad, sizeof(quad));
+        indexBuffer.memory->unmapMemory();
+    }
+
+    void LayerCache::createDescriptorSets() {
+        const uint32_t setCount = maxLayers * MAX_FRAMES_IN_FLIGHT;
+        std::vector<vk::DescriptorPoolSize> poolSizes = shaderInterface->getPoolSizes(setCount);
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.setPoolSizes(poolSizes)
+                .setMaxSets(setCount)
+                .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+        descriptorPool.emplace(gpu.getDevice(), poolInfo);
+
+        std::vector<vk::DescriptorSetLayout> setLayouts(setCount, shaderInterface->setLayouts.front());
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.setDescriptorPool(*descriptorPool)
+                 .setSetLayouts(setLayouts);
+        descriptorSets = gpu.getDevice().allocateDescriptorSets(allocInfo);
+
+        // Buffer bindings never change, the image binding is written when a layer first composites in a slot
+        std::vector<vk::DescriptorBufferInfo> bufferInfos;
+        bufferInfos.reserve(setCount * 4);
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+            for (uint32_t layer = 0; layer < maxLayers; ++layer) {
+                const vk::DescriptorSet descriptorSet = *descriptorSets[frame * maxLayers + layer];
+                const vk::DeviceSize offset = UNIFORM_SLOT * 2 * layer;
+
+                bufferInfos.emplace_back(*uniformBuffers[frame].data, offset, sizeof(graphics::UniformBufferObject));
+                writes.emplace_back().setDstSet(descriptorSet)
+                        .setDstBinding(0)
+                        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                        .setDescriptorCount(1)
+                        .setPBufferInfo(&bufferInfos.back());
+
+                bufferInfos.emplace_back(*vertexClipBuffer.data, 0, vk::WholeSize);
+                writes.emplace_back().setDstSet(descriptorSet)
+                        .setDstBinding(3)
+                        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                        .setDescriptorCount(1)
+                        .setPBufferInfo(&bufferInfos.back());
+
+                bufferInfos.emplace_back(*gpu.getClipBuffer(frame).data, 0, vk::WholeSize);
+                writes.emplace_back().setDstSet(descriptorSet)
+                        .setDstBinding(4)
+                        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                        .setDescriptorCount(1)
+                        .setPBufferInfo(&bufferInfos.back());
+
+                if (gpu.usesPushConstantParams()) continue;
+                bufferInfos.emplace_back(*uniformBuffers[frame].data, offset + UNIFORM_SLOT, sizeof(graphics::RoundedRectParams));
+                writes.emplace_back().setDstSet(descriptorSet)
+                        .setDstBinding(2)
+                        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                        .setDescriptorCount(1)
+                        .setPBufferInfo(&bufferInfos.back());
+            }
+        }
+        gpu.updateDescriptorSets(writes);
+    }
+}
@@ -0,0 +1,138 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <glm/glm.hpp>
+#include <Engine/ufox_graphic.hpp>
+#include <Engine/ufox_gui_renderer.hpp>
+#include <Engine/ufox_render_target_pool.hpp>
+
+namespace ufox::renderer::gui {
+
+    using LayerId = uint32_t;
+
+    // Where a subtree is being drawn. The recorder places its (0, 0) at origin and builds pipelines from
+    // pipelineKey, which already matches the format and sample count of the target.
+    struct LayerContext {
+        glm::vec2 origin{0.0f};
+        vk::Extent2D extent{0, 0};                  // of the render target, for projections and scissors
+        graphics::vulkan::PipelineKey pipelineKey{};
+        uint32_t frameIndex{0};
+        bool offscreen{false};
+        // Clear it when a draw had to be skipped, e.g. its pipeline was still compiling, so the layer is redrawn
+        bool complete{true};
+    };
+
+    using LayerRecorder = std::function<void(DrawList& drawList, LayerContext& context)>;
+
+    struct LayerStats {
+        uint32_t composited{0};     // drawn as a single cached quad
+        uint32_t rendered{0};       // of those, re-rendered into their target this frame
+        uint32_t direct{0};         // drawn straight into the frame, caching did not pay off
+        uint32_t evicted{0};
+        vk::DeviceSize bytes{0};    // render targets held by layers
+    };
+
+    // Caches static GUI subtrees in offscreen images. A cached subtree costs one textured quad through the
+    // rounded-rect shader per frame and is re-rendered only after invalidate() or a size change; moving it is free.
+    // Subtrees that change often, draw little or would not fit the budget are drawn directly instead.
+    class LayerCache {
+    public:
+        LayerCache(graphics::vulkan::GraphicsDevice& gpu, graphics::vulkan::RenderTargetPool& pool, uint32_t maxLayers = 64,
+                   vk::DeviceSize budget = 64 * 1024 * 1024);
+
+        LayerCache(const LayerCache&) = delete;
+        LayerCache& operator=(const LayerCache&) = delete;
+
+        [[nodiscard]] LayerId createLayer();
+        void destroyLayer(LayerId id);
+        // The subtree changed, its cached image is stale
+        void invalidate(LayerId id);
+
+        // Call once per frame slot after its fence signaled, before draw()
+        void beginFrame(uint32_t frameIndex);
+
+        // Draws the subtree at bounds, in framebuffer pixels. Either adds the cached layer to drawList or calls
+        // recorder with drawList directly. recorder may be called with an offscreen list instead, which record() plays.
+        void draw(LayerId id, const Rect& bounds, const LayerRecorder& recorder, DrawList& drawList,
+                  const vk::Rect2D& scissor, const vk::Extent2D& framebuffer, glm::vec4 cornerRadius = glm::vec4(0.0f), uint8_t layer = 0);
+
+        // Renders the layers draw() refreshed this frame. Call outside dynamic rendering, before the pass that
+        // records the drawList they were composited into.
+        void record(const vk::raii::CommandBuffer& cmd, DrawStats& drawStats);
+
+        [[nodiscard]] const LayerStats& getStats() const { return stats; }
+
+    private:
+        // A subtree must stay unchanged this many frames before it is worth rendering offscreen
+        static constexpr uint32_t MIN_STABLE_FRAMES = 2;
+        // Fewer draws than this are cheaper to record than a composite
+        static constexpr uint32_t MIN_DRAWS = 3;
+        // Smoothed share of frames with an invalidation above which a subtree counts as animated
+        static constexpr float MAX_INVALIDATION_RATE = 0.2f;
+        static constexpr float INVALIDATION_SMOOTHING = 1.0f / 16.0f;
+        static constexpr uint32_t MAX_LAYER_PIXELS = 2048 * 2048;
+        // Layers not drawn for this many frames give their image back to the pool
+        static constexpr uint64_t EVICT_AFTER_FRAMES = 120;
+        // Largest minUniformBufferOffsetAlignment the spec allows, slots are aligned on every device
+        static constexpr vk::DeviceSize UNIFORM_SLOT = 256;
+
+        struct Layer {
+            bool alive{false};
+            graphics::vulkan::RenderTarget target{};
+            vk::Extent2D extent{0, 0};
+            bool contentValid{false};
+            bool invalidated{true};
+            float invalidationRate{0.0f};
+            uint32_t stableFrames{0};
+            uint32_t drawCount{0};          // measured the last time it was drawn directly
+            uint64_t lastDrawn{0};
+            std::array<vk::ImageView, graphics::vulkan::MAX_FRAMES_IN_FLIGHT> boundViews{};
+        };
+
+        struct PendingLayer {
+            LayerId id;
+            DrawList drawList;
+        };
+
+        graphics::vulkan::GraphicsDevice& gpu;
+        graphics::vulkan::RenderTargetPool& pool;
+        uint32_t maxLayers;
+        vk::DeviceSize budget;
+        vk::Format format;
+        const graphics::vulkan::ShaderInterface* shaderInterface{nullptr};
+        graphics::vulkan::PipelineKey compositeKey{};
+        graphics::vulkan::PipelineKey layerKey{};
+        uint64_t pipelineKeyVersion{0};
+        std::optional<vk::raii::Sampler> sampler{};
+        std::optional<vk::raii::DescriptorPool> descriptorPool{};
+        std::vector<vk::raii::DescriptorSet> descriptorSets;     // frame * maxLayers + layer
+        std::vector<graphics::vulkan::Buffer> uniformBuffers;
+        std::vector<uint8_t*> uniformBuffersMapped;
+        graphics::vulkan::Buffer vertexBuffer{};
+        // Clip stream of the composite quad, every vertex uses the unclipped entry 0
+        graphics::vulkan::Buffer vertexClipBuffer{};
+        graphics::vulkan::Buffer indexBuffer{};
+
+        std::vector<Layer> layers;
+        std::vector<PendingLayer> pending;
+        uint32_t frameIndex{0};
+        uint64_t frameNumber{0};
+        LayerStats stats{};
+
+        [[nodiscard]] bool shouldCache(LayerId id);
+        [[nodiscard]] bool reserve(LayerId id, vk::DeviceSize bytes);
+        void releaseTarget(Layer& layer);
+        void composite(LayerId id, glm::vec2 position, DrawList& drawList, const vk::Rect2D& scissor,
+                       const vk::Extent2D& framebuffer, glm::vec4 cornerRadius, uint8_t layer, vk::Pipeline pipeline);
+        void updatePipelineKeys();
+        void createSampler();
+        void createBuffers();
+        void createDescriptorSets();
+    };
+}
@@ -0,0 +1,406 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_path.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include "Engine/ufox_hash.hpp"
+
+namespace ufox::renderer::gui {
+    namespace {
+        constexpr float MIN_TOLERANCE = 0.01f;
+        constexpr uint32_t MAX_CURVE_SEGMENTS = 256;
+        // Aim for bands a few pixels tall, a fragment then tests a handful of edges instead of the whole outline
+        constexpr float BAND_HEIGHT = 8.0f;
+        constexpr uint32_t MAX_BANDS = 256;
+        // The fragment shader samples rows at y +- 0.25, edges are registered in neighbouring bands within reach
+        constexpr float BAND_MARGIN = 0.5f;
+
+        float Cross(glm::vec2 a, glm::vec2 b) {
+            return a.x * b.y - a.y * b.x;
+        }
+
+        void AddPoint(PathContour& contour, glm::vec2 point) {
+            if (contour.points.empty() || contour.points.back() != point) contour.points.push_back(point);
+        }
+
+        uint32_t CurveSegments(float secondDifference, float tolerance) {
+            const float segments = std::ceil(std::sqrt(secondDifference / tolerance));
+            return std::clamp(static_cast<uint32_t>(segments), 1u, MAX_CURVE_SEGMENTS);
+        }
+
+        float SignedArea(std::span<const glm::vec2> polygon) {
+            float area = 0.0f;
+            for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) area += Cross(polygon[j], polygon[i]);
+            return area * 0.5f;
+        }
+
+        // Every piece of a stroke is wound the same way so the non-zero rule unions them
+        void AddPolygon(std::vector<std::vector<glm::vec2>>& polygons, std::vector<glm::vec2> polygon) {
+            const float area = SignedArea(polygon);
+            if (std::abs(area) < 1e-6f) return;
+            if (area < 0.0f) std::ranges::reverse(polygon);
+            polygons.push_back(std::move(polygon));
+        }
+
+        std::vector<glm::vec2> Circle(glm::vec2 center, float radius, float tolerance) {
+            const float ratio = std::clamp(1.0f - tolerance / radius, -1.0f, 1.0f);
+            const float steps = std::ceil(std::numbers::pi_v<float> / std::max(std::acos(ratio), 1e-3f));
+            const uint32_t count = std::clamp(static_cast<uint32_t>(steps), 8u, 128u);
+
+            std::vector<glm::vec2> points(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                const float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(count);
+                points[i] = center + radius * glm::vec2(std::cos(angle), std::sin(angle));
+            }
+            return points;
+        }
+
+        void AddJoin(std::vector<std::vector<glm::vec2>>& polygons, glm::vec2 vertex, glm::vec2 in, glm::vec2 out,
+                     float halfWidth, const StrokeStyle& style, float tolerance) {
+            const float turn = Cross(in, out);
+            if (std::abs(turn) < 1e-6f && glm::dot(in, out) > 0.0f) return;
+
+            if (style.join == LineJoin::Round) {
+                AddPolygon(polygons, Circle(vertex, halfWidth, tolerance));
+                return;
+            }
+
+            // Turning towards the left normal puts the gap on the right side and vice versa
+            const float side = turn > 0.0f ? -1.0f : 1.0f;
+            const glm::vec2 normalIn = side * halfWidth * glm::vec2(-in.y, in.x);
+            const glm::vec2 normalOut = side * halfWidth * glm::vec2(-out.y, out.x);
+
+            if (style.join == LineJoin::Miter) {
+                const glm::vec2 bisector = normalIn + normalOut;
+                const float bisectorLength = glm::length(bisector);
+                if (bisectorLength > 1e-6f) {
+                    // Distance from the vertex to the tip is halfWidth / cos(theta / 2)
+                    const float cosine = glm::dot(bisector / bisectorLength, normalIn) / halfWidth;
+                    const float miterLength = cosine > 1e-6f ? halfWidth / cosine : INFINITY;
+                    if (miterLength <= style.miterLimit * halfWidth) {
+                        const glm::vec2 tip = vertex + bisector / bisectorLength * miterLength;
+                        AddPolygon(polygons, { vertex, vertex + normalIn, tip, vertex + normalOut });
+                        return;
+                    }
+                }
+            }
+            AddPolygon(polygons, { vertex, vertex + normalIn, vertex + normalOut });
+        }
+
+        void AddCap(std::vector<std::vector<glm::vec2>>& polygons, glm::vec2 point, glm::vec2 direction,
+                    float halfWidth, const StrokeStyle& style, float tolerance) {
+            if (style.cap == LineCap::Round) {
+                AddPolygon(polygons, Circle(point, halfWidth, tolerance));
+            }
+            else if (style.cap == LineCap::Square) {
+                const glm::vec2 normal = halfWidth * glm::vec2(-direction.y, direction.x);
+                const glm::vec2 back = direction * halfWidth;
+                AddPolygon(polygons, { point + normal, point + normal + back, point - normal + back, point - normal });
+            }
+        }
+
+        PathGeometry BuildGeometry(const std::vector<std::vector<glm::vec2>>& polygons, FillRule fillRule) {
+            PathGeometry geometry{};
+            geometry.fillRule = fillRule;
+
+            glm::vec2 min(INFINITY);
+            glm::vec2 max(-INFINITY);
+            std::vector<glm::vec4> edges;
+            for (const auto& polygon : polygons) {
+                for (size_t i = 0; i < polygon.size(); ++i) {
+                    const glm::vec2 a = polygon[i];
+                    const glm::vec2 b = polygon[(i + 1) % polygon.size()];
+                    min = glm::min(min, a);
+                    max = glm::max(max, a);
+                    // Horizontal edges never cross a horizontal ray
+                    if (a.y != b.y) edges.emplace_back(a, b);
+                }
+            }
+            if (edges.empty()) return geometry;
+
+            geometry.bounds = glm::vec4(min, max);
+            const float height = std::max(max.y - min.y, 1e-3f);
+            const auto bandCount = std::clamp(static_cast<uint32_t>(std::ceil(height / BAND_HEIGHT)), 1u,
+                                              std::min(MAX_BANDS, static_cast<uint32_t>(edges.size())));
+            geometry.bandScale = static_cast<float>(bandCount) / height;
+
+            const auto bandOf = [&](float y) {
+                const auto band = static_cast<int64_t>(std::floor((y - min.y) * geometry.bandScale));
+                return static_cast<uint32_t>(std::clamp<int64_t>(band, 0, bandCount - 1));
+            };
+
+            // Counting sort into bands, an edge spanning several bands is repeated in each of them
+            geometry.bands.assign(bandCount, glm::uvec2(0));
+            for (const glm::vec4& edge : edges) {
+                const uint32_t first = bandOf(std::min(edge.y, edge.w) - BAND_MARGIN);
+                const uint32_t last = bandOf(std::max(edge.y, edge.w) + BAND_MARGIN);
+                for (uint32_t band = first; band <= last; ++band) ++geometry.bands[band].y;
+            }
+            uint32_t offset = 0;
+            for (glm::uvec2& band : geometry.bands) {
+                band.x = offset;
+                offset += band.y;
+                band.y = 0;
+            }
+            geometry.segments.resize(offset);
+            for (const glm::vec4& edge : edges) {
+                const uint32_t first = bandOf(std::min(edge.y, edge.w) - BAND_MARGIN);
+                const uint32_t last = bandOf(std::max(edge.y, edge.w) + BAND_MARGIN);
+                for (uint32_t band = first; band <= last; ++band) {
+                    glm::uvec2& range = geometry.bands[band];
+                    geometry.segments[range.x + range.y++] = edge;
+                }
+            }
+            return geometry;
+        }
+    }
+
+    void Path::ensureMove() {
+        if (!open) moveTo(cursor);
+    }
+
+    Path &Path::moveTo(glm::vec2 point) {
+        verbs.push_back(Verb::Move);
+        points.push_back(point);
+        start = point;
+        cursor = point;
+        open = true;
+        return *this;
+    }
+
+    Path &Path::lineTo(glm::vec2 point) {
+        ensureMove();
+        verbs.push_back(Verb::Line);
+        points.push_back(point);
+        cursor = point;
+        return *this;
+    }
+
+    Path &Path::quadTo(glm::vec2 control, glm::vec2 point) {
+        ensureMove();
+        verbs.push_back(Verb::Quad);
+        points.push_back(control);
+        points.push_back(point);
+        cursor = point;
+        return *this;
+    }
+
+    Path &Path::cubicTo(glm::vec2 control0, glm::vec2 control1, glm::vec2 point) {
+        ensureMove();
+        verbs.push_back(Verb::Cubic);
+        points.push_back(control0);
+        points.push_back(control1);
+        points.push_back(point);
+        cursor = point;
+        return *this;
+    }
+
+    Path &Path::arc(glm::vec2 center, float radius, float startAngle, float endAngle) {
+        constexpr float fullTurn = 2.0f * std::numbers::pi_v<float>;
+        const float sweep = std::clamp(endAngle - startAngle, -fullTurn, fullTurn);
+        const auto pointAt = [&](float angle) { return center + radius * glm::vec2(std::cos(angle), std::sin(angle)); };
+
+        const glm::vec2 first = pointAt(startAngle);
+        if (!open) moveTo(first);
+        else if (cursor != first) lineTo(first);
+        if (radius <= 0.0f || sweep == 0.0f) return *this;
+
+        // Quarter turns or less keep the cubic approximation within 0.03% of the radius
+        const int pieces = std::max(1, static_cast<int>(std::ceil(std::abs(sweep) / (fullTurn * 0.25f) - 1e-4f)));
+        const float step = sweep / static_cast<float>(pieces);
+        const float handle = 4.0f / 3.0f * std::tan(step * 0.25f) * radius;
+        for (int i = 0; i < pieces; ++i) {
+            const float a = startAngle + step * static_cast<float>(i);
+            const float b = a + step;
+            const glm::vec2 tangentA(-std::sin(a), std::cos(a));
+            const glm::vec2 tangentB(-std::sin(b), std::cos(b));
+            cubicTo(pointAt(a) + handle * tangentA, pointAt(b) - handle * tangentB, pointAt(b));
+        }
+        return *this;
+    }
+
+    Path &Path::close() {
+        if (!open) return *this;
+        verbs.push_back(Verb::Close);
+        cursor = start;
+        open = false;
+        return *this;
+    }
+
+    Path &Path::addRect(glm::vec2 position, glm::vec2 size) {
+        moveTo(position);
+        lineTo({ position.x + size.x, position.y });
+        lineTo(position + size);
+        lineTo({ position.x, position.y + size.y });
+        return close();
+    }
+
+    Path &Path::addRoundedRect(glm::vec2 position, glm::vec2 size, float radius) {
+        radius = std::min(radius, std::min(size.x, size.y) * 0.5f);
+        if (radius <= 0.0f) return addRect(position, size);
+
+        constexpr float quarter = std::numbers::pi_v<float> * 0.5f;
+        const glm::vec2 max = position + size;
+        moveTo({ position.x + radius, position.y });
+        arc({ max.x - radius, position.y + radius }, radius, -quarter, 0.0f);
+        arc({ max.x - radius, max.y - radius }, radius, 0.0f, quarter);
+        arc({ position.x + radius, max.y - radius }, radius, quarter, 2.0f * quarter);
+        arc({ position.x + radius, position.y + radius }, radius, 2.0f * quarter, 3.0f * quarter);
+        return close();
+    }
+
+    Path &Path::addCircle(glm::vec2 center, float radius) {
+        moveTo(center + glm::vec2(radius, 0.0f));
+        arc(center, radius, 0.0f, 2.0f * std::numbers::pi_v<float>);
+        return close();
+    }
+
+    void Path::clear() {
+        verbs.clear();
+        points.clear();
+        start = cursor = glm::vec2(0.0f);
+        open = false;
+    }
+
+    uint64_t Path::getHash() const {
+        uint64_t seed = hash::Fnv1a64(verbs.data(), verbs.size() * sizeof(Verb));
+        return hash::Fnv1a64(points.data(), points.size() * sizeof(glm::vec2), seed);
+    }
+
+    bool Path::operator==(const Path &other) const {
+        return verbs == other.verbs && points.size() == other.points.size() &&
+               std::memcmp(points.data(), other.points.data(), points.size() * sizeof(glm::vec2)) == 0;
+    }
+
+    std::vector<PathContour> FlattenPath(const Path &path, float tolerance) {
+        tolerance = std::max(tolerance, MIN_TOLERANCE);
+        std::span<const glm::vec2> points = path.getPoints();
+
+        std::vector<PathContour> contours;
+        PathContour contour{};
+        const auto flush = [&] {
+            if (!contour.points.empty()) contours.push_back(std::move(contour));
+            contour = {};
+        };
+
+        size_t index = 0;
+        for (Path::Verb verb : path.getVerbs()) {
+            switch (verb) {
+                case Path::Verb::Move:
+                    flush();
+                    AddPoint(contour, points[index++]);
+                    break;
+                case Path::Verb::Line:
+                    AddPoint(contour, points[index++]);
+                    break;
+                case Path::Verb::Quad: {
+                    const glm::vec2 p0 = contour.points.back();
+                    const glm::vec2 p1 = points[index];
+                    const glm::vec2 p2 = points[index + 1];
+                    index += 2;
+                    // Chord error of n uniform steps is |p0 - 2 p1 + p2| / (4 n^2)
+                    const uint32_t n = CurveSegments(glm::length(p0 - 2.0f * p1 + p2) * 0.25f, tolerance);
+                    for (uint32_t i = 1; i <= n; ++i) {
+                        const float t = static_cast<float>(i) / static_cast<float>(n);
+                        const float u = 1.0f - t;
+                        AddPoint(contour, u * u * p0 + 2.0f * u * t * p1 + t * t * p2);
+                    }
+                    break;
+                }
+                case Path::Verb::Cubic: {
+                    const glm::vec2 p0 = contour.points.back();
+                    const glm::vec2 p1 = points[index];
+                    const glm::vec2 p2 = points[index + 1];
+                    const glm::vec2 p3 = points[index + 2];
+                    index += 3;
+                    // |B''| <= 6 max(|p0 - 2 p1 + p2|, |p1 - 2 p2 + p3|), chord error of n steps is |B''| / (8 n^2)
+                    const float secondDifference = std::max(glm::length(p0 - 2.0f * p1 + p2), glm::length(p1 - 2.0f * p2 + p3));
+                    const uint32_t n = CurveSegments(secondDifference * 0.75f, tolerance);
+                    for (uint32_t i = 1; i <= n; ++i) {
+                        const float t = static_cast<float>(i) / static_cast<float>(n);
+                        const float u = 1.0f - t;
+                        AddPoint(contour, u * u * u * p0 + 3.0f * u * u * t * p1 + 3.0f * u * t * t * p2 + t * t * t * p3);
+                    }
+                    break;
+                }
+                case Path::Verb::Close:
+                    // The closing edge is implied, drop a last point that repeats the first
+                    if (contour.points.size() > 1 && contour.points.back() == contour.points.front()) contour.points.pop_back();
+                    contour.closed = true;
+                    flush();
+                    break;
+            }
+        }
+        flush();
+        return contours;
+    }
+
+    void PathGeometry::writeBlock(glm::vec4 *dst) const {
+        const auto bits = [](uint32_t value) { return std::bit_cast<float>(value); };
+        const auto bandCount = static_cast<uint32_t>(bands.size());
+        const uint32_t segmentBase = 2 + (bandCount + 1) / 2;
+
+        dst[0] = bounds;
+        dst[1] = glm::vec4(bits(bandCount), bits(static_cast<uint32_t>(fillRule)), bandScale, bits(segmentBase));
+        for (uint32_t i = 0; i < bandCount; i += 2) {
+            const glm::uvec2 second = i + 1 < bandCount ? bands[i + 1] : glm::uvec2(0);
+            dst[2 + i / 2] = glm::vec4(bits(bands[i].x), bits(bands[i].y), bits(second.x), bits(second.y));
+        }
+        std::ranges::copy(segments, dst + segmentBase);
+    }
+
+    PathGeometry BuildFillGeometry(const Path &path, FillRule fillRule, float tolerance) {
+        std::vector<std::vector<glm::vec2>> polygons;
+        for (PathContour& contour : FlattenPath(path, tolerance)) {
+            if (contour.points.size() > 2) polygons.push_back(std::move(contour.points));
+        }
+        return BuildGeometry(polygons, fillRule);
+    }
+
+    PathGeometry BuildStrokeGeometry(const Path &path, const StrokeStyle &style, float tolerance) {
+        tolerance = std::max(tolerance, MIN_TOLERANCE);
+        const float halfWidth = style.width * 0.5f;
+        std::vector<std::vector<glm::vec2>> polygons;
+        if (halfWidth <= 0.0f) return {};
+
+        for (const PathContour& contour : FlattenPath(path, tolerance)) {
+            const std::vector<glm::vec2>& points = contour.points;
+            if (points.size() == 1) {
+                // Zero length subpath, only caps that extend past the point are visible
+                if (style.cap == LineCap::Round) AddPolygon(polygons, Circle(points.front(), halfWidth, tolerance));
+                else if (style.cap == LineCap::Square) AddPolygon(polygons, { points.front() + glm::vec2(-halfWidth, -halfWidth), points.front() + glm::vec2(halfWidth, -halfWidth),
+                                                                              points.front() + glm::vec2(halfWidth, halfWidth), points.front() + glm::vec2(-halfWidth, halfWidth) });
+                continue;
+            }
+
+            const size_t segmentCount = contour.closed ? points.size() : points.size() - 1;
+            std::vector<glm::vec2> directions(segmentCount);
+            for (size_t i = 0; i < segmentCount; ++i) {
+                const glm::vec2 a = points[i];
+                const glm::vec2 b = points[(i + 1) % points.size()];
+                directions[i] = glm::normalize(b - a);
+
+                const glm::vec2 normal = halfWidth * glm::vec2(-directions[i].y, directions[i].x);
+                AddPolygon(polygons, { a + normal, b + normal, b - normal, a - normal });
+            }
+
+            for (size_t i = 1; i < segmentCount; ++i) {
+                AddJoin(polygons, points[i], directions[i - 1], directions[i], halfWidth, style, tolerance);
+            }
+            if (contour.closed) {
+                AddJoin(polygons, points.front(), directions.back(), directions.front(), halfWidth, style, tolerance);
+            }
+            else {
+                AddCap(polygons, points.front(), -directions.front(), halfWidth, style, tolerance);
+                AddCap(polygons, points.back(), directions.back(), halfWidth, style, tolerance);
+            }
+        }
+        return BuildGeometry(polygons, FillRule::NonZero);
+    }
+}
@@ -0,0 +1,113 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace ufox::renderer::gui {
+
+    enum class FillRule : uint32_t {
+        NonZero,
+        EvenOdd,
+    };
+
+    enum class LineJoin : uint8_t {
+        Miter,
+        Round,
+        Bevel,
+    };
+
+    enum class LineCap : uint8_t {
+        Butt,
+        Square,
+        Round,
+    };
+
+    struct StrokeStyle {
+        float width{1.0f};
+        LineJoin join{LineJoin::Miter};
+        LineCap cap{LineCap::Butt};
+        // Miters longer than miterLimit * width / 2 fall back to bevels
+        float miterLimit{4.0f};
+    };
+
+    // Outline in pixels, y down like the rest of the GUI. Arcs are stored as cubics, so flattening and hashing
+    // only deal with lines and beziers.
+    class Path {
+    public:
+        enum class Verb : uint8_t {
+            Move,
+            Line,
+            Quad,
+            Cubic,
+            Close,
+        };
+
+        Path& moveTo(glm::vec2 point);
+        Path& lineTo(glm::vec2 point);
+        Path& quadTo(glm::vec2 control, glm::vec2 point);
+        Path& cubicTo(glm::vec2 control0, glm::vec2 control1, glm::vec2 point);
+        // Angles in radians, clockwise on screen. Connects to the current point with a line like canvas arc()
+        Path& arc(glm::vec2 center, float radius, float startAngle, float endAngle);
+        Path& close();
+
+        Path& addRect(glm::vec2 position, glm::vec2 size);
+        Path& addRoundedRect(glm::vec2 position, glm::vec2 size, float radius);
+        Path& addCircle(glm::vec2 center, float radius);
+
+        void clear();
+        [[nodiscard]] bool empty() const { return verbs.empty(); }
+
+        [[nodiscard]] std::span<const Verb> getVerbs() const { return verbs; }
+        [[nodiscard]] std::span<const glm::vec2> getPoints() const { return points; }
+        // FNV-1a of verbs and points, equal paths share cached geometry
+        [[nodiscard]] uint64_t getHash() const;
+        // Same bytes as getHash covers, confirms a hash match
+        [[nodiscard]] bool operator==(const Path& other) const;
+
+    private:
+        std::vector<Verb> verbs;
+        std::vector<glm::vec2> points;
+        glm::vec2 start{0.0f};
+        glm::vec2 cursor{0.0f};
+        bool open{false};
+
+        // Drawing after close() or on an empty path starts a new contour at the cursor
+        void ensureMove();
+    };
+
+    struct PathContour {
+        std::vector<glm::vec2> points;
+        bool closed{false};
+    };
+
+    // Lines stay as they are, curves become chords that deviate at most tolerance pixels from the curve
+    [[nodiscard]] std::vector<PathContour> FlattenPath(const Path& path, float tolerance);
+
+    // Edges of a filled outline bucketed into horizontal bands, so the fragment shader only tests the edges of the
+    // band it sits in. Filled with a winding test per pixel, no triangulation involved. This is exactly what
+    // PathRenderer uploads, see Shaders/path.frag for the layout.
+    struct PathGeometry {
+        glm::vec4 bounds{0.0f};                 // min x, min y, max x, max y
+        FillRule fillRule{FillRule::NonZero};
+        float bandScale{0.0f};                  // bands per pixel, band = (y - bounds.y) * bandScale
+        std::vector<glm::uvec2> bands;          // offset, count into segments
+        std::vector<glm::vec4> segments;        // x0, y0, x1, y1, repeated in every band it reaches
+
+        [[nodiscard]] bool empty() const { return segments.empty(); }
+        // Size in vec4 units, see PathRenderer
+        [[nodiscard]] size_t getBlockSize() const { return 2 + (bands.size() + 1) / 2 + segments.size(); }
+        // Writes the block the shader reads, dst must hold getBlockSize() vec4s
+        void writeBlock(glm::vec4* dst) const;
+    };
+
+    // Every contour is closed implicitly
+    [[nodiscard]] PathGeometry BuildFillGeometry(const Path& path, FillRule fillRule, float tolerance);
+    // Outline of the stroke as positively wound polygons filled with the non-zero rule, so overlapping pieces of
+    // the stroke never cancel out
+    [[nodiscard]] PathGeometry BuildStrokeGeometry(const Path& path, const StrokeStyle& style, float tolerance);
+}
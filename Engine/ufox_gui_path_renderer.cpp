@@ -0,0 +1,296 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_path_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <bit>
+#include "Engine/ufox_hash.hpp"
+
+namespace ufox::renderer::gui {
+    using graphics::vulkan::MAX_FRAMES_IN_FLIGHT;
+
+    namespace {
+        // Covers the anti-aliased fringe the coverage test produces around the outline
+        constexpr float QUAD_PADDING = 1.0f;
+
+        constexpr uint32_t FILL_GEOMETRY = 0;
+        constexpr uint32_t STROKE_GEOMETRY = 1;
+
+        uint64_t StyleKey(uint64_t seed, float value) {
+            return hash::Combine(seed, std::bit_cast<uint32_t>(value));
+        }
+    }
+
+    PathRenderer::PathRenderer(graphics::vulkan::GraphicsDevice &gpu, uint32_t maxPaths, vk::DeviceSize geometryBytes) :
+        gpu{gpu}, maxPaths{std::max(maxPaths, 1u)},
+        capacity{static_cast<uint32_t>(std::min<vk::DeviceSize>(geometryBytes / sizeof(glm::vec4), UINT32_MAX - 1))} {
+        shaderInterface = &gpu.getLayoutCache().get({ "shaders/path.vert.spv", "shaders/path.frag.spv" });
+        if (shaderInterface->pushConstantRanges.empty()) throw std::runtime_error("path.vert declares no push constants");
+
+        createBuffers();
+        createDescriptorSet();
+        freeBlocks.emplace(0, capacity);
+
+        graphics::vulkan::PipelineKey key = gpu.makePipelineKey();
+        key.vertexShader = "shaders/path.vert.spv";
+        key.fragmentShader = "shaders/path.frag.spv";
+        key.vertexLayout = graphics::vulkan::VertexLayout::Path;
+        key.layout = shaderInterface->pipelineLayout;
+        key.specialization.clear();
+        gpu.getPipelineCache().prewarm(key);
+    }
+
+    PathRenderer::~PathRenderer() {
+        // Builds capture copies of their paths, waiting keeps them from outliving the job system they run on
+        for (auto& [key, entry] : cache) {
+            if (entry.build.valid()) entry.build.wait();
+        }
+    }
+
+    void PathRenderer::beginFrame(uint32_t frameIndex) {
+        this->frameIndex = frameIndex;
+        ++frameNumber;
+        queued = 0;
+        recorded = 0;
+        stats.queued = 0;
+        stats.pending = 0;
+
+        // Blocks retired MAX_FRAMES_IN_FLIGHT frames ago are no longer read by any submission
+        std::erase_if(retired, [&](const RetiredBlock& block) {
+            if (block.frame + MAX_FRAMES_IN_FLIGHT > frameNumber) return false;
+            release(block.block, block.size);
+            return true;
+        });
+
+        std::erase_if(cache, [&](auto& item) {
+            CacheEntry& entry = item.second;
+            if (entry.lastUsed + EVICT_AFTER_FRAMES > frameNumber) return false;
+            if (entry.build.valid() && entry.build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+            if (entry.block != INVALID_BLOCK) retired.push_back({ entry.block, entry.blockSize, frameNumber });
+            return true;
+        });
+        stats.cached = static_cast<uint32_t>(cache.size());
+    }
+
+    bool PathRenderer::fill(const Path &path, glm::vec4 color, FillRule fillRule, glm::vec2 offset) {
+        uint64_t key = hash::Combine(path.getHash(), static_cast<uint64_t>(fillRule));
+        key = StyleKey(key, tolerance);
+        const GeometryStyle geometryStyle{ FILL_GEOMETRY, static_cast<uint32_t>(fillRule), 0, 0, std::bit_cast<uint32_t>(tolerance) };
+
+        auto [entry, inserted] = findEntry(key, path, geometryStyle);
+        if (inserted)
+            entry.build = gpu.getJobSystem().submit([path, fillRule, tolerance = tolerance] { return BuildFillGeometry(path, fillRule, tolerance); });
+        return queue(entry, color, offset);
+    }
+
+    bool PathRenderer::stroke(const Path &path, glm::vec4 color, const StrokeStyle &style, glm::vec2 offset) {
+        uint64_t key = hash::Combine(path.getHash(), 0x5354524f4b45ull);
+        key = hash::Combine(key, (static_cast<uint64_t>(style.join) << 8) | static_cast<uint64_t>(style.cap));
+        key = StyleKey(StyleKey(StyleKey(key, style.width), style.miterLimit), tolerance);
+        const GeometryStyle geometryStyle{ STROKE_GEOMETRY, static_cast<uint32_t>(style.join) << 8 | static_cast<uint32_t>(style.cap),
+                                           std::bit_cast<uint32_t>(style.width), std::bit_cast<uint32_t>(style.miterLimit),
+                                           std::bit_cast<uint32_t>(tolerance) };
+
+        auto [entry, inserted] = findEntry(key, path, geometryStyle);
+        if (inserted)
+            entry.build = gpu.getJobSystem().submit([path, style, tolerance = tolerance] { return BuildStrokeGeometry(path, style, tolerance); });
+        return queue(entry, color, offset);
+    }
+
+    std::pair<PathRenderer::CacheEntry&, bool> PathRenderer::findEntry(uint64_t key, const Path &path, const GeometryStyle &style) {
+        while (true) {
+            auto [it, inserted] = cache.try_emplace(key);
+            CacheEntry& entry = it->second;
+            if (inserted) {
+                entry.path = path;
+                entry.style = style;
+                return { entry, true };
+            }
+            if (entry.style == style && entry.path == path) return { entry, false };
+            // Another path owns this hash, keep probing so neither draws the other's geometry
+            key = hash::Combine(key, 0x50524f4245ull);
+        }
+    }
+
+    bool PathRenderer::queue(CacheEntry& entry, glm::vec4 color, glm::vec2 offset) {
+        entry.lastUsed = frameNumber;
+
+        if (entry.build.valid()) {
+            if (entry.build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++stats.pending;
+                return false;
+            }
+            entry.geometry = entry.build.get();
+            entry.empty = entry.geometry->empty();
+            entry.bounds = entry.geometry->bounds;
+        }
+        if (entry.empty) return true;
+        if (entry.block == INVALID_BLOCK && !upload(entry)) {
+            ++stats.pending;
+            return false;
+        }
+        if (queued >= maxPaths) {
+            ++stats.pending;
+            return false;
+        }
+
+        uint8_t rgba[4];
+        for (int c = 0; c < 4; ++c) rgba[c] = static_cast<uint8_t>(std::round(std::clamp(color[c], 0.0f, 1.0f) * 255.0f));
+
+        const glm::vec2 min = glm::vec2(entry.bounds.x, entry.bounds.y) - QUAD_PADDING;
+        const glm::vec2 max = glm::vec2(entry.bounds.z, entry.bounds.w) + QUAD_PADDING;
+        const glm::vec2 corners[4] = { min, { max.x, min.y }, max, { min.x, max.y } };
+
+        PathVertex* vertices = frames[frameIndex].verticesMapped + queued * 4;
+        for (int i = 0; i < 4; ++i) {
+            const glm::vec2 position = corners[i] + offset;
+            vertices[i] = PathVertex{ { position.x, position.y }, { rgba[0], rgba[1], rgba[2], rgba[3] },
+                                      { corners[i].x, corners[i].y }, entry.block };
+        }
+        ++queued;
+        ++stats.queued;
+        return true;
+    }
+
+    bool PathRenderer::upload(CacheEntry &entry) {
+        const auto size = static_cast<uint32_t>(entry.geometry->getBlockSize());
+        std::optional<uint32_t> block = allocate(size);
+        if (!block) {
+            // Geometry idle for longer than the frames in flight can go right away, oldest first
+            std::vector<std::pair<uint64_t, uint64_t>> idle;
+            for (const auto& [key, other] : cache) {
+                if (other.block != INVALID_BLOCK && other.lastUsed + MAX_FRAMES_IN_FLIGHT < frameNumber) idle.emplace_back(other.lastUsed, key);
+            }
+            std::ranges::sort(idle);
+            for (const auto& [lastUsed, key] : idle) {
+                CacheEntry& victim = cache.at(key);
+                release(victim.block, victim.blockSize);
+                cache.erase(key);
+                if ((block = allocate(size))) break;
+            }
+        }
+        if (!block) {
+            if (!reportedFull) fmt::println("PathRenderer: geometry buffer full, {} vec4 needed", size);
+            reportedFull = true;
+            return false;
+        }
+
+        // Fresh range of host coherent memory no submission references yet, visible to the next submit
+        entry.geometry->writeBlock(geometryMapped + *block);
+        entry.block = *block;
+        entry.blockSize = size;
+        entry.geometry.reset();
+        stats.geometryBytes += size * sizeof(glm::vec4);
+        return true;
+    }
+
+    void PathRenderer::record(DrawList &drawList, const vk::Rect2D &scissor, const vk::Extent2D &framebuffer, uint8_t layer) {
+        if (recorded == queued) return;
+
+        graphics::vulkan::PipelineKey key = gpu.makePipelineKey();
+        key.vertexShader = "shaders/path.vert.spv";
+        key.fragmentShader = "shaders/path.frag.spv";
+        key.vertexLayout = graphics::vulkan::VertexLayout::Path;
+        key.layout = shaderInterface->pipelineLayout;
+        key.specialization.clear();
+        vk::Pipeline pipeline = gpu.getPipelineCache().request(key);
+        if (!pipeline) return;
+
+        DrawCommand draw{};
+        draw.pipeline = pipeline;
+        draw.layout = shaderInterface->pipelineLayout;
+        draw.descriptorSet = **descriptorSet;
+        draw.vertexBuffer = *frames[frameIndex].vertices.data;
+        draw.indexBuffer = *indices.data;
+        draw.indexType = vk::IndexType::eUint32;
+        draw.pushConstantStages = shaderInterface->pushConstantRanges.front().stageFlags;
+        draw.scissor = scissor;
+        draw.firstIndex = recorded * 6;
+        draw.indexCount = (queued - recorded) * 6;
+        draw.layer = layer;
+
+        const PassConstants constants{ glm::vec2(1.0f / static_cast<float>(framebuffer.width), 1.0f / static_cast<float>(framebuffer.height)) };
+        drawList.add(draw, constants);
+        recorded = queued;
+    }
+
+    std::optional<uint32_t> PathRenderer::allocate(uint32_t size) {
+        for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+            auto [offset, available] = *it;
+            if (available < size) continue;
+            freeBlocks.erase(it);
+            if (available > size) freeBlocks.emplace(offset + size, available - size);
+            return offset;
+        }
+        return std::nullopt;
+    }
+
+    void PathRenderer::release(uint32_t block, uint32_t size) {
+        stats.geometryBytes -= size * sizeof(glm::vec4);
+        auto it = freeBlocks.emplace(block, size).first;
+        auto next = std::next(it);
+        if (next != freeBlocks.end() && it->first + it->second == next->first) {
+            it->second += next->second;
+            freeBlocks.erase(next);
+        }
+        if (it != freeBlocks.begin()) {
+            auto previous = std::prev(it);
+            if (previous->first + previous->second == it->first) {
+                previous->second += it->second;
+                freeBlocks.erase(it);
+            }
+        }
+    }
+
+    void PathRenderer::createBuffers() {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        const vk::DeviceSize geometrySize = static_cast<vk::DeviceSize>(capacity) * sizeof(glm::vec4);
+        gpu.createBuffer(geometrySize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, geometry);
+        geometryMapped = static_cast<glm::vec4*>(geometry.memory->mapMemory(0, geometrySize));
+
+        const vk::DeviceSize indexSize = sizeof(uint32_t) * 6 * maxPaths;
+        gpu.createBuffer(indexSize, vk::BufferUsageFlagBits::eIndexBuffer, hostVisible, indices);
+        auto* indexData = static_cast<uint32_t*>(indices.memory->mapMemory(0, indexSize));
+        for (uint32_t quad = 0; quad < maxPaths; ++quad) {
+            const uint32_t base = quad * 4;
+            const uint32_t pattern[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+            std::copy_n(pattern, 6, indexData + quad * 6);
+        }
+        indices.memory->unmapMemory();
+
+        frames.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& frame : frames) {
+            const vk::DeviceSize vertexSize = sizeof(PathVertex) * 4 * maxPaths;
+            gpu.createBuffer(vertexSize, vk::BufferUsageFlagBits::eVertexBuffer, hostVisible, frame.vertices);
+            frame.verticesMapped = static_cast<PathVertex*>(frame.vertices.memory->mapMemory(0, vertexSize));
+        }
+    }
+
+    void PathRenderer::createDescriptorSet() {
+        std::vector<vk::DescriptorPoolSize> poolSizes = shaderInterface->getPoolSizes(1);
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.setPoolSizes(poolSizes)
+                .setMaxSets(1)
+                .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+        descriptorPool.emplace(gpu.getDevice(), poolInfo);
+
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.setDescriptorPool(*descriptorPool)
+                 .setSetLayouts(shaderInterface->setLayouts.front());
+        descriptorSet.emplace(std::move(gpu.getDevice().allocateDescriptorSets(allocInfo).front()));
+
+        vk::DescriptorBufferInfo bufferInfo{ *geometry.data, 0, vk::WholeSize };
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(**descriptorSet)
+             .setDstBinding(0)
+             .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+             .setDescriptorCount(1)
+             .setPBufferInfo(&bufferInfo);
+        gpu.updateDescriptorSets(write);
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <future>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <Engine/ufox_graphic.hpp>
+#include <Engine/ufox_gui_path.hpp>
+#include <Engine/ufox_gui_renderer.hpp>
+
+namespace ufox::renderer::gui {
+
+    struct PathStats {
+        uint32_t queued{0};
+        uint32_t pending{0};        // skipped this frame, still flattening or waiting for space
+        uint32_t cached{0};
+        vk::DeviceSize geometryBytes{0};
+    };
+
+    // Draws vector paths through the swapchain pass. Paths are flattened and bucketed into bands on the job
+    // threads, uploaded once into a shared storage buffer and reused every frame their hash stays the same.
+    // Each queued path is one bounding quad; all quads of a frame form a single draw whose fragment shader
+    // computes coverage from the outline, so there is no tessellation and no stencil pass.
+    class PathRenderer {
+    public:
+        static constexpr float DEFAULT_TOLERANCE = 0.25f;
+
+        PathRenderer(graphics::vulkan::GraphicsDevice& gpu, uint32_t maxPaths = 4096, vk::DeviceSize geometryBytes = 4 * 1024 * 1024);
+        ~PathRenderer();
+
+        PathRenderer(const PathRenderer&) = delete;
+        PathRenderer& operator=(const PathRenderer&) = delete;
+
+        // Call once per frame slot after its fence signaled, before queueing paths
+        void beginFrame(uint32_t frameIndex);
+
+        // Queue a path for this frame, offset in framebuffer pixels. Returns false while the geometry is still being
+        // built, the path is then missing for that frame only.
+        bool fill(const Path& path, glm::vec4 color, FillRule fillRule = FillRule::NonZero, glm::vec2 offset = glm::vec2(0.0f));
+        bool stroke(const Path& path, glm::vec4 color, const StrokeStyle& style, glm::vec2 offset = glm::vec2(0.0f));
+
+        // Adds the paths queued since the last record as one draw, they blend in the order they were queued
+        void record(DrawList& drawList, const vk::Rect2D& scissor, const vk::Extent2D& framebuffer, uint8_t layer = 0);
+
+        [[nodiscard]] const PathStats& getStats() const { return stats; }
+        float tolerance{DEFAULT_TOLERANCE};
+
+    private:
+        // Geometry nobody queued for this many frames is released
+        static constexpr uint64_t EVICT_AFTER_FRAMES = 300;
+        static constexpr uint32_t INVALID_BLOCK = UINT32_MAX;
+
+        // Fill rule or join and cap, then width, miter limit and tolerance as raw float bits
+        using GeometryStyle = std::array<uint32_t, 5>;
+
+        struct CacheEntry {
+            // What the geometry was built from, a hash hit only counts when these match too
+            Path path{};
+            GeometryStyle style{};
+            std::future<PathGeometry> build{};
+            std::optional<PathGeometry> geometry{};     // built but not uploaded yet
+            uint32_t block{INVALID_BLOCK};
+            uint32_t blockSize{0};
+            glm::vec4 bounds{0.0f};
+            uint64_t lastUsed{0};
+            bool empty{false};
+        };
+
+        struct RetiredBlock {
+            uint32_t block;
+            uint32_t size;
+            uint64_t frame;
+        };
+
+        struct FrameResources {
+            graphics::vulkan::Buffer vertices{};
+            PathVertex* verticesMapped{nullptr};
+        };
+
+        struct PassConstants {
+            glm::vec2 inverseViewport;
+        };
+
+        graphics::vulkan::GraphicsDevice& gpu;
+        uint32_t maxPaths;
+        uint32_t capacity;                                  // vec4 units
+        const graphics::vulkan::ShaderInterface* shaderInterface{nullptr};
+        std::optional<vk::raii::DescriptorPool> descriptorPool{};
+        std::optional<vk::raii::DescriptorSet> descriptorSet{};
+        graphics::vulkan::Buffer geometry{};
+        glm::vec4* geometryMapped{nullptr};
+        graphics::vulkan::Buffer indices{};
+        std::vector<FrameResources> frames;
+
+        std::unordered_map<uint64_t, CacheEntry> cache;
+        std::map<uint32_t, uint32_t> freeBlocks;            // offset -> size, coalesced on release
+        std::vector<RetiredBlock> retired;
+
+        uint32_t frameIndex{0};
+        uint64_t frameNumber{0};
+        uint32_t queued{0};
+        uint32_t recorded{0};
+        PathStats stats{};
+        bool reportedFull{false};
+
+        // Entry for path and style, probing past keys another path already holds. second is true when it was created
+        std::pair<CacheEntry&, bool> findEntry(uint64_t key, const Path& path, const GeometryStyle& style);
+        bool queue(CacheEntry& entry, glm::vec4 color, glm::vec2 offset);
+        bool upload(CacheEntry& entry);
+        [[nodiscard]] std::optional<uint32_t> allocate(uint32_t size);
+        void release(uint32_t block, uint32_t size);
+        void createBuffers();
+        void createDescriptorSet();
+    };
+}
@@ -0,0 +1,350 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_gui_quad_batch.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <Engine/ufox_gui_renderer.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define UFOX_QUAD_BATCH_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC exposes every intrinsic regardless of /arch, the AVX2 path is only entered after the runtime check
+#define UFOX_TARGET_AVX2
+#define UFOX_FORCE_INLINE __forceinline
+#else
+#define UFOX_TARGET_AVX2 __attribute__((target("avx2")))
+#define UFOX_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace ufox::renderer::gui {
+    namespace {
+        static_assert(std::endian::native == std::endian::little, "Quads are assembled as little endian dwords");
+        static_assert(sizeof(PackedVertex) == 3 * sizeof(uint32_t));
+
+        constexpr size_t QUAD_DWORDS = 12;
+        constexpr size_t QUAD_BYTES = 4 * sizeof(PackedVertex);
+
+        constexpr float POSITION_MIN = -32768.0f;
+        constexpr float POSITION_MAX = 32767.0f;
+        constexpr float UV_MAX = 65535.0f;
+
+        // Corners never leave their clip rect, so clip rects inside the PackedVertex range keep every level from
+        // saturating. The clamps below only keep the conversion defined in release builds.
+        [[maybe_unused]] bool ClipsInRange(const QuadBatch& batch) {
+            for (size_t i = 0; i < batch.count; ++i) {
+                if (std::min(batch.clipMinX[i], batch.clipMinY[i]) < -PackedVertex::MAX_POSITION ||
+                    std::max(batch.clipMaxX[i], batch.clipMaxY[i]) > PackedVertex::MAX_POSITION)
+                    return false;
+            }
+            return true;
+        }
+
+        uint32_t PackPosition(float x, float y) {
+            const auto fx = static_cast<int32_t>(std::nearbyint(std::min(std::max(x * PackedVertex::POSITION_SCALE, POSITION_MIN), POSITION_MAX)));
+            const auto fy = static_cast<int32_t>(std::nearbyint(std::min(std::max(y * PackedVertex::POSITION_SCALE, POSITION_MIN), POSITION_MAX)));
+            return (static_cast<uint32_t>(fx) & 0xFFFFu) | (static_cast<uint32_t>(fy) << 16);
+        }
+
+        uint32_t PackUv(float u, float v) {
+            const auto fu = static_cast<uint32_t>(std::nearbyint(std::min(std::max(u, 0.0f), 1.0f) * UV_MAX));
+            const auto fv = static_cast<uint32_t>(std::nearbyint(std::min(std::max(v, 0.0f), 1.0f) * UV_MAX));
+            return fu | (fv << 16);
+        }
+
+        // Reference path and tail handling of the vector paths, the operation order matches them exactly
+        size_t WriteQuadsScalar(const QuadBatch& batch, size_t first, std::byte* out) {
+            std::byte* const start = out;
+            for (size_t i = first; i < batch.count; ++i) {
+                const float x0 = batch.translateX[i] + batch.scaleX[i] * batch.x[i];
+                const float x1 = batch.translateX[i] + batch.scaleX[i] * (batch.x[i] + batch.width[i]);
+                const float y0 = batch.translateY[i] + batch.scaleY[i] * batch.y[i];
+                const float y1 = batch.translateY[i] + batch.scaleY[i] * (batch.y[i] + batch.height[i]);
+
+                const float cx0 = std::max(x0, batch.clipMinX[i]);
+                const float cx1 = std::min(x1, batch.clipMaxX[i]);
+                const float cy0 = std::max(y0, batch.clipMinY[i]);
+                const float cy1 = std::min(y1, batch.clipMaxY[i]);
+                if (!(cx0 < cx1) || !(cy0 < cy1)) continue;
+
+                const float inverseWidth = 1.0f / (x1 - x0);
+                const float inverseHeight = 1.0f / (y1 - y0);
+                const float u0 = (cx0 - x0) * inverseWidth;
+                const float u1 = (cx1 - x0) * inverseWidth;
+                const float v0 = (cy0 - y0) * inverseHeight;
+                const float v1 = (cy1 - y0) * inverseHeight;
+
+                const uint32_t color = batch.color[i];
+                const uint32_t quad[QUAD_DWORDS] = {
+                    PackPosition(cx0, cy0), color, PackUv(u0, v0),
+                    PackPosition(cx1, cy0), color, PackUv(u1, v0),
+                    PackPosition(cx1, cy1), color, PackUv(u1, v1),
+                    PackPosition(cx0, cy1), color, PackUv(u0, v1),
+                };
+                std::memcpy(out, quad, QUAD_BYTES);
+                out += QUAD_BYTES;
+            }
+            return static_cast<size_t>(out - start) / QUAD_BYTES;
+        }
+
+#if UFOX_QUAD_BATCH_X64
+        // Nine dword vectors of four quads each, every quad is 3 * 4 of them
+        struct QuadLanes {
+            __m128i p00, p10, p11, p01;
+            __m128i uv00, uv10, uv11, uv01;
+            __m128i color;
+        };
+
+        // Helpers are forced inline so the AVX2 kernel gets VEX encoded copies, calling legacy SSE code from it
+        // costs a state transition per call on some CPUs
+        UFOX_FORCE_INLINE void Transpose(__m128i a, __m128i b, __m128i c, __m128i d, __m128i rows[4]) {
+            const __m128i ab0 = _mm_unpacklo_epi32(a, b);
+            const __m128i cd0 = _mm_unpacklo_epi32(c, d);
+            const __m128i ab1 = _mm_unpackhi_epi32(a, b);
+            const __m128i cd1 = _mm_unpackhi_epi32(c, d);
+            rows[0] = _mm_unpacklo_epi64(ab0, cd0);
+            rows[1] = _mm_unpackhi_epi64(ab0, cd0);
+            rows[2] = _mm_unpacklo_epi64(ab1, cd1);
+            rows[3] = _mm_unpackhi_epi64(ab1, cd1);
+        }
+
+        // A quad is 48 contiguous bytes, i.e. the dword sequences (p00 c uv00 p10) (c uv10 p11 c) (uv11 p01 c uv01).
+        // Transposing those three groups of four vectors yields every quad as three 16 byte rows.
+        UFOX_FORCE_INLINE std::byte* StoreQuads(const QuadLanes& lanes, uint32_t visible, std::byte* out) {
+            __m128i first[4], second[4], third[4];
+            Transpose(lanes.p00, lanes.color, lanes.uv00, lanes.p10, first);
+            Transpose(lanes.color, lanes.uv10, lanes.p11, lanes.color, second);
+            Transpose(lanes.uv11, lanes.p01, lanes.color, lanes.uv01, third);
+
+            if (visible == 0xF) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), first[lane]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), second[lane]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), third[lane]);
+                    out += QUAD_BYTES;
+                }
+                return out;
+            }
+            while (visible) {
+                const int lane = std::countr_zero(visible);
+                visible &= visible - 1;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), first[lane]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), second[lane]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), third[lane]);
+                out += QUAD_BYTES;
+            }
+            return out;
+        }
+
+        UFOX_FORCE_INLINE __m128i PackPosition4(__m128 x, __m128 y) {
+            const __m128 scale = _mm_set1_ps(PackedVertex::POSITION_SCALE);
+            const __m128 lo = _mm_set1_ps(POSITION_MIN);
+            const __m128 hi = _mm_set1_ps(POSITION_MAX);
+            const __m128i fx = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(x, scale), lo), hi));
+            const __m128i fy = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(y, scale), lo), hi));
+            return _mm_or_si128(_mm_and_si128(fx, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(fy, 16));
+        }
+
+        UFOX_FORCE_INLINE __m128i PackUv4(__m128 u, __m128 v) {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 scale = _mm_set1_ps(UV_MAX);
+            const __m128i fu = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(u, zero), one), scale));
+            const __m128i fv = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(v, zero), one), scale));
+            return _mm_or_si128(fu, _mm_slli_epi32(fv, 16));
+        }
+
+        // SSE2 is part of x86-64, no runtime check needed
+        size_t WriteQuadsSse2(const QuadBatch& batch, std::byte* out) {
+            std::byte* const start = out;
+            size_t i = 0;
+            for (; i + 4 <= batch.count; i += 4) {
+                const __m128 x = _mm_loadu_ps(&batch.x[i]);
+                const __m128 y = _mm_loadu_ps(&batch.y[i]);
+                const __m128 sx = _mm_loadu_ps(&batch.scaleX[i]);
+                const __m128 sy = _mm_loadu_ps(&batch.scaleY[i]);
+                const __m128 tx = _mm_loadu_ps(&batch.translateX[i]);
+                const __m128 ty = _mm_loadu_ps(&batch.translateY[i]);
+
+                const __m128 x0 = _mm_add_ps(tx, _mm_mul_ps(sx, x));
+                const __m128 x1 = _mm_add_ps(tx, _mm_mul_ps(sx, _mm_add_ps(x, _mm_loadu_ps(&batch.width[i]))));
+                const __m128 y0 = _mm_add_ps(ty, _mm_mul_ps(sy, y));
+                const __m128 y1 = _mm_add_ps(ty, _mm_mul_ps(sy, _mm_add_ps(y, _mm_loadu_ps(&batch.height[i]))));
+
+                const __m128 cx0 = _mm_max_ps(x0, _mm_loadu_ps(&batch.clipMinX[i]));
+                const __m128 cx1 = _mm_min_ps(x1, _mm_loadu_ps(&batch.clipMaxX[i]));
+                const __m128 cy0 = _mm_max_ps(y0, _mm_loadu_ps(&batch.clipMinY[i]));
+                const __m128 cy1 = _mm_min_ps(y1, _mm_loadu_ps(&batch.clipMaxY[i]));
+                const auto visible = static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(cx0, cx1), _mm_cmplt_ps(cy0, cy1))));
+                if (visible == 0) continue;
+
+                // Lanes that are clipped away may divide by zero here, they are never stored
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 inverseWidth = _mm_div_ps(one, _mm_sub_ps(x1, x0));
+                const __m128 inverseHeight = _mm_div_ps(one, _mm_sub_ps(y1, y0));
+                const __m128 u0 = _mm_mul_ps(_mm_sub_ps(cx0, x0), inverseWidth);
+                const __m128 u1 = _mm_mul_ps(_mm_sub_ps(cx1, x0), inverseWidth);
+                const __m128 v0 = _mm_mul_ps(_mm_sub_ps(cy0, y0), inverseHeight);
+                const __m128 v1 = _mm_mul_ps(_mm_sub_ps(cy1, y0), inverseHeight);
+
+                QuadLanes lanes{};
+                lanes.p00 = PackPosition4(cx0, cy0);
+                lanes.p10 = PackPosition4(cx1, cy0);
+                lanes.p11 = PackPosition4(cx1, cy1);
+                lanes.p01 = PackPosition4(cx0, cy1);
+                lanes.uv00 = PackUv4(u0, v0);
+                lanes.uv10 = PackUv4(u1, v0);
+                lanes.uv11 = PackUv4(u1, v1);
+                lanes.uv01 = PackUv4(u0, v1);
+                lanes.color = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.color[i]));
+                out = StoreQuads(lanes, visible, out);
+            }
+            const size_t written = static_cast<size_t>(out - start) / QUAD_BYTES;
+            return written + WriteQuadsScalar(batch, i, out);
+        }
+
+        UFOX_TARGET_AVX2 UFOX_FORCE_INLINE __m256i PackPosition8(__m256 x, __m256 y) {
+            const __m256 scale = _mm256_set1_ps(PackedVertex::POSITION_SCALE);
+            const __m256 lo = _mm256_set1_ps(POSITION_MIN);
+            const __m256 hi = _mm256_set1_ps(POSITION_MAX);
+            const __m256i fx = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(x, scale), lo), hi));
+            const __m256i fy = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(y, scale), lo), hi));
+            return _mm256_or_si256(_mm256_and_si256(fx, _mm256_set1_epi32(0xFFFF)), _mm256_slli_epi32(fy, 16));
+        }
+
+        UFOX_TARGET_AVX2 UFOX_FORCE_INLINE __m256i PackUv8(__m256 u, __m256 v) {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 scale = _mm256_set1_ps(UV_MAX);
+            const __m256i fu = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(u, zero), one), scale));
+            const __m256i fv = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(v, zero), one), scale));
+            return _mm256_or_si256(fu, _mm256_slli_epi32(fv, 16));
+        }
+
+        // Same math eight quads wide, the 48 byte stores go through the SSE transpose one half at a time.
+        // Deliberately no FMA so results stay bit identical to the other levels.
+        UFOX_TARGET_AVX2 size_t WriteQuadsAvx2(const QuadBatch& batch, std::byte* out) {
+            std::byte* const start = out;
+            size_t i = 0;
+            for (; i + 8 <= batch.count; i += 8) {
+                const __m256 x = _mm256_loadu_ps(&batch.x[i]);
+                const __m256 y = _mm256_loadu_ps(&batch.y[i]);
+                const __m256 sx = _mm256_loadu_ps(&batch.scaleX[i]);
+                const __m256 sy = _mm256_loadu_ps(&batch.scaleY[i]);
+                const __m256 tx = _mm256_loadu_ps(&batch.translateX[i]);
+                const __m256 ty = _mm256_loadu_ps(&batch.translateY[i]);
+
+                const __m256 x0 = _mm256_add_ps(tx, _mm256_mul_ps(sx, x));
+                const __m256 x1 = _mm256_add_ps(tx, _mm256_mul_ps(sx, _mm256_add_ps(x, _mm256_loadu_ps(&batch.width[i]))));
+                const __m256 y0 = _mm256_add_ps(ty, _mm256_mul_ps(sy, y));
+                const __m256 y1 = _mm256_add_ps(ty, _mm256_mul_ps(sy, _mm256_add_ps(y, _mm256_loadu_ps(&batch.height[i]))));
+
+                const __m256 cx0 = _mm256_max_ps(x0, _mm256_loadu_ps(&batch.clipMinX[i]));
+                const __m256 cx1 = _mm256_min_ps(x1, _mm256_loadu_ps(&batch.clipMaxX[i]));
+                const __m256 cy0 = _mm256_max_ps(y0, _mm256_loadu_ps(&batch.clipMinY[i]));
+                const __m256 cy1 = _mm256_min_ps(y1, _mm256_loadu_ps(&batch.clipMaxY[i]));
+                const __m256 inside = _mm256_and_ps(_mm256_cmp_ps(cx0, cx1, _CMP_LT_OQ), _mm256_cmp_ps(cy0, cy1, _CMP_LT_OQ));
+                const auto visible = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+                if (visible == 0) continue;
+
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 inverseWidth = _mm256_div_ps(one, _mm256_sub_ps(x1, x0));
+                const __m256 inverseHeight = _mm256_div_ps(one, _mm256_sub_ps(y1, y0));
+                const __m256 u0 = _mm256_mul_ps(_mm256_sub_ps(cx0, x0), inverseWidth);
+                const __m256 u1 = _mm256_mul_ps(_mm256_sub_ps(cx1, x0), inverseWidth);
+                const __m256 v0 = _mm256_mul_ps(_mm256_sub_ps(cy0, y0), inverseHeight);
+                const __m256 v1 = _mm256_mul_ps(_mm256_sub_ps(cy1, y0), inverseHeight);
+
+                const __m256i p00 = PackPosition8(cx0, cy0);
+                const __m256i p10 = PackPosition8(cx1, cy0);
+                const __m256i p11 = PackPosition8(cx1, cy1);
+                const __m256i p01 = PackPosition8(cx0, cy1);
+                const __m256i uv00 = PackUv8(u0, v0);
+                const __m256i uv10 = PackUv8(u1, v0);
+                const __m256i uv11 = PackUv8(u1, v1);
+                const __m256i uv01 = PackUv8(u0, v1);
+                const __m256i color = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.color[i]));
+
+                QuadLanes low{
+                    _mm256_castsi256_si128(p00), _mm256_castsi256_si128(p10), _mm256_castsi256_si128(p11), _mm256_castsi256_si128(p01),
+                    _mm256_castsi256_si128(uv00), _mm256_castsi256_si128(uv10), _mm256_castsi256_si128(uv11), _mm256_castsi256_si128(uv01),
+                    _mm256_castsi256_si128(color),
+                };
+                QuadLanes high{
+                    _mm256_extracti128_si256(p00, 1), _mm256_extracti128_si256(p10, 1), _mm256_extracti128_si256(p11, 1), _mm256_extracti128_si256(p01, 1),
+                    _mm256_extracti128_si256(uv00, 1), _mm256_extracti128_si256(uv10, 1), _mm256_extracti128_si256(uv11, 1), _mm256_extracti128_si256(uv01, 1),
+                    _mm256_extracti128_si256(color, 1),
+                };
+                if (visible & 0x0F) out = StoreQuads(low, visible & 0x0F, out);
+                if (visible & 0xF0) out = StoreQuads(high, visible >> 4, out);
+            }
+            const size_t written = static_cast<size_t>(out - start) / QUAD_BYTES;
+            return written + WriteQuadsScalar(batch, i, out);
+        }
+
+        bool HasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            // The OS has to save the upper halves of the ymm registers on context switches
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        SimdLevel DetectSimdLevel() {
+#if UFOX_QUAD_BATCH_X64
+            return HasAvx2() ? SimdLevel::Avx2 : SimdLevel::Sse2;
+#else
+            return SimdLevel::Scalar;
+#endif
+        }
+    }
+
+    const char* ToString(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::Scalar: return "scalar";
+            case SimdLevel::Sse2: return "sse2";
+            case SimdLevel::Avx2: return "avx2";
+        }
+        return "unknown";
+    }
+
+    SimdLevel GetSimdLevel() {
+        static const SimdLevel level = DetectSimdLevel();
+        return level;
+    }
+
+    size_t WriteQuads(const QuadBatch& batch, void* dst) {
+        return WriteQuads(GetSimdLevel(), batch, dst);
+    }
+
+    size_t WriteQuads(SimdLevel level, const QuadBatch& batch, void* dst) {
+        assert(ClipsInRange(batch) && "Clip rect outside the PackedVertex range");
+        auto* out = static_cast<std::byte*>(dst);
+        level = std::min(level, GetSimdLevel());
+        switch (level) {
+#if UFOX_QUAD_BATCH_X64
+            case SimdLevel::Avx2: return WriteQuadsAvx2(batch, out);
+            case SimdLevel::Sse2: return WriteQuadsSse2(batch, out);
+#endif
+            default: return WriteQuadsScalar(batch, 0, out);
+        }
+    }
+}
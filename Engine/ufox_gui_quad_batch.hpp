@@ -0,0 +1,58 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace ufox::renderer::gui {
+
+    enum class SimdLevel : uint32_t {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    [[nodiscard]] const char* ToString(SimdLevel level);
+    // Best level the CPU and OS support, detected once
+    [[nodiscard]] SimdLevel GetSimdLevel();
+
+    // Structure of arrays describing count GUI quads, every span holds at least count elements. Each element is
+    // a local rect scaled around the local origin and translated, the per element equivalent of the
+    // glm::translate * glm::scale chain in GraphicsDevice::updateUniformBuffer, then clipped against an axis
+    // aligned rect in target space. Scales are expected to be positive and clip rects to lie within
+    // +-PackedVertex::MAX_POSITION, debug builds assert on both ends of the range.
+    struct QuadBatch {
+        size_t count{0};
+
+        std::span<const float> x;
+        std::span<const float> y;
+        std::span<const float> width;
+        std::span<const float> height;
+
+        std::span<const float> scaleX;
+        std::span<const float> scaleY;
+        std::span<const float> translateX;
+        std::span<const float> translateY;
+
+        // RGBA8 with red in the lowest byte, copied as is into PackedVertex::color
+        std::span<const uint32_t> color;
+
+        std::span<const float> clipMinX;
+        std::span<const float> clipMinY;
+        std::span<const float> clipMaxX;
+        std::span<const float> clipMaxY;
+    };
+
+    // Four PackedVertex per quad in the order top-left, top-right, bottom-right, bottom-left, so the quad index
+    // pattern 0, 1, 2, 2, 3, 0 applies. Clipping moves the corners and their UVs, quads clipped away entirely are
+    // skipped and the output stays dense. dst must hold count * 4 vertices; it is written front to back once and
+    // never read, which suits write-combined mapped memory.
+    // Positions and UVs round to nearest even on every level, so all levels produce identical bytes.
+    // Returns the number of quads written.
+    size_t WriteQuads(const QuadBatch& batch, void* dst);
+    // Forces a level, e.g. for benchmarks. Levels the CPU lacks fall back to the best supported one
+    size_t WriteQuads(SimdLevel level, const QuadBatch& batch, void* dst);
+}
@@ -3,3 +3,147 @@
 //
 
 #include "ufox_gui_renderer.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace ufox::renderer::gui {
+    namespace {
+        int16_t ToFixedPoint(float value) {
+            // Out of range positions would fold onto the edge of the range, draw them through VertexLayout::Gui
+            assert(glm::abs(value) <= PackedVertex::MAX_POSITION && "Position outside the PackedVertex range");
+            float scaled = glm::round(value * PackedVertex::POSITION_SCALE);
+            return static_cast<int16_t>(glm::clamp(scaled, -32768.0f, 32767.0f));
+        }
+
+        uint8_t ToUnorm8(float value) {
+            return static_cast<uint8_t>(glm::round(glm::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+
+        uint16_t ToUnorm16(float value) {
+            return static_cast<uint16_t>(glm::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        Rect Intersect(const Rect& a, const Rect& b) {
+            glm::vec2 min = glm::max(a.position, b.position);
+            glm::vec2 max = glm::min(a.position + a.size, b.position + b.size);
+            return Rect{ min, glm::max(max - min, glm::vec2(0.0f)) };
+        }
+
+        bool SameRect(const Rect& a, const Rect& b) {
+            return a.position == b.position && a.size == b.size;
+        }
+    }
+
+    PackedVertex PackVertex(glm::vec2 position, glm::vec4 color, glm::vec2 texCoord) {
+        PackedVertex packed{};
+        packed.position[0] = ToFixedPoint(position.x);
+        packed.position[1] = ToFixedPoint(position.y);
+        packed.color[0] = ToUnorm8(color.r);
+        packed.color[1] = ToUnorm8(color.g);
+        packed.color[2] = ToUnorm8(color.b);
+        packed.color[3] = ToUnorm8(color.a);
+        packed.texCoord[0] = ToUnorm16(texCoord.x);
+        packed.texCoord[1] = ToUnorm16(texCoord.y);
+        return packed;
+    }
+
+    PackedVertex PackVertex(const Vertex &vertex) {
+        return PackVertex(vertex.position, vertex.color, vertex.texCoord);
+    }
+
+    PackedVertex PackVertex(const graphics::Vertex &vertex) {
+        // GUI geometry is flat, z only matters for the depth-tested 3D layout
+        return PackVertex(glm::vec2(vertex.position), vertex.color, vertex.texCoord);
+    }
+
+    Vertex UnpackVertex(const PackedVertex &vertex) {
+        Vertex unpacked{};
+        unpacked.position = glm::vec2(vertex.position[0], vertex.position[1]) / PackedVertex::POSITION_SCALE;
+        unpacked.color = glm::vec4(vertex.color[0], vertex.color[1], vertex.color[2], vertex.color[3]) / 255.0f;
+        unpacked.texCoord = glm::vec2(vertex.texCoord[0], vertex.texCoord[1]) / 65535.0f;
+        return unpacked;
+    }
+
+    uint32_t GetVertexStride(graphics::vulkan::VertexLayout layout) {
+        switch (layout) {
+            case graphics::vulkan::VertexLayout::Standard: return sizeof(graphics::Vertex);
+            case graphics::vulkan::VertexLayout::Gui: return sizeof(Vertex);
+            case graphics::vulkan::VertexLayout::GuiPacked: return sizeof(PackedVertex);
+            case graphics::vulkan::VertexLayout::Path: return sizeof(PathVertex);
+        }
+        return 0;
+    }
+
+    void WriteVertices(graphics::vulkan::VertexLayout layout, std::span<const graphics::Vertex> vertices, void *dst) {
+        auto* out = static_cast<uint8_t*>(dst);
+        switch (layout) {
+            case graphics::vulkan::VertexLayout::Standard:
+                std::memcpy(out, vertices.data(), vertices.size_bytes());
+                break;
+            case graphics::vulkan::VertexLayout::Gui:
+                for (const auto& vertex : vertices) {
+                    Vertex guiVertex{ glm::vec2(vertex.position), vertex.color, vertex.texCoord };
+                    std::memcpy(out, &guiVertex, sizeof(guiVertex));
+                    out += sizeof(guiVertex);
+                }
+                break;
+            case graphics::vulkan::VertexLayout::GuiPacked:
+                for (const auto& vertex : vertices) {
+                    PackedVertex packed = PackVertex(vertex);
+                    std::memcpy(out, &packed, sizeof(packed));
+                    out += sizeof(packed);
+                }
+                break;
+            case graphics::vulkan::VertexLayout::Path:
+                // Path quads reference geometry blocks, only PathRenderer can produce them
+                throw std::invalid_argument("The Path vertex layout is written by PathRenderer");
+        }
+    }
+
+    std::vector<graphics::vulkan::SpecializationConstant> GetLayoutSpecialization(graphics::vulkan::VertexLayout layout) {
+        if (layout != graphics::vulkan::VertexLayout::GuiPacked) return {};
+        return { { PackedVertex::POSITION_SCALE_CONSTANT_ID, std::bit_cast<uint32_t>(1.0f / PackedVertex::POSITION_SCALE) } };
+    }
+
+    void ClipStack::reset(vk::Extent2D framebuffer) {
+        this->framebuffer = framebuffer;
+        regions.clear();
+        regions.push_back(ClipRegion{ Rect{ glm::vec2(0.0f), glm::vec2(framebuffer.width, framebuffer.height) }, glm::vec4(0.0f), 0 });
+        table.clear();
+        table.push_back(graphics::NoClip);
+    }
+
+    void ClipStack::push(const Rect& rect, glm::vec4 radius) {
+        const ClipRegion& parent = regions.back();
+        ClipRegion region{ Intersect(parent.rect, rect), glm::vec4(0.0f), static_cast<uint32_t>(table.size()) };
+        if (SameRect(region.rect, rect)) region.radius = radius;
+        else if (SameRect(region.rect, parent.rect)) region.radius = parent.radius;
+        regions.push_back(region);
+        table.push_back(graphics::ClipParams{ glm::vec4(region.rect.position, region.rect.size), region.radius });
+    }
+
+    void ClipStack::pop() {
+        if (regions.size() > 1) regions.pop_back();
+    }
+
+    vk::Rect2D ClipStack::getScissor(const Rect& bounds) const {
+        const vk::Rect2D full{ {0, 0}, framebuffer };
+        if (regions.size() == 1) return full;
+
+        const Rect& clip = regions.back().rect;
+        float area = bounds.size.x * bounds.size.y;
+        Rect visible = Intersect(bounds, clip);
+        float discarded = area - visible.size.x * visible.size.y;
+        if (discarded < SCISSOR_MIN_AREA || discarded < area * SCISSOR_DISCARD_RATIO) return full;
+
+        // Snap outwards so the shader clip still produces the anti-aliased edge
+        glm::vec2 min = glm::max(glm::floor(clip.position), glm::vec2(0.0f));
+        glm::vec2 max = glm::min(glm::ceil(clip.position + clip.size), glm::vec2(framebuffer.width, framebuffer.height));
+        if (max.x <= min.x || max.y <= min.y) return vk::Rect2D{ {0, 0}, {0, 0} };
+        return vk::Rect2D{ { static_cast<int32_t>(min.x), static_cast<int32_t>(min.y) },
+                           { static_cast<uint32_t>(max.x - min.x), static_cast<uint32_t>(max.y - min.y) } };
+    }
+}
@@ -2,6 +2,7 @@
 // Created by b-boy on 04.05.2025.
 //
 #pragma once
+#include <span>
 #include <glm/glm.hpp>
 #include <Engine/ufox_graphic.hpp>
 
@@ -39,6 +40,103 @@ namespace ufox::renderer::gui {
         }
     };
 
+    // 12 bytes instead of 32/36: 14.2 fixed-point position, RGBA8 color and unorm16 UVs.
+    // Quarter pixel precision over +-8192 px, enough for an 8K target. Positions arrive in the shader scaled by
+    // POSITION_SCALE, pipelines using this layout undo it through the POSITION_SCALE_CONSTANT_ID specialization
+    // constant in shader.vert.
+    struct PackedVertex {
+        static constexpr float POSITION_SCALE = 4.0f;
+        static constexpr float MAX_POSITION = 32767.0f / POSITION_SCALE;
+        static constexpr uint32_t POSITION_SCALE_CONSTANT_ID = 0;
+
+        int16_t position[2];
+        uint8_t color[4];
+        uint16_t texCoord[2];
+
+        static vk::VertexInputBindingDescription getBindingDescription() {
+            vk::VertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 0;
+            bindingDescription.stride = sizeof(PackedVertex);
+            bindingDescription.inputRate = vk::VertexInputRate::eVertex;
+            return bindingDescription;
+        }
+
+        static std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions() {
+            std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions{};
+            attributeDescriptions[0].binding = 0;
+            attributeDescriptions[0].location = 0;
+            attributeDescriptions[0].format = vk::Format::eR16G16Sscaled;
+            attributeDescriptions[0].offset = offsetof(PackedVertex, position);
+
+            attributeDescriptions[1].binding = 0;
+            attributeDescriptions[1].location = 1;
+            attributeDescriptions[1].format = vk::Format::eR8G8B8A8Unorm;
+            attributeDescriptions[1].offset = offsetof(PackedVertex, color);
+
+            attributeDescriptions[2].binding = 0;
+            attributeDescriptions[2].location = 2;
+            attributeDescriptions[2].format = vk::Format::eR16G16Unorm;
+            attributeDescriptions[2].offset = offsetof(PackedVertex, texCoord);
+            return attributeDescriptions;
+        }
+    };
+
+    static_assert(sizeof(PackedVertex) == 12, "PackedVertex must stay tightly packed");
+
+    // Corner of a path's bounding quad. local is the same corner in path space, block the first vec4 of the
+    // path's geometry in the PathRenderer storage buffer, see Shaders/path.frag.
+    struct PathVertex {
+        float position[2];
+        uint8_t color[4];
+        float local[2];
+        uint32_t block;
+
+        static vk::VertexInputBindingDescription getBindingDescription() {
+            vk::VertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 0;
+            bindingDescription.stride = sizeof(PathVertex);
+            bindingDescription.inputRate = vk::VertexInputRate::eVertex;
+            return bindingDescription;
+        }
+
+        static std::array<vk::VertexInputAttributeDescription, 4> getAttributeDescriptions() {
+            std::array<vk::VertexInputAttributeDescription, 4> attributeDescriptions{};
+            attributeDescriptions[0].binding = 0;
+            attributeDescriptions[0].location = 0;
+            attributeDescriptions[0].format = vk::Format::eR32G32Sfloat;
+            attributeDescriptions[0].offset = offsetof(PathVertex, position);
+
+            attributeDescriptions[1].binding = 0;
+            attributeDescriptions[1].location = 1;
+            attributeDescriptions[1].format = vk::Format::eR8G8B8A8Unorm;
+            attributeDescriptions[1].offset = offsetof(PathVertex, color);
+
+            attributeDescriptions[2].binding = 0;
+            attributeDescriptions[2].location = 2;
+            attributeDescriptions[2].format = vk::Format::eR32G32Sfloat;
+            attributeDescriptions[2].offset = offsetof(PathVertex, local);
+
+            attributeDescriptions[3].binding = 0;
+            attributeDescriptions[3].location = 3;
+            attributeDescriptions[3].format = vk::Format::eR32Uint;
+            attributeDescriptions[3].offset = offsetof(PathVertex, block);
+            return attributeDescriptions;
+        }
+    };
+
+    static_assert(sizeof(PathVertex) == 24, "PathVertex must stay tightly packed");
+
+    [[nodiscard]] PackedVertex PackVertex(glm::vec2 position, glm::vec4 color, glm::vec2 texCoord);
+    [[nodiscard]] PackedVertex PackVertex(const Vertex& vertex);
+    [[nodiscard]] PackedVertex PackVertex(const graphics::Vertex& vertex);
+    [[nodiscard]] Vertex UnpackVertex(const PackedVertex& vertex);
+
+    [[nodiscard]] uint32_t GetVertexStride(graphics::vulkan::VertexLayout layout);
+    // Encodes vertices in the layout a pipeline expects, dst must hold vertices.size() * GetVertexStride(layout) bytes
+    void WriteVertices(graphics::vulkan::VertexLayout layout, std::span<const graphics::Vertex> vertices, void* dst);
+    // Specialization constants a pipeline needs to consume the given layout with shader.vert
+    [[nodiscard]] std::vector<graphics::vulkan::SpecializationConstant> GetLayoutSpecialization(graphics::vulkan::VertexLayout layout);
+
     struct Size {
         int width;
         int height;
@@ -72,12 +170,68 @@ namespace ufox::renderer::gui {
 
     };
 
+    // Frosted glass: what was drawn behind the node shows through blurred, see EffectsRenderer
+    struct BackdropFilter {
+        float blurRadius;
+        glm::vec4 tint;         // alpha is the tint strength, 0 shows the plain blur
+    };
+
+    // Analytic shadow of the node's rounded box, see EffectsRenderer
+    struct DropShadow {
+        glm::vec2 offset;
+        float blurRadius;
+        float spread;           // grows the box before blurring, negative shrinks it
+        glm::vec4 color;
+    };
+
+    struct ClipRegion {
+        Rect rect;
+        glm::vec4 radius;       // per-corner, 0 for a plain axis-aligned clip
+        uint32_t index;         // entry in the clip table, 0 is the unclipped root
+    };
+
+    // Nested clip regions for scroll views and clipped containers. Every push adds an entry to a per-frame clip
+    // table that goes to GraphicsDevice::setClipRegions. Draws store getClipIndex for each vertex in the clip
+    // stream parallel to their vertex buffer, the fragment shader looks the region up there. Push constants and
+    // uniforms stay identical across clips, so siblings under different clips still merge in the DrawList.
+    // A scissor is only worth a batch break when most of a draw would be shaded and then clipped away.
+    class ClipStack {
+    public:
+        void reset(vk::Extent2D framebuffer);
+
+        // Intersects with the current region. Rounded corners survive only where the new rect is the tighter one,
+        // an ancestor that cuts into it leaves square corners.
+        void push(const Rect& rect, glm::vec4 radius = glm::vec4(0.0f));
+        void pop();
+
+        [[nodiscard]] const ClipRegion& current() const { return regions.back(); }
+        [[nodiscard]] size_t depth() const { return regions.size() - 1; }
+        // True when nothing inside the current region can be visible
+        [[nodiscard]] bool isEmpty() const { return current().rect.size.x <= 0.0f || current().rect.size.y <= 0.0f; }
+
+        // Clip table entry of the current region, the root region disables shader clipping
+        [[nodiscard]] uint32_t getClipIndex() const { return current().index; }
+        // Every region pushed since reset, indexed by getClipIndex, entry 0 is graphics::NoClip
+        [[nodiscard]] std::span<const graphics::ClipParams> getTable() const { return table; }
+        // Full framebuffer unless the clip discards more than SCISSOR_DISCARD_RATIO of bounds
+        [[nodiscard]] vk::Rect2D getScissor(const Rect& bounds) const;
+
+    private:
+        static constexpr float SCISSOR_DISCARD_RATIO = 0.5f;
+        static constexpr float SCISSOR_MIN_AREA = 64.0f * 64.0f;
+
+        vk::Extent2D framebuffer{0, 0};
+        std::vector<ClipRegion> regions{ ClipRegion{} };
+        std::vector<graphics::ClipParams> table{ graphics::NoClip };
+    };
+
     class GUIRenderer {
 
         GUIRenderer();
         ~GUIRenderer();
 
     private:
+        ClipStack clipStack{};
 
         std::optional<vk::raii::DescriptorSetLayout> descriptorSetLayout{};
         std::optional<vk::raii::PipelineLayout> pipelineLayout{};
@@ -0,0 +1,44 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace ufox::hash {
+
+    static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    static constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    // FNV-1a, stable across runs and platforms so it can key on-disk caches
+    constexpr uint64_t Fnv1a64(const void* data, size_t size, uint64_t seed = FNV_OFFSET_BASIS) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    constexpr uint64_t Fnv1a64(std::string_view text, uint64_t seed = FNV_OFFSET_BASIS) {
+        uint64_t hash = seed;
+        for (char c : text) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    uint64_t Fnv1a64(std::span<const T> values, uint64_t seed = FNV_OFFSET_BASIS) {
+        return Fnv1a64(values.data(), values.size_bytes(), seed);
+    }
+
+    constexpr uint64_t Combine(uint64_t seed, uint64_t value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+}
@@ -7,32 +7,121 @@
 
 
 namespace ufox {
-    glm::vec2 InputSystem::getMousePosition() const {
-        return {currentLocalMouseX, currentLocalMouseY};
+    void InputSystem::record(const SDL_Event &event) {
+        InputEvent input{};
+        input.timestamp = event.common.timestamp;
+
+        switch (event.type) {
+            case SDL_EVENT_MOUSE_MOTION: {
+                input.type = InputEventType::MouseMotion;
+                input.position = {event.motion.x, event.motion.y};
+                input.delta = {event.motion.xrel, event.motion.yrel};
+                break;
+            }
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            case SDL_EVENT_MOUSE_BUTTON_UP: {
+                input.type = event.button.down ? InputEventType::MouseButtonDown : InputEventType::MouseButtonUp;
+                input.button = event.button.button;
+                input.clicks = event.button.clicks;
+                input.position = {event.button.x, event.button.y};
+                break;
+            }
+            case SDL_EVENT_MOUSE_WHEEL: {
+                float direction = event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1.0f : 1.0f;
+                input.type = InputEventType::MouseWheel;
+                input.position = {event.wheel.mouse_x, event.wheel.mouse_y};
+                input.delta = glm::vec2(event.wheel.x, event.wheel.y) * direction;
+                break;
+            }
+            case SDL_EVENT_KEY_DOWN:
+            case SDL_EVENT_KEY_UP: {
+                input.type = event.key.down ? InputEventType::KeyDown : InputEventType::KeyUp;
+                input.scancode = event.key.scancode;
+                input.modifiers = event.key.mod;
+                input.repeat = event.key.repeat;
+                break;
+            }
+            default:
+                return;
+        }
+
+        record(input);
     }
 
-    void InputSystem::updateMousePositionInsideWindow() {
-        SDL_GetMouseState(&currentLocalMouseX, &currentLocalMouseY);
-        //fmt::println("position inside x:{} y:{}", currentLocalMouseX, currentLocalMouseY);
+    void InputSystem::record(const InputEvent &event) {
+        if (!events.push(event))
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
     }
 
-    void InputSystem::updateMousePositionOutsideWindow(SDL_Window *window) {
-        if (!mouseIsOutSideWindow) return;
-        SDL_GetGlobalMouseState(&currentGlobalMouseX, &currentGlobalMouseY);
-        if (currentGlobalMouseX == previousGlobalMouseX && currentGlobalMouseY == previousGlobalMouseY) return;
-
-        int xPos,yPos;
-        SDL_GetWindowPosition(window, &xPos, &yPos);
-        currentLocalMouseX = currentGlobalMouseX - xPos;
-        currentLocalMouseY = currentGlobalMouseY - yPos;
-        previousGlobalMouseX = currentGlobalMouseX;
-        previousGlobalMouseY = currentGlobalMouseY;
-        //fmt::println("position outside x:{} y:{}", currentLocalMouseX, currentLocalMouseY);
+    void InputSystem::beginFrame() {
+        // Only the per-frame edges reset, held state carries over
+        snapshot.mouseDelta = glm::vec2(0.0f);
+        snapshot.wheel = glm::vec2(0.0f);
+        snapshot.buttonsPressed = 0;
+        snapshot.buttonsReleased = 0;
+        snapshot.keysPressed.reset();
+        snapshot.keysReleased.reset();
+
+        // Both vectors keep their capacity, steady state input handling does not allocate
+        frameEvents.clear();
+        coalescedEvents.clear();
+
+        events.drain([this](const InputEvent& event) {
+            frameEvents.push_back(event);
+            apply(event);
+
+            if (event.type == InputEventType::MouseMotion && !coalescedEvents.empty() &&
+                coalescedEvents.back().type == InputEventType::MouseMotion) {
+                InputEvent& merged = coalescedEvents.back();
+                merged.timestamp = event.timestamp;
+                merged.position = event.position;
+                merged.delta += event.delta;
+                return;
+            }
+            coalescedEvents.push_back(event);
+        });
     }
 
-    void InputSystem::EnabledMousePositionOutside(bool state) {
-            if (mouseIsOutSideWindow != state)
-                mouseIsOutSideWindow = state;
+    void InputSystem::apply(const InputEvent &event) {
+        snapshot.timestamp = event.timestamp;
+
+        switch (event.type) {
+            case InputEventType::MouseMotion: {
+                snapshot.mousePosition = event.position;
+                snapshot.mouseDelta += event.delta;
+                break;
+            }
+            case InputEventType::MouseButtonDown: {
+                snapshot.mousePosition = event.position;
+                snapshot.buttonsDown |= SDL_BUTTON_MASK(event.button);
+                snapshot.buttonsPressed |= SDL_BUTTON_MASK(event.button);
+                break;
+            }
+            case InputEventType::MouseButtonUp: {
+                snapshot.mousePosition = event.position;
+                snapshot.buttonsDown &= ~SDL_BUTTON_MASK(event.button);
+                snapshot.buttonsReleased |= SDL_BUTTON_MASK(event.button);
+                break;
+            }
+            case InputEventType::MouseWheel: {
+                snapshot.wheel += event.delta;
+                break;
+            }
+            case InputEventType::KeyDown: {
+                snapshot.modifiers = event.modifiers;
+                if (event.scancode >= SDL_SCANCODE_COUNT) break;
+                if (!event.repeat) snapshot.keysPressed.set(event.scancode);
+                snapshot.keysDown.set(event.scancode);
+                break;
+            }
+            case InputEventType::KeyUp: {
+                snapshot.modifiers = event.modifiers;
+                if (event.scancode >= SDL_SCANCODE_COUNT) break;
+                snapshot.keysDown.reset(event.scancode);
+                snapshot.keysReleased.set(event.scancode);
+                break;
+            }
+        }
     }
 
 }
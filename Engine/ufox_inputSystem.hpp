@@ -2,35 +2,94 @@
 // Created by b-boy on 03.05.2025.
 //
 
+#pragma once
+#include <atomic>
+#include <bitset>
+#include <span>
+#include <vector>
 #include <SDL3/SDL_mouse.h>
 #include <glm/glm.hpp>
 
 #include "SDL3/SDL_events.h"
 #include <fmt/core.h>
+#include "Engine/ufox_spsc_ring.hpp"
 
 namespace ufox {
+    enum class InputEventType : uint8_t {
+        MouseMotion,
+        MouseButtonDown,
+        MouseButtonUp,
+        MouseWheel,
+        KeyDown,
+        KeyUp,
+    };
+
+    struct InputEvent {
+        uint64_t timestamp;         // SDL event time in nanoseconds
+        InputEventType type;
+        uint8_t button;             // SDL_BUTTON_* for button events, click count in clicks
+        uint8_t clicks;
+        bool repeat;                // key auto-repeat
+        SDL_Scancode scancode;
+        SDL_Keymod modifiers;
+        glm::vec2 position;         // window-local mouse position
+        glm::vec2 delta;            // motion relative movement or wheel scroll amount
+    };
+
+    // Everything a frame needs to answer "is this held / was this pressed" in O(1)
+    struct InputSnapshot {
+        uint64_t timestamp{0};      // newest event folded into this snapshot
+        glm::vec2 mousePosition{0.0f};
+        glm::vec2 mouseDelta{0.0f};
+        glm::vec2 wheel{0.0f};
+        SDL_MouseButtonFlags buttonsDown{0};
+        SDL_MouseButtonFlags buttonsPressed{0};
+        SDL_MouseButtonFlags buttonsReleased{0};
+        std::bitset<SDL_SCANCODE_COUNT> keysDown{};
+        std::bitset<SDL_SCANCODE_COUNT> keysPressed{};
+        std::bitset<SDL_SCANCODE_COUNT> keysReleased{};
+        SDL_Keymod modifiers{SDL_KMOD_NONE};
+
+        [[nodiscard]] bool isButtonDown(uint8_t button) const { return buttonsDown & SDL_BUTTON_MASK(button); }
+        [[nodiscard]] bool wasButtonPressed(uint8_t button) const { return buttonsPressed & SDL_BUTTON_MASK(button); }
+        [[nodiscard]] bool wasButtonReleased(uint8_t button) const { return buttonsReleased & SDL_BUTTON_MASK(button); }
+        [[nodiscard]] bool isKeyDown(SDL_Scancode key) const { return keysDown.test(key); }
+        [[nodiscard]] bool wasKeyPressed(SDL_Scancode key) const { return keysPressed.test(key); }
+        [[nodiscard]] bool wasKeyReleased(SDL_Scancode key) const { return keysReleased.test(key); }
+    };
+
     class InputSystem {
 
         public:
 
-        glm::vec2 getMousePosition() const;
+        // Producer side, call from the thread pumping SDL events. Never blocks, events are dropped when the
+        // consumer falls more than EVENT_CAPACITY events behind.
+        void record(const SDL_Event& event);
+        // Same, for events synthesized by the platform layer such as mouse motion tracked outside the window
+        void record(const InputEvent& event);
 
+        // Consumer side, call once per frame. Drains the ring and rebuilds the frame's snapshot and event lists,
+        // which stay untouched until the next beginFrame so GUI, game logic and jobs can read them without locks.
+        void beginFrame();
 
-        void updateMousePositionInsideWindow();
-        void updateMousePositionOutsideWindow(SDL_Window *window);
-        void EnabledMousePositionOutside(bool state);
+        [[nodiscard]] const InputSnapshot& getSnapshot() const { return snapshot; }
+        // Window-local position as of the last beginFrame, EngineRuntime keeps it moving outside the window
+        [[nodiscard]] glm::vec2 getMousePosition() const { return snapshot.mousePosition; }
+        // Every event recorded since the previous frame, in order, for gesture code that needs the full path
+        [[nodiscard]] std::span<const InputEvent> getFrameEvents() const { return frameEvents; }
+        // Same events with consecutive motion merged into one, delta summed and the newest position kept
+        [[nodiscard]] std::span<const InputEvent> getCoalescedEvents() const { return coalescedEvents; }
+        [[nodiscard]] uint64_t getDroppedEventCount() const { return droppedEvents.load(std::memory_order_relaxed); }
 
         private:
+        static constexpr size_t EVENT_CAPACITY = 1024;
 
-        bool mouseIsOutSideWindow{true};
-        float previousGlobalMouseX;
-        float previousGlobalMouseY;
-        float currentGlobalMouseX;
-        float currentGlobalMouseY;
-        float currentLocalMouseX;
-        float currentLocalMouseY;
-
-
+        SpscRing<InputEvent, EVENT_CAPACITY> events{};
+        std::atomic<uint64_t> droppedEvents{0};
+        InputSnapshot snapshot{};
+        std::vector<InputEvent> frameEvents;
+        std::vector<InputEvent> coalescedEvents;
 
+        void apply(const InputEvent& event);
     };
-}
\ No newline at end of file
+}
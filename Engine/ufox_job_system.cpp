@@ -0,0 +1,69 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_job_system.hpp"
+
+#include <algorithm>
+
+namespace ufox::jobs {
+    JobSystem::JobSystem(uint32_t threadCount) {
+        if (threadCount == 0) {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+        }
+
+        workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    void JobSystem::waitIdle() {
+        std::unique_lock lock(mutex);
+        idleCondition.wait(lock, [this] { return queue.empty() && activeJobs == 0; });
+    }
+
+    void JobSystem::enqueue(std::function<void()> job) {
+        {
+            std::lock_guard lock(mutex);
+            queue.emplace_back(std::move(job));
+        }
+        wakeCondition.notify_one();
+    }
+
+    void JobSystem::workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(mutex);
+                wakeCondition.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (stopping && queue.empty()) return;
+
+                job = std::move(queue.front());
+                queue.pop_front();
+                ++activeJobs;
+            }
+
+            // packaged_task stores exceptions in its future, so nothing escapes here
+            job();
+
+            {
+                std::lock_guard lock(mutex);
+                --activeJobs;
+                if (queue.empty() && activeJobs == 0) idleCondition.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ufox::jobs {
+
+    class JobSystem {
+    public:
+        // threadCount 0 picks hardware_concurrency - 1, leaving a core for the main thread
+        explicit JobSystem(uint32_t threadCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        template<typename F>
+        auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+            std::future<Result> future = task->get_future();
+            enqueue([task] { (*task)(); });
+            return future;
+        }
+
+        void waitIdle();
+        [[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> queue;
+        std::mutex mutex;
+        std::condition_variable wakeCondition;
+        std::condition_variable idleCondition;
+        uint32_t activeJobs{0};
+        bool stopping{false};
+
+        void enqueue(std::function<void()> job);
+        void workerLoop();
+    };
+}
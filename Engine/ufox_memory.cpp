@@ -0,0 +1,242 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_memory.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <new>
+
+#ifdef UFOX_COUNT_ALLOCATIONS
+namespace {
+    // Constant initialized, operator new runs before any dynamic initializer
+    constinit std::atomic<uint64_t> globalCount{0};
+    constinit std::atomic<uint64_t> globalBytes{0};
+
+    void* AllocateRaw(size_t size, size_t alignment) noexcept {
+        if (size == 0) size = 1;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return std::malloc(size);
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+
+    void FreeRaw(void* p, size_t alignment) noexcept {
+#ifdef _WIN32
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            _aligned_free(p);
+            return;
+        }
+#endif
+        std::free(p);
+    }
+
+    void* CountedNew(size_t size, size_t alignment) {
+        globalCount.fetch_add(1, std::memory_order_relaxed);
+        globalBytes.fetch_add(size, std::memory_order_relaxed);
+        while (true) {
+            if (void* p = AllocateRaw(size, alignment)) return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void* CountedNewNothrow(size_t size, size_t alignment) noexcept {
+        try {
+            return CountedNew(size, alignment);
+        }
+        catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+// Replaceable global allocation functions, every form routes through CountedNew and FreeRaw
+void* operator new(size_t size) { return CountedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return CountedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return CountedNew(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedNew(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedNewNothrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedNewNothrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedNewNothrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedNewNothrow(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* p) noexcept { FreeRaw(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* p) noexcept { FreeRaw(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* p, size_t) noexcept { FreeRaw(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* p, size_t) noexcept { FreeRaw(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { FreeRaw(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { FreeRaw(p, static_cast<size_t>(alignment)); }
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept { FreeRaw(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept { FreeRaw(p, static_cast<size_t>(alignment)); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { FreeRaw(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { FreeRaw(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { FreeRaw(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { FreeRaw(p, static_cast<size_t>(alignment)); }
+#endif
+
+namespace ufox::memory {
+    namespace {
+        CountingResource& HeapResource() {
+            static CountingResource resource{};
+            return resource;
+        }
+
+        size_t AlignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    std::pmr::memory_resource* GetHeapResource() {
+        return &HeapResource();
+    }
+
+    AllocationStats GetHeapStats() {
+        return HeapResource().getStats();
+    }
+
+    AllocationStats GetAllocationStats() {
+#ifdef UFOX_COUNT_ALLOCATIONS
+        return { globalCount.load(std::memory_order_relaxed), globalBytes.load(std::memory_order_relaxed) };
+#else
+        return GetHeapStats();
+#endif
+    }
+
+#pragma region CountingResource
+    void* CountingResource::do_allocate(size_t size, size_t alignment) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        return upstream->allocate(size, alignment);
+    }
+
+    void CountingResource::do_deallocate(void *p, size_t size, size_t alignment) {
+        upstream->deallocate(p, size, alignment);
+    }
+#pragma endregion
+
+#pragma region LinearArena
+    LinearArena::LinearArena(size_t capacity, std::pmr::memory_resource *upstream) : upstream{upstream}, capacity{capacity} {
+        if (capacity > 0) buffer = static_cast<std::byte*>(upstream->allocate(capacity, alignof(std::max_align_t)));
+    }
+
+    LinearArena::~LinearArena() {
+        releaseOverflow();
+        if (buffer) upstream->deallocate(buffer, capacity, alignof(std::max_align_t));
+    }
+
+    void LinearArena::reset() {
+        peak = std::max(peak, used + overflowBytes);
+
+        if (overflow) {
+            releaseOverflow();
+            // Grow once to the observed peak so the next frames fit without touching upstream
+            size_t grown = std::bit_ceil(peak);
+            if (buffer) upstream->deallocate(buffer, capacity, alignof(std::max_align_t));
+            buffer = static_cast<std::byte*>(upstream->allocate(grown, alignof(std::max_align_t)));
+            capacity = grown;
+        }
+
+        used = 0;
+        overflowBytes = 0;
+        overflowCount = 0;
+    }
+
+    void* LinearArena::do_allocate(size_t size, size_t alignment) {
+        size_t offset = AlignUp(reinterpret_cast<uintptr_t>(buffer) + used, alignment) - reinterpret_cast<uintptr_t>(buffer);
+        if (buffer && offset + size <= capacity) {
+            used = offset + size;
+            return buffer + offset;
+        }
+
+        // Header sits in front of the payload, padded to keep the payload aligned
+        size_t blockAlignment = std::max(alignment, alignof(OverflowBlock));
+        size_t headerSize = AlignUp(sizeof(OverflowBlock), blockAlignment);
+        auto* raw = static_cast<std::byte*>(upstream->allocate(headerSize + size, blockAlignment));
+        auto* block = reinterpret_cast<OverflowBlock*>(raw + headerSize - sizeof(OverflowBlock));
+        block->next = overflow;
+        block->size = headerSize + size;
+        block->alignment = blockAlignment;
+        overflow = block;
+        overflowBytes += size;
+        ++overflowCount;
+        return raw + headerSize;
+    }
+
+    void LinearArena::releaseOverflow() {
+        while (overflow) {
+            OverflowBlock* next = overflow->next;
+            size_t headerSize = AlignUp(sizeof(OverflowBlock), overflow->alignment);
+            std::byte* raw = reinterpret_cast<std::byte*>(overflow) + sizeof(OverflowBlock) - headerSize;
+            upstream->deallocate(raw, overflow->size, overflow->alignment);
+            overflow = next;
+        }
+    }
+#pragma endregion
+
+#pragma region FrameArenas
+    FrameArenas::FrameArenas(size_t capacityPerFrame, uint32_t frameCount) {
+        arenas.reserve(frameCount);
+        for (uint32_t i = 0; i < frameCount; ++i)
+            arenas.push_back(std::make_unique<LinearArena>(capacityPerFrame));
+    }
+
+    LinearArena& FrameArenas::beginFrame(uint32_t frameIndex) {
+        currentIndex = frameIndex;
+        arenas[currentIndex]->reset();
+        return *arenas[currentIndex];
+    }
+#pragma endregion
+
+#pragma region PoolResource
+    PoolResource::PoolResource(size_t blockSize, size_t blocksPerChunk, std::pmr::memory_resource *upstream) :
+        upstream{upstream},
+        blockSize{AlignUp(std::max(blockSize, sizeof(FreeBlock)), BLOCK_ALIGNMENT)},
+        blocksPerChunk{std::max<size_t>(blocksPerChunk, 1)} {}
+
+    PoolResource::~PoolResource() {
+        for (void* chunk : chunks)
+            upstream->deallocate(chunk, blockSize * blocksPerChunk, BLOCK_ALIGNMENT);
+    }
+
+    void* PoolResource::do_allocate(size_t size, size_t alignment) {
+        if (size > blockSize || alignment > BLOCK_ALIGNMENT) return upstream->allocate(size, alignment);
+
+        if (!freeList) grow();
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        ++liveCount;
+        return block;
+    }
+
+    void PoolResource::do_deallocate(void *p, size_t size, size_t alignment) {
+        if (size > blockSize || alignment > BLOCK_ALIGNMENT) {
+            upstream->deallocate(p, size, alignment);
+            return;
+        }
+
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = freeList;
+        freeList = block;
+        --liveCount;
+    }
+
+    void PoolResource::grow() {
+        auto* chunk = static_cast<std::byte*>(upstream->allocate(blockSize * blocksPerChunk, BLOCK_ALIGNMENT));
+        chunks.push_back(chunk);
+
+        // Thread the new blocks so they are handed out in address order
+        for (size_t i = blocksPerChunk; i-- > 0;) {
+            auto* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+#pragma endregion
+}
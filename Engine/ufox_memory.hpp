@@ -0,0 +1,142 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace ufox::memory {
+
+    struct AllocationStats {
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+#ifdef UFOX_COUNT_ALLOCATIONS
+    constexpr bool COUNTS_GLOBAL_ALLOCATIONS = true;
+#else
+    constexpr bool COUNTS_GLOBAL_ALLOCATIONS = false;
+#endif
+
+    // Heap behind every arena and pool. Anything reaching it after warm-up is an allocation a hot path still
+    // performs, so it is counted.
+    [[nodiscard]] std::pmr::memory_resource* GetHeapResource();
+    [[nodiscard]] AllocationStats GetHeapStats();
+    // Every global operator new on any thread, STL containers and third-party code included. Builds with
+    // UFOX_COUNT_ALLOCATIONS replace the global operators to count them, other builds fall back to GetHeapStats.
+    [[nodiscard]] AllocationStats GetAllocationStats();
+
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) : upstream{upstream} {}
+
+        [[nodiscard]] AllocationStats getStats() const {
+            return { count.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        std::pmr::memory_resource* upstream;
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    // Bump allocator released all at once by reset. deallocate is a no-op. When a frame needs more than the
+    // capacity the excess comes from upstream and the arena grows to the peak on the next reset, so a steady
+    // workload stops touching the heap after its first frames. Not thread safe, one arena per thread.
+    class LinearArena : public std::pmr::memory_resource {
+    public:
+        explicit LinearArena(size_t capacity, std::pmr::memory_resource* upstream = GetHeapResource());
+        ~LinearArena() override;
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        void reset();
+
+        [[nodiscard]] size_t getUsed() const { return used + overflowBytes; }
+        [[nodiscard]] size_t getCapacity() const { return capacity; }
+        [[nodiscard]] size_t getPeak() const { return peak; }
+        // Upstream allocations since the last reset
+        [[nodiscard]] uint32_t getOverflowCount() const { return overflowCount; }
+
+    private:
+        struct OverflowBlock {
+            OverflowBlock* next;
+            size_t size;
+            size_t alignment;
+        };
+
+        std::pmr::memory_resource* upstream;
+        std::byte* buffer{nullptr};
+        size_t capacity;
+        size_t used{0};
+        size_t peak{0};
+        OverflowBlock* overflow{nullptr};
+        size_t overflowBytes{0};
+        uint32_t overflowCount{0};
+
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+        void releaseOverflow();
+    };
+
+    // One arena per frame in flight, beginFrame resets the arena of a frame whose fence has signaled
+    class FrameArenas {
+    public:
+        FrameArenas(size_t capacityPerFrame, uint32_t frameCount);
+
+        LinearArena& beginFrame(uint32_t frameIndex);
+        [[nodiscard]] LinearArena& current() { return *arenas[currentIndex]; }
+
+    private:
+        std::vector<std::unique_ptr<LinearArena>> arenas;
+        uint32_t currentIndex{0};
+    };
+
+    // Free-list pool for fixed-size objects such as GUI nodes. Requests larger than the block size or with
+    // stricter alignment fall through to upstream. Not thread safe.
+    class PoolResource : public std::pmr::memory_resource {
+    public:
+        PoolResource(size_t blockSize, size_t blocksPerChunk = 256, std::pmr::memory_resource* upstream = GetHeapResource());
+        ~PoolResource() override;
+
+        PoolResource(const PoolResource&) = delete;
+        PoolResource& operator=(const PoolResource&) = delete;
+
+        [[nodiscard]] size_t getBlockSize() const { return blockSize; }
+        [[nodiscard]] size_t getLiveCount() const { return liveCount; }
+        [[nodiscard]] size_t getChunkCount() const { return chunks.size(); }
+
+    private:
+        static constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        std::pmr::memory_resource* upstream;
+        size_t blockSize;
+        size_t blocksPerChunk;
+        FreeBlock* freeList{nullptr};
+        size_t liveCount{0};
+        std::vector<void*> chunks;
+
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+        void grow();
+    };
+
+    template<typename T>
+    using FrameVector = std::pmr::vector<T>;
+}
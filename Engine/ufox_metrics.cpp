@@ -0,0 +1,239 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_metrics.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <fmt/core.h>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace ufox::profiling {
+    namespace {
+        void AtomicMax(std::atomic<double>& target, double value) {
+            double current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+
+        const char* ToString(MetricType type) {
+            switch (type) {
+                case MetricType::Counter: return "counter";
+                case MetricType::Gauge: return "gauge";
+                case MetricType::Histogram: return "histogram";
+            }
+            return "unknown";
+        }
+    }
+
+    double HistogramSnapshot::percentile(double p) const {
+        if (count == 0) return 0.0;
+
+        const double rank = std::clamp(p, 0.0, 1.0) * static_cast<double>(count);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            if (buckets[i] == 0 || static_cast<double>(seen + buckets[i]) < rank) {
+                seen += buckets[i];
+                continue;
+            }
+            const double lower = i == 0 ? 0.0 : bounds[i - 1];
+            const double upper = i < bounds.size() ? std::min(bounds[i], max) : max;
+            const double fraction = (rank - static_cast<double>(seen)) / static_cast<double>(buckets[i]);
+            return lower + (std::max(upper, lower) - lower) * fraction;
+        }
+        return max;
+    }
+
+    HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot &earlier) const {
+        HistogramSnapshot delta{ bounds, buckets, count - std::min(count, earlier.count), sum - earlier.sum, 0.0 };
+        if (earlier.buckets.size() != buckets.size()) return *this;
+
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            delta.buckets[i] -= std::min(buckets[i], earlier.buckets[i]);
+            if (delta.buckets[i] > 0) delta.max = i < bounds.size() ? std::min(bounds[i], max) : max;
+        }
+        return delta;
+    }
+
+    Histogram::Histogram(std::vector<double> bounds) : bounds{std::move(bounds)},
+        buckets{std::make_unique<std::atomic<uint64_t>[]>(this->bounds.size() + 1)} {
+        if (!std::ranges::is_sorted(this->bounds)) throw std::runtime_error("Histogram bounds must be ascending");
+    }
+
+    void Histogram::record(double value) {
+        const size_t bucket = std::ranges::lower_bound(bounds, value) - bounds.begin();
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        AtomicMax(max, value);
+    }
+
+    HistogramSnapshot Histogram::snapshot() const {
+        // Not a consistent cut while other threads record, count may run a sample ahead of the buckets
+        HistogramSnapshot snapshot{ bounds, std::vector<uint64_t>(bounds.size() + 1), 0, 0.0, 0.0 };
+        for (size_t i = 0; i <= bounds.size(); ++i) snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        snapshot.count = count.load(std::memory_order_relaxed);
+        snapshot.sum = sum.load(std::memory_order_relaxed);
+        snapshot.max = max.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    std::vector<double> Histogram::TimeBoundsMs() {
+        return { 0.25, 0.5, 1.0, 2.0, 4.0, 6.0, 8.0, 10.0, 12.0, 14.0, 16.7, 20.0, 25.0, 33.3, 50.0, 66.7, 100.0, 250.0, 500.0, 1000.0 };
+    }
+
+    const MetricValue* MetricsSnapshot::find(std::string_view name) const {
+        auto it = std::ranges::lower_bound(metrics, name, {}, [](const MetricValue& metric) -> std::string_view { return metric.name; });
+        return it != metrics.end() && it->name == name ? &*it : nullptr;
+    }
+
+    Counter& MetricsRegistry::counter(const std::string &name, std::string description) {
+        std::lock_guard lock(mutex);
+        Entry& entry = findOrInsert(name, MetricType::Counter, std::move(description));
+        if (!entry.counter) entry.counter = std::make_unique<Counter>();
+        return *entry.counter;
+    }
+
+    Gauge& MetricsRegistry::gauge(const std::string &name, std::string description) {
+        std::lock_guard lock(mutex);
+        Entry& entry = findOrInsert(name, MetricType::Gauge, std::move(description));
+        if (!entry.gauge) entry.gauge = std::make_unique<Gauge>();
+        return *entry.gauge;
+    }
+
+    Histogram& MetricsRegistry::histogram(const std::string &name, std::string description, std::vector<double> bounds) {
+        std::lock_guard lock(mutex);
+        Entry& entry = findOrInsert(name, MetricType::Histogram, std::move(description));
+        if (!entry.histogram) entry.histogram = std::make_unique<Histogram>(std::move(bounds));
+        return *entry.histogram;
+    }
+
+    MetricsSnapshot MetricsRegistry::snapshot() const {
+        MetricsSnapshot snapshot{};
+        snapshot.timeMs = std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+
+        std::lock_guard lock(mutex);
+        snapshot.metrics.reserve(entries.size());
+        for (const auto& [name, entry] : entries) {
+            MetricValue& value = snapshot.metrics.emplace_back(MetricValue{ name, entry.description, entry.type });
+            switch (entry.type) {
+                case MetricType::Counter: value.value = static_cast<double>(entry.counter->get()); break;
+                case MetricType::Gauge: value.value = entry.gauge->get(); break;
+                case MetricType::Histogram: value.histogram = entry.histogram->snapshot(); break;
+            }
+        }
+        return snapshot;
+    }
+
+    MetricsRegistry::Entry& MetricsRegistry::findOrInsert(const std::string &name, MetricType type, std::string description) {
+        auto [it, inserted] = entries.try_emplace(name, Entry{ type, std::move(description) });
+        if (!inserted && it->second.type != type)
+            throw std::runtime_error(fmt::format("Metric {} is already registered as a {}", name, ToString(it->second.type)));
+        return it->second;
+    }
+
+    std::string ToJsonLine(const MetricsSnapshot &current, const MetricsSnapshot &previous) {
+        std::string line = fmt::format("{{\"time_ms\": {:.1f}, \"interval_ms\": {:.1f}", current.timeMs, current.timeMs - previous.timeMs);
+        for (const MetricValue& metric : current.metrics) {
+            const MetricValue* before = previous.find(metric.name);
+            switch (metric.type) {
+                case MetricType::Counter:
+                    line += fmt::format(", \"{}\": {{\"total\": {:.0f}, \"delta\": {:.0f}}}", metric.name, metric.value,
+                                        metric.value - (before ? before->value : 0.0));
+                    break;
+                case MetricType::Gauge:
+                    line += fmt::format(", \"{}\": {}", metric.name, metric.value);
+                    break;
+                case MetricType::Histogram: {
+                    const HistogramSnapshot interval = before ? metric.histogram.since(before->histogram) : metric.histogram;
+                    line += fmt::format(", \"{}\": {{\"count\": {}, \"mean\": {:.3f}, \"p50\": {:.3f}, \"p99\": {:.3f}, \"max\": {:.3f}}}",
+                                        metric.name, interval.count, interval.mean(), interval.percentile(0.5),
+                                        interval.percentile(0.99), interval.max);
+                    break;
+                }
+            }
+        }
+        line += "}";
+        return line;
+    }
+
+    MetricsExporter::MetricsExporter(const MetricsRegistry &registry, Sink sink, std::chrono::milliseconds interval) :
+        registry{registry}, sink{std::move(sink)}, interval{interval}, previous{registry.snapshot()},
+        thread{[this] { run(); }} {}
+
+    MetricsExporter::~MetricsExporter() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+    void MetricsExporter::flush() {
+        std::lock_guard lock(exportMutex);
+        MetricsSnapshot current = registry.snapshot();
+        try {
+            sink(ToJsonLine(current, previous));
+        } catch (const std::exception& e) {
+            // A full disk or a vanished collector must not take the engine down
+            fmt::println("Metrics export failed: {}", e.what());
+        }
+        previous = std::move(current);
+    }
+
+    void MetricsExporter::run() {
+        std::unique_lock lock(mutex);
+        while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+        lock.unlock();
+        flush();
+    }
+
+    MetricsExporter::Sink MetricsExporter::FileSink(const std::string &path) {
+        auto file = std::make_shared<std::ofstream>(path, std::ios::app);
+        if (!*file) throw std::runtime_error("Failed to open metrics file " + path);
+        return [file](std::string_view line) {
+            *file << line << '\n';
+            file->flush();
+        };
+    }
+
+    MetricsExporter::Sink MetricsExporter::LocalSocketSink(const std::string &path) {
+#if defined(_WIN32)
+        throw std::runtime_error("Metrics sockets are not supported on Windows, use a file: " + path);
+#else
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path)) throw std::runtime_error("Metrics socket path too long: " + path);
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, path.size());
+
+        const int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (fd < 0) throw std::runtime_error("Failed to create metrics socket");
+        std::shared_ptr<int> handle(new int(fd), [](const int* owned) {
+            close(*owned);
+            delete owned;
+        });
+
+        return [handle, address](std::string_view line) {
+            // Non-blocking so a collector that stopped reading never stalls the exporter
+            (void)sendto(*handle, line.data(), line.size(), MSG_DONTWAIT, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        };
+#endif
+    }
+
+    MetricsExporter::Sink MetricsExporter::OpenSink(std::string_view target) {
+        constexpr std::string_view SOCKET_PREFIX = "unix:";
+        if (target.starts_with(SOCKET_PREFIX)) return LocalSocketSink(std::string(target.substr(SOCKET_PREFIX.size())));
+        return FileSink(std::string(target));
+    }
+}
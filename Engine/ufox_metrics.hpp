@@ -0,0 +1,170 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ufox::profiling {
+
+    enum class MetricType : uint8_t {
+        Counter,
+        Gauge,
+        Histogram,
+    };
+
+    // Monotonic total, e.g. bytes uploaded since startup. Safe to add from any thread.
+    class Counter {
+    public:
+        void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> value{0};
+    };
+
+    // Last value set, e.g. GPU memory in use
+    class Gauge {
+    public:
+        void set(double newValue) { value.store(newValue, std::memory_order_relaxed); }
+        [[nodiscard]] double get() const { return value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> value{0.0};
+    };
+
+    struct HistogramSnapshot {
+        std::vector<double> bounds;     // upper bound of each bucket, the last bucket has none
+        std::vector<uint64_t> buckets;  // bounds.size() + 1 counts
+        uint64_t count{0};
+        double sum{0.0};
+        double max{0.0};
+
+        [[nodiscard]] double mean() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+        // Interpolated inside the bucket holding the rank, p in [0, 1]
+        [[nodiscard]] double percentile(double p) const;
+        // Samples recorded after earlier was taken. max becomes the upper bound of the highest bucket that grew
+        [[nodiscard]] HistogramSnapshot since(const HistogramSnapshot& earlier) const;
+    };
+
+    // Fixed buckets, so recording is a search over a handful of bounds and an atomic increment
+    class Histogram {
+    public:
+        explicit Histogram(std::vector<double> bounds);
+
+        void record(double value);
+        [[nodiscard]] HistogramSnapshot snapshot() const;
+
+        // Millisecond buckets around the frame budgets of 240 down to 30 Hz, plus stalls up to a second
+        [[nodiscard]] static std::vector<double> TimeBoundsMs();
+
+    private:
+        std::vector<double> bounds;
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+        std::atomic<uint64_t> count{0};
+        std::atomic<double> sum{0.0};
+        std::atomic<double> max{0.0};
+    };
+
+    struct MetricValue {
+        std::string name;
+        std::string description;
+        MetricType type;
+        double value{0.0};              // counters and gauges
+        HistogramSnapshot histogram{};  // histograms
+    };
+
+    struct MetricsSnapshot {
+        double timeMs{0.0};             // since the registry was created
+        std::vector<MetricValue> metrics;   // sorted by name
+
+        [[nodiscard]] const MetricValue* find(std::string_view name) const;
+    };
+
+    // Named metrics shared by the engine's subsystems. Registration takes a lock and returns a reference that stays
+    // valid for the registry's lifetime, hot paths keep it and record without touching the registry again.
+    // Registering an existing name returns the same metric, registering it with another type throws.
+    class MetricsRegistry {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        MetricsRegistry() : origin{Clock::now()} {}
+
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        Counter& counter(const std::string& name, std::string description = {});
+        Gauge& gauge(const std::string& name, std::string description = {});
+        Histogram& histogram(const std::string& name, std::string description = {}, std::vector<double> bounds = Histogram::TimeBoundsMs());
+
+        [[nodiscard]] MetricsSnapshot snapshot() const;
+
+    private:
+        struct Entry {
+            MetricType type;
+            std::string description;
+            std::unique_ptr<Counter> counter{};
+            std::unique_ptr<Gauge> gauge{};
+            std::unique_ptr<Histogram> histogram{};
+        };
+
+        Clock::time_point origin;
+        mutable std::mutex mutex;
+        std::map<std::string, Entry, std::less<>> entries;
+
+        Entry& findOrInsert(const std::string& name, MetricType type, std::string description);
+    };
+
+    // One JSON object per line. Counters carry their total and the change since previous, histograms describe
+    // only the samples recorded since previous so a stall shows up in the line of the interval it happened in.
+    [[nodiscard]] std::string ToJsonLine(const MetricsSnapshot& current, const MetricsSnapshot& previous);
+
+    // Writes a snapshot of the registry to a sink every interval from its own thread, and a last one on destruction.
+    // Destroy it before the registry.
+    class MetricsExporter {
+    public:
+        using Sink = std::function<void(std::string_view line)>;
+
+        MetricsExporter(const MetricsRegistry& registry, Sink sink, std::chrono::milliseconds interval = std::chrono::seconds(1));
+        ~MetricsExporter();
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        // Writes a line right away, e.g. before a crash report
+        void flush();
+
+        // Appends to a file, one flushed line per snapshot
+        [[nodiscard]] static Sink FileSink(const std::string& path);
+        // Datagrams to a unix socket a collector listens on, one line each. Lines are dropped while nobody listens.
+        [[nodiscard]] static Sink LocalSocketSink(const std::string& path);
+        // "unix:<path>" for LocalSocketSink, anything else is a file path
+        [[nodiscard]] static Sink OpenSink(std::string_view target);
+
+    private:
+        const MetricsRegistry& registry;
+        Sink sink;
+        std::chrono::milliseconds interval;
+
+        std::mutex exportMutex;
+        MetricsSnapshot previous;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping{false};
+        std::thread thread;
+
+        void run();
+    };
+}
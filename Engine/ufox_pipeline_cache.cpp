@@ -0,0 +1,352 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_pipeline_cache.hpp"
+
+#include "Engine/ufox_gui_renderer.hpp"
+#include "Engine/ufox_hash.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace ufox::graphics::vulkan {
+    size_t PipelineKeyHash::operator()(const PipelineKey &key) const {
+        uint64_t seed = hash::Fnv1a64(key.vertexShader);
+        seed = hash::Fnv1a64(key.fragmentShader, seed);
+        seed = hash::Combine(seed, static_cast<uint64_t>(key.vertexLayout));
+        seed = hash::Combine(seed, static_cast<uint64_t>(key.blendMode));
+        seed = hash::Combine(seed, static_cast<uint64_t>(key.colorFormat));
+        seed = hash::Combine(seed, static_cast<uint64_t>(key.depthFormat));
+        seed = hash::Combine(seed, static_cast<uint64_t>(key.samples));
+        seed = hash::Combine(seed, std::hash<vk::PipelineLayout>{}(key.layout));
+        for (const auto& constant : key.specialization) {
+            seed = hash::Combine(seed, (static_cast<uint64_t>(constant.id) << 32) | constant.value);
+        }
+        return static_cast<size_t>(seed);
+    }
+
+    VertexInputDescription GetVertexInputDescription(VertexLayout layout) {
+        VertexInputDescription description{};
+        switch (layout) {
+            case VertexLayout::Standard: {
+                description.binding = Vertex::getBindingDescription();
+                auto attributes = Vertex::getAttributeDescriptions();
+                description.attributes.assign(attributes.begin(), attributes.end());
+                break;
+            }
+            case VertexLayout::Gui: {
+                description.binding = renderer::gui::Vertex::getBindingDescription();
+                auto attributes = renderer::gui::Vertex::getAttributeDescriptions();
+                description.attributes.assign(attributes.begin(), attributes.end());
+                break;
+            }
+            case VertexLayout::GuiPacked: {
+                description.binding = renderer::gui::PackedVertex::getBindingDescription();
+                auto attributes = renderer::gui::PackedVertex::getAttributeDescriptions();
+                description.attributes.assign(attributes.begin(), attributes.end());
+                break;
+            }
+            case VertexLayout::Path: {
+                description.binding = renderer::gui::PathVertex::getBindingDescription();
+                auto attributes = renderer::gui::PathVertex::getAttributeDescriptions();
+                description.attributes.assign(attributes.begin(), attributes.end());
+                break;
+            }
+        }
+        return description;
+    }
+
+    vk::PipelineColorBlendAttachmentState GetBlendAttachmentState(BlendMode mode) {
+        vk::PipelineColorBlendAttachmentState blendAttachment{};
+        blendAttachment.setColorBlendOp(vk::BlendOp::eAdd)
+                       .setAlphaBlendOp(vk::BlendOp::eAdd)
+                       .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                                          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+
+        switch (mode) {
+            case BlendMode::Opaque:
+                blendAttachment.setBlendEnable(false);
+                break;
+            case BlendMode::AlphaBlend:
+                blendAttachment.setBlendEnable(true)
+                               .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
+                               .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
+                               .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
+                               .setDstAlphaBlendFactor(vk::BlendFactor::eZero);
+                break;
+            case BlendMode::Premultiplied:
+                blendAttachment.setBlendEnable(true)
+                               .setSrcColorBlendFactor(vk::BlendFactor::eOne)
+                               .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
+                               .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
+                               .setDstAlphaBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha);
+                break;
+            case BlendMode::Additive:
+                blendAttachment.setBlendEnable(true)
+                               .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
+                               .setDstColorBlendFactor(vk::BlendFactor::eOne)
+                               .setSrcAlphaBlendFactor(vk::BlendFactor::eZero)
+                               .setDstAlphaBlendFactor(vk::BlendFactor::eOne);
+                break;
+            case BlendMode::Layer:
+                blendAttachment.setBlendEnable(true)
+                               .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
+                               .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
+                               .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
+                               .setDstAlphaBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha);
+                break;
+        }
+        return blendAttachment;
+    }
+
+    PipelineCache::PipelineCache(const vk::raii::Device &device, jobs::JobSystem &jobSystem, PipelineLayoutCache &layoutCache,
+                                 tools::shader::ShaderCompiler &shaderCompiler) :
+        device{device}, jobSystem{jobSystem}, layoutCache{layoutCache}, shaderCompiler{shaderCompiler},
+        driverCache{device, vk::PipelineCacheCreateInfo{}} {}
+
+    PipelineCache::~PipelineCache() {
+        waitIdle();
+    }
+
+    vk::Pipeline PipelineCache::request(const PipelineKey &key) {
+        bool inserted = false;
+        Entry& entry = findOrInsert(key, inserted);
+        if (entry.ready.load(std::memory_order_acquire)) return **entry.pipeline;
+        if (entry.failed.load(std::memory_order_acquire)) return nullptr;
+
+        if (inserted) {
+            // Entries are never erased while a build is pending, so the reference stays valid for the job
+            std::shared_future<void> future = jobSystem.submit([this, key, &entry] { build(key, entry); }).share();
+            std::lock_guard lock(mutex);
+            entry.build = std::move(future);
+        }
+        return nullptr;
+    }
+
+    vk::Pipeline PipelineCache::getOrCreate(const PipelineKey &key) {
+        bool inserted = false;
+        Entry& entry = findOrInsert(key, inserted);
+        if (entry.ready.load(std::memory_order_acquire)) return **entry.pipeline;
+
+        if (inserted) {
+            build(key, entry);
+        }
+        else {
+            std::shared_future<void> pending;
+            {
+                std::lock_guard lock(mutex);
+                pending = entry.build;
+            }
+            // The background job may not have published its future yet, fall back to spinning on the flag
+            if (pending.valid()) pending.get();
+            while (!entry.ready.load(std::memory_order_acquire)) {
+                if (entry.failed.load(std::memory_order_acquire)) throw std::runtime_error("Failed to build pipeline variant");
+                std::this_thread::yield();
+            }
+        }
+        return **entry.pipeline;
+    }
+
+    void PipelineCache::reload(const std::string &shader) {
+        std::lock_guard lock(mutex);
+        for (auto& [key, entry] : entries) {
+            if (key.vertexShader != shader && key.fragmentShader != shader) continue;
+            if (!entry->ready.load(std::memory_order_acquire) || entry->reloading.exchange(true)) continue;
+
+            Entry* target = entry.get();
+            entry->build = jobSystem.submit([this, key, target] { rebuild(key, *target); }).share();
+        }
+    }
+
+    void PipelineCache::beginFrame(uint64_t frameNumber, uint32_t framesInFlight) {
+        std::lock_guard lock(mutex);
+        for (auto& [key, entry] : entries) {
+            if (!entry->replacementReady.load(std::memory_order_acquire)) continue;
+
+            retired.push_back({ std::move(*entry->pipeline), frameNumber });
+            entry->pipeline = std::move(entry->replacement);
+            entry->replacement.reset();
+            entry->replacementReady.store(false, std::memory_order_relaxed);
+            entry->reloading.store(false, std::memory_order_release);
+        }
+
+        std::erase_if(retired, [frameNumber, framesInFlight](const RetiredPipeline& pipeline) {
+            return frameNumber - pipeline.retiredFrame > framesInFlight;
+        });
+    }
+
+    void PipelineCache::waitIdle() {
+        std::vector<std::shared_future<void>> pending;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto& [key, entry] : entries) {
+                if (entry->build.valid()) pending.push_back(entry->build);
+            }
+        }
+        for (auto& future : pending) future.wait();
+    }
+
+    void PipelineCache::clear() {
+        waitIdle();
+        std::lock_guard lock(mutex);
+        entries.clear();
+        retired.clear();
+    }
+
+    size_t PipelineCache::size() {
+        std::lock_guard lock(mutex);
+        return entries.size();
+    }
+
+    PipelineCache::Entry & PipelineCache::findOrInsert(const PipelineKey &key, bool &inserted) {
+        std::lock_guard lock(mutex);
+        auto [it, isNew] = entries.try_emplace(key, nullptr);
+        if (isNew) it->second = std::make_unique<Entry>();
+        inserted = isNew;
+        return *it->second;
+    }
+
+    void PipelineCache::build(const PipelineKey &key, Entry &entry) {
+        try {
+            entry.pipeline.emplace(createPipeline(key));
+            buildCount.fetch_add(1, std::memory_order_relaxed);
+            tracePipeline(key, **entry.pipeline);
+            entry.ready.store(true, std::memory_order_release);
+        }
+        catch (const std::exception& e) {
+            fmt::println("Pipeline variant {} + {} failed: {}", key.vertexShader, key.fragmentShader, e.what());
+            entry.failed.store(true, std::memory_order_release);
+            throw;
+        }
+    }
+
+    void PipelineCache::rebuild(const PipelineKey &key, Entry &entry) {
+        try {
+            entry.replacement.emplace(createPipeline(key));
+            buildCount.fetch_add(1, std::memory_order_relaxed);
+            tracePipeline(key, **entry.replacement);
+            entry.replacementReady.store(true, std::memory_order_release);
+        }
+        catch (const std::exception& e) {
+            // Keep drawing with the previous pipeline, a later edit triggers another attempt
+            fmt::println("Reloading {} + {} failed: {}", key.vertexShader, key.fragmentShader, e.what());
+            entry.reloading.store(false, std::memory_order_release);
+        }
+    }
+
+    void PipelineCache::tracePipeline(const PipelineKey &key, vk::Pipeline pipeline) const {
+        TraceWriter* writer = trace.load(std::memory_order_acquire);
+        if (!writer) return;
+
+        // Shader paths and specialization constants follow the fixed part, the layout comes from the shaders
+        std::vector<std::byte> trailing;
+        const auto append = [&trailing](std::span<const std::byte> bytes) { trailing.insert(trailing.end(), bytes.begin(), bytes.end()); };
+        append(std::as_bytes(std::span{ key.vertexShader }));
+        append(std::as_bytes(std::span{ key.fragmentShader }));
+        append(std::as_bytes(std::span{ key.specialization }));
+
+        writer->record(TraceDefinePipeline{
+            TraceId(pipeline), static_cast<uint32_t>(key.vertexLayout), static_cast<uint32_t>(key.blendMode),
+            static_cast<uint32_t>(key.colorFormat), static_cast<uint32_t>(key.depthFormat), static_cast<uint32_t>(key.samples),
+            static_cast<uint32_t>(key.vertexShader.size()), static_cast<uint32_t>(key.fragmentShader.size()),
+            static_cast<uint32_t>(key.specialization.size())
+        }, trailing);
+    }
+
+    vk::raii::Pipeline PipelineCache::createPipeline(const PipelineKey &key) {
+        tools::shader::SpirvBinary vertCode = shaderCompiler.load(key.vertexShader);
+        tools::shader::SpirvBinary fragCode = shaderCompiler.load(key.fragmentShader);
+        vk::raii::ShaderModule vertModule(device, vk::ShaderModuleCreateInfo{ {}, vertCode->size() * sizeof(uint32_t), vertCode->data() });
+        vk::raii::ShaderModule fragModule(device, vk::ShaderModuleCreateInfo{ {}, fragCode->size() * sizeof(uint32_t), fragCode->data() });
+
+        std::vector<vk::SpecializationMapEntry> specializationEntries;
+        std::vector<uint32_t> specializationData;
+        specializationEntries.reserve(key.specialization.size());
+        specializationData.reserve(key.specialization.size());
+        for (const auto& constant : key.specialization) {
+            specializationEntries.emplace_back(constant.id, static_cast<uint32_t>(specializationData.size() * sizeof(uint32_t)), sizeof(uint32_t));
+            specializationData.push_back(constant.value);
+        }
+
+        // Stages ignore ids they do not declare, so both share one map
+        vk::SpecializationInfo specializationInfo{};
+        specializationInfo.setMapEntries(specializationEntries)
+                          .setDataSize(specializationData.size() * sizeof(uint32_t))
+                          .setPData(specializationData.data());
+        const vk::SpecializationInfo* pSpecialization = specializationEntries.empty() ? nullptr : &specializationInfo;
+
+        std::array stages = {
+            vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eVertex, *vertModule, "main", pSpecialization },
+            vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eFragment, *fragModule, "main", pSpecialization }
+        };
+
+        VertexInputDescription vertexDescription = GetVertexInputDescription(key.vertexLayout);
+        for (const auto& input : layoutCache.reflect(key.vertexShader).inputs) {
+            bool provided = std::ranges::any_of(vertexDescription.attributes, [&input](const auto& attribute) {
+                return attribute.location == input.location;
+            });
+            if (!provided)
+                throw std::runtime_error(fmt::format("{} reads location {} which the vertex layout does not provide", key.vertexShader, input.location));
+        }
+        vk::PipelineVertexInputStateCreateInfo vertexInput{};
+        vertexInput.setVertexBindingDescriptionCount(1)
+                   .setPVertexBindingDescriptions(&vertexDescription.binding)
+                   .setVertexAttributeDescriptions(vertexDescription.attributes);
+
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.setTopology(vk::PrimitiveTopology::eTriangleList)
+                     .setPrimitiveRestartEnable(false);
+
+        vk::PipelineViewportStateCreateInfo viewportState{};
+        viewportState.setViewportCount(1).setScissorCount(1);
+
+        vk::PipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.setPolygonMode(vk::PolygonMode::eFill)
+                  .setDepthBiasEnable(false)
+                  .setDepthClampEnable(false)
+                  .setRasterizerDiscardEnable(false)
+                  .setLineWidth(1.0f);
+
+        vk::PipelineMultisampleStateCreateInfo multisample{};
+        multisample.setRasterizationSamples(key.samples);
+
+        vk::PipelineColorBlendAttachmentState blendAttachment = GetBlendAttachmentState(key.blendMode);
+        vk::PipelineColorBlendStateCreateInfo blendState{};
+        blendState.setAttachmentCount(1).setPAttachments(&blendAttachment);
+
+        std::array dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor, vk::DynamicState::eCullMode,
+                                     vk::DynamicState::eFrontFace, vk::DynamicState::ePrimitiveTopology,
+                                     vk::DynamicState::eDepthTestEnable, vk::DynamicState::eDepthWriteEnable,
+                                     vk::DynamicState::eDepthCompareOp };
+        vk::PipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.setDynamicStateCount(dynamicStates.size()).setPDynamicStates(dynamicStates.data());
+
+        vk::PipelineRenderingCreateInfo renderingInfo{};
+        renderingInfo.setColorAttachmentCount(1)
+                     .setPColorAttachmentFormats(&key.colorFormat)
+                     .setDepthAttachmentFormat(key.depthFormat);
+
+        vk::PipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.setDepthBoundsTestEnable(false)
+                    .setStencilTestEnable(false);
+
+        vk::GraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.setStageCount(stages.size())
+                    .setPStages(stages.data())
+                    .setPVertexInputState(&vertexInput)
+                    .setPInputAssemblyState(&inputAssembly)
+                    .setPViewportState(&viewportState)
+                    .setPRasterizationState(&rasterizer)
+                    .setPMultisampleState(&multisample)
+                    .setPColorBlendState(&blendState)
+                    .setPDynamicState(&dynamicState)
+                    .setPDepthStencilState(&depthStencil)
+                    .setLayout(key.layout)
+                    .setRenderPass(nullptr)
+                    .setSubpass(0)
+                    .setPNext(&renderingInfo);
+
+        return vk::raii::Pipeline(device, driverCache, pipelineInfo);
+    }
+}
@@ -0,0 +1,141 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Engine/ufox_job_system.hpp"
+#include "Engine/ufox_pipeline_layout_cache.hpp"
+#include "Engine/ufox_trace.hpp"
+
+namespace ufox::graphics::vulkan {
+
+    enum class VertexLayout : uint8_t {
+        Standard,   // graphics::Vertex, vec3 position
+        Gui,        // renderer::gui::Vertex, vec2 position
+        GuiPacked,  // renderer::gui::PackedVertex, 12 bytes
+        Path,       // renderer::gui::PathVertex, bounding quads of PathRenderer
+    };
+
+    enum class BlendMode : uint8_t {
+        Opaque,
+        AlphaBlend,
+        Premultiplied,
+        Additive,
+        // AlphaBlend for color while alpha accumulates coverage, so the target ends up premultiplied. Used when
+        // drawing into offscreen layers that are later composited with Premultiplied.
+        Layer,
+    };
+
+    struct SpecializationConstant {
+        uint32_t id;
+        uint32_t value;
+
+        bool operator==(const SpecializationConstant&) const = default;
+    };
+
+    // Everything that forces a distinct VkPipeline. Viewport, scissor, cull mode, front face, topology and the
+    // depth test/write/compare state are dynamic, so they never create a new variant.
+    struct PipelineKey {
+        std::string vertexShader{"shaders/shader.vert.spv"};
+        std::string fragmentShader{"shaders/shader.frag.spv"};
+        VertexLayout vertexLayout{VertexLayout::Standard};
+        BlendMode blendMode{BlendMode::AlphaBlend};
+        vk::Format colorFormat{vk::Format::eUndefined};
+        vk::Format depthFormat{vk::Format::eUndefined};
+        vk::SampleCountFlagBits samples{vk::SampleCountFlagBits::e1};
+        vk::PipelineLayout layout{};
+        std::vector<SpecializationConstant> specialization{};
+
+        bool operator==(const PipelineKey&) const = default;
+    };
+
+    struct PipelineKeyHash {
+        size_t operator()(const PipelineKey& key) const;
+    };
+
+    struct VertexInputDescription {
+        vk::VertexInputBindingDescription binding{};
+        std::vector<vk::VertexInputAttributeDescription> attributes{};
+    };
+
+    [[nodiscard]] VertexInputDescription GetVertexInputDescription(VertexLayout layout);
+    [[nodiscard]] vk::PipelineColorBlendAttachmentState GetBlendAttachmentState(BlendMode mode);
+
+    class PipelineCache {
+    public:
+        PipelineCache(const vk::raii::Device& device, jobs::JobSystem& jobSystem, PipelineLayoutCache& layoutCache,
+                      tools::shader::ShaderCompiler& shaderCompiler);
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+        PipelineCache(PipelineCache&&) = delete;
+        PipelineCache& operator=(PipelineCache&&) = delete;
+
+        // Non-blocking: returns the pipeline when it is ready, otherwise schedules a build on the job threads
+        // (once per key) and returns a null handle so the caller can skip or substitute the draw this frame.
+        [[nodiscard]] vk::Pipeline request(const PipelineKey& key);
+        // Blocking: builds on the calling thread if nobody has started the variant yet.
+        [[nodiscard]] vk::Pipeline getOrCreate(const PipelineKey& key);
+        void prewarm(const PipelineKey& key) { (void)request(key); }
+
+        // Rebuilds every variant that uses the shader on the job threads. The old pipelines keep drawing until
+        // beginFrame swaps the replacements in, and are destroyed once no frame in flight can reference them.
+        void reload(const std::string& shader);
+        void beginFrame(uint64_t frameNumber, uint32_t framesInFlight);
+
+        void waitIdle();
+        void clear();
+
+        [[nodiscard]] size_t size();
+        [[nodiscard]] uint32_t getBuildCount() const { return buildCount.load(std::memory_order_relaxed); }
+
+        // Pipelines built from now on are described in the trace, so a replay can build them from the same key
+        void setTrace(TraceWriter* writer) { trace.store(writer, std::memory_order_release); }
+
+    private:
+        struct Entry {
+            std::optional<vk::raii::Pipeline> pipeline{};
+            std::atomic<bool> ready{false};
+            std::atomic<bool> failed{false};
+            std::shared_future<void> build{};
+
+            std::optional<vk::raii::Pipeline> replacement{};
+            std::atomic<bool> replacementReady{false};
+            std::atomic<bool> reloading{false};
+        };
+
+        struct RetiredPipeline {
+            vk::raii::Pipeline pipeline;
+            uint64_t retiredFrame;
+        };
+
+        const vk::raii::Device& device;
+        jobs::JobSystem& jobSystem;
+        PipelineLayoutCache& layoutCache;
+        tools::shader::ShaderCompiler& shaderCompiler;
+        vk::raii::PipelineCache driverCache;
+
+        std::mutex mutex;
+        std::unordered_map<PipelineKey, std::unique_ptr<Entry>, PipelineKeyHash> entries;
+        std::vector<RetiredPipeline> retired;
+        std::atomic<uint32_t> buildCount{0};
+        std::atomic<TraceWriter*> trace{nullptr};
+
+        Entry& findOrInsert(const PipelineKey& key, bool& inserted);
+        void build(const PipelineKey& key, Entry& entry);
+        void rebuild(const PipelineKey& key, Entry& entry);
+        [[nodiscard]] vk::raii::Pipeline createPipeline(const PipelineKey& key);
+        void tracePipeline(const PipelineKey& key, vk::Pipeline pipeline) const;
+    };
+}
@@ -0,0 +1,169 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_pipeline_layout_cache.hpp"
+
+#include <algorithm>
+#include <map>
+#include <fmt/format.h>
+
+#include "Engine/ufox_hash.hpp"
+
+namespace ufox::graphics::vulkan {
+    const tools::shader::DescriptorBinding * ShaderInterface::findBinding(uint32_t set, uint32_t binding) const {
+        auto it = std::ranges::find_if(bindings, [set, binding](const auto& b) { return b.set == set && b.binding == binding; });
+        return it != bindings.end() ? &*it : nullptr;
+    }
+
+    std::vector<vk::DescriptorPoolSize> ShaderInterface::getPoolSizes(uint32_t setCount) const {
+        std::map<vk::DescriptorType, uint32_t> counts;
+        for (const auto& binding : bindings) {
+            counts[static_cast<vk::DescriptorType>(binding.type)] += std::max(binding.count, 1u) * setCount;
+        }
+
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        poolSizes.reserve(counts.size());
+        for (const auto& [type, count] : counts) {
+            poolSizes.emplace_back(type, count);
+        }
+        return poolSizes;
+    }
+
+    PipelineLayoutCache::PipelineLayoutCache(const vk::raii::Device &device, tools::shader::ShaderCompiler &shaderCompiler) :
+        device{device}, shaderCompiler{shaderCompiler} {}
+
+    const tools::shader::Reflection & PipelineLayoutCache::reflect(const std::string &shader) {
+        std::lock_guard lock(mutex);
+        return reflectLocked(shader);
+    }
+
+    const tools::shader::Reflection & PipelineLayoutCache::reflectLocked(const std::string &shader) {
+        auto it = reflections.find(shader);
+        if (it == reflections.end()) {
+            tools::shader::SpirvBinary code = shaderCompiler.load(shader);
+            it = reflections.emplace(shader, tools::shader::Reflect(std::span<const uint32_t>(*code))).first;
+        }
+        return it->second;
+    }
+
+    const ShaderInterface & PipelineLayoutCache::get(const std::vector<std::string> &shaders) {
+        std::string programKey;
+        for (const auto& shader : shaders) {
+            programKey += shader;
+            programKey += '|';
+        }
+
+        std::lock_guard lock(mutex);
+        if (auto it = interfaces.find(programKey); it != interfaces.end()) return *it->second;
+
+        auto shaderInterface = std::make_unique<ShaderInterface>();
+        std::optional<vk::PushConstantRange> pushRange;
+
+        for (const auto& shader : shaders) {
+            const auto& reflection = reflectLocked(shader);
+
+            for (const auto& binding : reflection.bindings) {
+                auto existing = std::ranges::find_if(shaderInterface->bindings, [&binding](const auto& b) {
+                    return b.set == binding.set && b.binding == binding.binding;
+                });
+                if (existing == shaderInterface->bindings.end()) {
+                    shaderInterface->bindings.push_back(binding);
+                    continue;
+                }
+                if (existing->type != binding.type)
+                    throw std::runtime_error(fmt::format("Descriptor type mismatch at set {} binding {} in {}", binding.set, binding.binding, shader));
+                existing->stageFlags |= binding.stageFlags;
+                existing->blockSize = std::max(existing->blockSize, binding.blockSize);
+            }
+
+            // A single range covering every stage keeps vkCmdPushConstants calls trivial for callers
+            if (reflection.pushConstants) {
+                const auto& block = *reflection.pushConstants;
+                if (!pushRange) {
+                    pushRange = vk::PushConstantRange{ static_cast<vk::ShaderStageFlags>(block.stageFlags), block.offset, block.size };
+                }
+                else {
+                    uint32_t begin = std::min(pushRange->offset, block.offset);
+                    uint32_t end = std::max(pushRange->offset + pushRange->size, block.offset + block.size);
+                    pushRange->stageFlags |= static_cast<vk::ShaderStageFlags>(block.stageFlags);
+                    pushRange->offset = begin;
+                    pushRange->size = end - begin;
+                }
+            }
+
+            if (reflection.stage == tools::shader::StageVertex) shaderInterface->vertexInputs = reflection.inputs;
+        }
+
+        std::ranges::sort(shaderInterface->bindings, [](const auto& a, const auto& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        if (pushRange) shaderInterface->pushConstantRanges.push_back(*pushRange);
+
+        // Sets without bindings in this program still need a (empty) layout to keep indices contiguous
+        uint32_t setCount = shaderInterface->bindings.empty() ? 0 : shaderInterface->bindings.back().set + 1;
+        for (uint32_t set = 0; set < setCount; ++set) {
+            auto first = std::ranges::find_if(shaderInterface->bindings, [set](const auto& b) { return b.set == set; });
+            auto last = std::find_if(first, shaderInterface->bindings.end(), [set](const auto& b) { return b.set != set; });
+            shaderInterface->setLayouts.push_back(getSetLayout({ first, last }));
+        }
+        shaderInterface->pipelineLayout = getPipelineLayout(*shaderInterface);
+
+        return *interfaces.emplace(programKey, std::move(shaderInterface)).first->second;
+    }
+
+    void PipelineLayoutCache::invalidate(const std::string &shader) {
+        // Layout objects stay alive because pipelines built from them may still be in flight, and the interfaces
+        // because callers hold on to them; only the reflection and the program mapping are refreshed.
+        std::lock_guard lock(mutex);
+        reflections.erase(shader);
+        for (auto it = interfaces.begin(); it != interfaces.end();) {
+            const std::string& programKey = it->first;
+            if (programKey.starts_with(shader + '|') || programKey.find('|' + shader + '|') != std::string::npos) {
+                retiredInterfaces.push_back(std::move(it->second));
+                it = interfaces.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    vk::DescriptorSetLayout PipelineLayoutCache::getSetLayout(std::span<const tools::shader::DescriptorBinding> bindings) {
+        uint64_t key = hash::FNV_OFFSET_BASIS;
+        std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
+        layoutBindings.reserve(bindings.size());
+        for (const auto& binding : bindings) {
+            layoutBindings.emplace_back(binding.binding, static_cast<vk::DescriptorType>(binding.type),
+                                        std::max(binding.count, 1u), static_cast<vk::ShaderStageFlags>(binding.stageFlags));
+            key = hash::Combine(key, binding.binding);
+            key = hash::Combine(key, static_cast<uint64_t>(binding.type));
+            key = hash::Combine(key, binding.count);
+            key = hash::Combine(key, binding.stageFlags);
+        }
+
+        if (auto it = setLayouts.find(key); it != setLayouts.end()) return *it->second;
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.setBindings(layoutBindings);
+        return *setLayouts.emplace(key, vk::raii::DescriptorSetLayout(device, layoutInfo)).first->second;
+    }
+
+    vk::PipelineLayout PipelineLayoutCache::getPipelineLayout(const ShaderInterface &shaderInterface) {
+        uint64_t key = hash::FNV_OFFSET_BASIS;
+        for (const auto& setLayout : shaderInterface.setLayouts) {
+            key = hash::Combine(key, std::hash<vk::DescriptorSetLayout>{}(setLayout));
+        }
+        for (const auto& range : shaderInterface.pushConstantRanges) {
+            key = hash::Combine(key, static_cast<uint32_t>(range.stageFlags));
+            key = hash::Combine(key, (static_cast<uint64_t>(range.offset) << 32) | range.size);
+        }
+
+        if (auto it = pipelineLayouts.find(key); it != pipelineLayouts.end()) return *it->second;
+
+        vk::PipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.setSetLayouts(shaderInterface.setLayouts)
+                  .setPushConstantRanges(shaderInterface.pushConstantRanges);
+        return *pipelineLayouts.emplace(key, vk::raii::PipelineLayout(device, layoutInfo)).first->second;
+    }
+}
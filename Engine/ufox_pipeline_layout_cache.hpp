@@ -0,0 +1,58 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Engine/ufox_tools_shader_compiler.hpp"
+
+namespace ufox::graphics::vulkan {
+
+    // Merged resource interface of every stage in a program, plus the layouts built from it
+    struct ShaderInterface {
+        std::vector<tools::shader::DescriptorBinding> bindings{};   // stage flags merged, sorted by set/binding
+        std::vector<vk::PushConstantRange> pushConstantRanges{};
+        std::vector<tools::shader::VertexInput> vertexInputs{};
+        std::vector<vk::DescriptorSetLayout> setLayouts{};          // indexed by set number
+        vk::PipelineLayout pipelineLayout{};
+
+        [[nodiscard]] const tools::shader::DescriptorBinding* findBinding(uint32_t set, uint32_t binding) const;
+        // Pool sizes for allocating setCount copies of every set in this interface
+        [[nodiscard]] std::vector<vk::DescriptorPoolSize> getPoolSizes(uint32_t setCount) const;
+    };
+
+    // Reflects shaders once and shares descriptor set and pipeline layouts between programs with
+    // identical interfaces, e.g. every GUI variant that only differs in blend mode or specialization.
+    class PipelineLayoutCache {
+    public:
+        PipelineLayoutCache(const vk::raii::Device& device, tools::shader::ShaderCompiler& shaderCompiler);
+
+        [[nodiscard]] const tools::shader::Reflection& reflect(const std::string& shader);
+        // The reference stays valid for the cache's lifetime, invalidate() only stops handing it out
+        [[nodiscard]] const ShaderInterface& get(const std::vector<std::string>& shaders);
+        // The next get() for programs using shader reflects it again. Interfaces handed out before remain valid and
+        // describe the old code, holders that want the new interface call get() again.
+        void invalidate(const std::string& shader);
+
+    private:
+        const vk::raii::Device& device;
+        tools::shader::ShaderCompiler& shaderCompiler;
+        std::mutex mutex;
+        std::unordered_map<std::string, tools::shader::Reflection> reflections;
+        std::unordered_map<uint64_t, vk::raii::DescriptorSetLayout> setLayouts;
+        std::unordered_map<uint64_t, vk::raii::PipelineLayout> pipelineLayouts;
+        std::unordered_map<std::string, std::unique_ptr<ShaderInterface>> interfaces;
+        // Invalidated interfaces, GUI passes keep raw pointers to them across a hot reload
+        std::vector<std::unique_ptr<ShaderInterface>> retiredInterfaces;
+
+        const tools::shader::Reflection& reflectLocked(const std::string& shader);
+        vk::DescriptorSetLayout getSetLayout(std::span<const tools::shader::DescriptorBinding> bindings);
+        vk::PipelineLayout getPipelineLayout(const ShaderInterface& shaderInterface);
+    };
+}
@@ -0,0 +1,64 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_render_target_pool.hpp"
+
+#include <algorithm>
+
+namespace ufox::graphics::vulkan {
+
+    RenderTargetPool::RenderTargetPool(GraphicsDevice &gpu, vk::DeviceSize idleBudget) : gpu{gpu}, idleBudget{idleBudget} {}
+
+    RenderTarget RenderTargetPool::acquire(const RenderTargetDesc &desc) {
+        if (desc.extent.width == 0 || desc.extent.height == 0) throw std::runtime_error("Render target extent must not be empty");
+        trim();
+
+        auto it = std::ranges::find_if(pool, [&](const PooledTarget& pooled) {
+            return pooled.target.desc == desc && isReusable(pooled);
+        });
+        if (it != pool.end()) {
+            RenderTarget target = std::move(it->target);
+            pool.erase(it);
+            --stats.idle;
+            stats.idleBytes -= target.image->allocationSize;
+            ++stats.reused;
+            return target;
+        }
+
+        RenderTarget target{ desc, std::make_unique<Image>() };
+        target.image->format = desc.format;
+        target.image->extent = desc.extent;
+        gpu.createImage(vk::ImageTiling::eOptimal, desc.usage, vk::MemoryPropertyFlagBits::eDeviceLocal, *target.image);
+
+        vk::ImageViewCreateInfo viewInfo{};
+        viewInfo.setImage(*target.image->data)
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(desc.format)
+                .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
+        target.image->view.emplace(gpu.getDevice(), viewInfo);
+
+        ++stats.created;
+        return target;
+    }
+
+    void RenderTargetPool::release(RenderTarget &&target) {
+        if (!target.valid()) return;
+        ++stats.idle;
+        stats.idleBytes += target.image->allocationSize;
+        pool.push_back({ std::move(target), gpu.getFrameNumber() });
+        trim();
+    }
+
+    void RenderTargetPool::trim() {
+        // Oldest first: drop what sat unused for too long, then whatever exceeds the budget
+        std::erase_if(pool, [&](PooledTarget& pooled) {
+            bool expired = pooled.releasedFrame + TRIM_AFTER_FRAMES <= gpu.getFrameNumber();
+            bool overBudget = stats.idleBytes > idleBudget && isReusable(pooled);
+            if (!expired && !overBudget) return false;
+            --stats.idle;
+            stats.idleBytes -= pooled.target.image->allocationSize;
+            return true;
+        });
+    }
+}
@@ -0,0 +1,67 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <memory>
+#include <vector>
+#include <Engine/ufox_graphic.hpp>
+
+namespace ufox::graphics::vulkan {
+
+    struct RenderTargetDesc {
+        vk::Format format{vk::Format::eR8G8B8A8Unorm};
+        vk::Extent2D extent{0, 0};
+        vk::ImageUsageFlags usage{vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled};
+
+        bool operator==(const RenderTargetDesc&) const = default;
+    };
+
+    struct RenderTarget {
+        RenderTargetDesc desc{};
+        std::unique_ptr<Image> image{};
+
+        [[nodiscard]] bool valid() const { return image != nullptr; }
+    };
+
+    struct RenderTargetPoolStats {
+        uint32_t created{0};
+        uint32_t reused{0};
+        uint32_t idle{0};
+        vk::DeviceSize idleBytes{0};
+    };
+
+    // Recycles offscreen color images. Released targets wait until the frames in flight that may still sample them
+    // are done, then go back to the pool for the next request with the same format, extent and usage. Idle images
+    // are destroyed after a while or when the pool holds more than its budget. Frames are counted by the device's
+    // drawFrame, so any number of renderers can share one pool.
+    class RenderTargetPool {
+    public:
+        explicit RenderTargetPool(GraphicsDevice& gpu, vk::DeviceSize idleBudget = 32 * 1024 * 1024);
+
+        RenderTargetPool(const RenderTargetPool&) = delete;
+        RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+        // Contents are undefined and the image is in eUndefined layout
+        [[nodiscard]] RenderTarget acquire(const RenderTargetDesc& desc);
+        void release(RenderTarget&& target);
+
+        [[nodiscard]] const RenderTargetPoolStats& getStats() const { return stats; }
+
+    private:
+        static constexpr uint64_t TRIM_AFTER_FRAMES = 600;
+
+        struct PooledTarget {
+            RenderTarget target;
+            uint64_t releasedFrame;
+        };
+
+        GraphicsDevice& gpu;
+        vk::DeviceSize idleBudget;
+        std::vector<PooledTarget> pool;        // oldest release first
+        RenderTargetPoolStats stats{};
+
+        [[nodiscard]] bool isReusable(const PooledTarget& pooled) const { return pooled.releasedFrame + MAX_FRAMES_IN_FLIGHT <= gpu.getFrameNumber(); }
+        void trim();
+    };
+}
@@ -0,0 +1,195 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_runtime.hpp"
+
+#include <chrono>
+
+namespace ufox {
+    EngineRuntime::EngineRuntime(windowing::sdl::UfoxWindow &window, graphics::vulkan::GraphicsDevice &gpu, InputSystem &input) :
+        window{window}, gpu{gpu}, input{input} {
+        auto [width, height] = window.getSize();
+        SDL_WindowFlags flags = SDL_GetWindowFlags(window.get());
+        platform.extent = vk::Extent2D{ width, height };
+        platform.minimized = (flags & SDL_WINDOW_MINIMIZED) || (flags & SDL_WINDOW_HIDDEN);
+        platform.focused = flags & SDL_WINDOW_INPUT_FOCUS;
+        platformState.publish(platform);
+    }
+
+    EngineRuntime::~EngineRuntime() {
+        requestQuit();
+        if (renderThread.joinable()) renderThread.join();
+    }
+
+    void EngineRuntime::run() {
+        running.store(true, std::memory_order_release);
+        renderThread = std::thread([this] { renderLoop(); });
+
+        while (running.load(std::memory_order_acquire)) {
+            pumpEvents();
+        }
+
+        post(WindowMessageType::Quit, SDL_GetTicksNS());
+        renderThread.join();
+        if (renderError) std::rethrow_exception(renderError);
+    }
+
+    void EngineRuntime::pumpEvents() {
+        SDL_Event event;
+        // Sleep until something happens instead of spinning, the render thread does not depend on this loop's rate
+        if (SDL_WaitEventTimeout(&event, PUMP_TIMEOUT_MS)) {
+            handleEvent(event);
+            while (SDL_PollEvent(&event)) handleEvent(event);
+        }
+
+        trackGlobalMouse();
+        ++platform.pumpCount;
+        platformState.publish(platform);
+    }
+
+    void EngineRuntime::handleEvent(const SDL_Event &event) {
+        input.record(event);
+
+        switch (event.type) {
+            case SDL_EVENT_QUIT: {
+                running.store(false, std::memory_order_release);
+                break;
+            }
+            case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED: {
+                window.updateSize();
+                auto [w, h] = window.getSize();
+                platform.extent = vk::Extent2D{ w, h };
+                post(WindowMessageType::Resized, event.common.timestamp);
+                break;
+            }
+            case SDL_EVENT_WINDOW_MINIMIZED: {
+                platform.minimized = true;
+                post(WindowMessageType::Minimized, event.common.timestamp);
+                break;
+            }
+            case SDL_EVENT_WINDOW_RESTORED: {
+                platform.minimized = false;
+                post(WindowMessageType::Restored, event.common.timestamp);
+                break;
+            }
+            case SDL_EVENT_MOUSE_MOTION: {
+                trackMouseOutsideWindow = false;
+                break;
+            }
+            case SDL_EVENT_WINDOW_FOCUS_LOST: {
+                platform.focused = false;
+                trackMouseOutsideWindow = false;
+                post(WindowMessageType::FocusLost, event.common.timestamp);
+                break;
+            }
+            case SDL_EVENT_WINDOW_FOCUS_GAINED: {
+                platform.focused = true;
+                trackMouseOutsideWindow = true;
+                post(WindowMessageType::FocusGained, event.common.timestamp);
+                break;
+            }
+            case SDL_EVENT_WINDOW_MOUSE_LEAVE: {
+                trackMouseOutsideWindow = true;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void EngineRuntime::trackGlobalMouse() {
+        if (!trackMouseOutsideWindow) return;
+
+        // SDL only reports motion inside the window, poll the global position and feed it in as regular motion
+        glm::vec2 global;
+        SDL_GetGlobalMouseState(&global.x, &global.y);
+        if (global == lastGlobalMouse) return;
+
+        int xPos, yPos;
+        SDL_GetWindowPosition(window.get(), &xPos, &yPos);
+
+        InputEvent event{};
+        event.timestamp = SDL_GetTicksNS();
+        event.type = InputEventType::MouseMotion;
+        event.position = global - glm::vec2(xPos, yPos);
+        event.delta = lastGlobalMouse.x < 0.0f ? glm::vec2(0.0f) : global - lastGlobalMouse;
+        input.record(event);
+        lastGlobalMouse = global;
+    }
+
+    void EngineRuntime::post(WindowMessageType type, uint64_t timestamp) {
+        WindowMessage message{ type, timestamp, platform.extent.width, platform.extent.height };
+        // Window messages must not be lost, the render thread drains them every frame so this rarely spins
+        while (!messages.push(message)) {
+            if (renderFinished.load(std::memory_order_acquire)) return;
+            std::this_thread::yield();
+        }
+    }
+
+    void EngineRuntime::renderLoop() {
+        using Clock = std::chrono::steady_clock;
+
+        try {
+            platformState.update();
+            gpu.enableRender = !platformState.front().minimized;
+
+            bool quit = false;
+            bool resized = false;
+            uint64_t frameNumber = 0;
+            auto lastUpdate = Clock::now();
+
+            while (!quit) {
+                messages.drain([&](const WindowMessage& message) {
+                    switch (message.type) {
+                        case WindowMessageType::Resized: resized = true; break;
+                        case WindowMessageType::Minimized: gpu.enableRender = false; break;
+                        case WindowMessageType::Restored: gpu.enableRender = true; break;
+                        case WindowMessageType::Quit: quit = true; break;
+                        default: break;
+                    }
+                });
+                if (quit) break;
+
+                // Resize messages may arrive in bursts during a drag, only the newest extent matters
+                platformState.update();
+                const PlatformState& state = platformState.front();
+
+                if (resized && gpu.enableRender && state.extent.width > 0 && state.extent.height > 0) {
+                    fmt::println("Window resized: {}x{}", state.extent.width, state.extent.height);
+                    gpu.recreateSwapchain(state.extent);
+                    resized = false;
+                }
+
+                input.beginFrame();
+
+                auto now = Clock::now();
+                float deltaTime = std::chrono::duration<float>(now - lastUpdate).count();
+                lastUpdate = now;
+
+                if (update) update(FrameContext{ frameNumber, deltaTime, state.extent, input.getSnapshot(), input.getFrameEvents() });
+
+                if (!gpu.enableRender) {
+                    // Nothing to present while minimized, idle instead of spinning on the message ring
+                    std::this_thread::sleep_for(std::chrono::milliseconds(PUMP_TIMEOUT_MS));
+                    continue;
+                }
+
+                gpu.drawFrame(state.extent);
+                ++frameNumber;
+            }
+
+            gpu.waitForIdle();
+        }
+        catch (...) {
+            renderError = std::current_exception();
+        }
+
+        renderFinished.store(true, std::memory_order_release);
+        running.store(false, std::memory_order_release);
+        // Wake the main thread out of SDL_WaitEventTimeout promptly
+        SDL_Event quitEvent{};
+        quitEvent.type = SDL_EVENT_QUIT;
+        SDL_PushEvent(&quitEvent);
+    }
+}
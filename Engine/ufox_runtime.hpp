@@ -0,0 +1,103 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <Windowing/ufox_windowing.hpp>
+#include <Engine/ufox_graphic.hpp>
+#include <Engine/ufox_inputSystem.hpp>
+#include <Engine/ufox_spsc_ring.hpp>
+#include <Engine/ufox_triple_buffer.hpp>
+
+namespace ufox {
+
+    enum class WindowMessageType : uint8_t {
+        Resized,
+        Minimized,
+        Restored,
+        FocusGained,
+        FocusLost,
+        Quit,
+    };
+
+    struct WindowMessage {
+        WindowMessageType type;
+        uint64_t timestamp;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Window state as last seen by the event thread, the render thread always reads the newest copy
+    struct PlatformState {
+        vk::Extent2D extent{0, 0};
+        bool minimized{false};
+        bool focused{true};
+        uint64_t pumpCount{0};
+    };
+
+    struct FrameContext {
+        uint64_t frameNumber;
+        float deltaTime;                // seconds since the previous update
+        vk::Extent2D extent;
+        const InputSnapshot& input;
+        std::span<const InputEvent> events;
+    };
+
+    // Runs SDL event pumping on the calling (main) thread, as SDL requires, and simulation, GUI update and rendering
+    // on a dedicated render thread. Input crosses over through InputSystem's ring, window changes through
+    // WindowMessages and the newest PlatformState through a triple buffer, so a long frame never delays event
+    // handling and a window-manager drag never stalls rendering.
+    class EngineRuntime {
+    public:
+        using UpdateCallback = std::function<void(const FrameContext&)>;
+
+        EngineRuntime(windowing::sdl::UfoxWindow& window, graphics::vulkan::GraphicsDevice& gpu, InputSystem& input);
+        ~EngineRuntime();
+
+        EngineRuntime(const EngineRuntime&) = delete;
+        EngineRuntime& operator=(const EngineRuntime&) = delete;
+        EngineRuntime(EngineRuntime&&) = delete;
+        EngineRuntime& operator=(EngineRuntime&&) = delete;
+
+        // Called on the render thread once per frame before drawing
+        void setUpdateCallback(UpdateCallback callback) { update = std::move(callback); }
+
+        // Blocks the main thread pumping events until the window closes or requestQuit is called, then joins the
+        // render thread and rethrows anything it threw
+        void run();
+        void requestQuit() { running.store(false, std::memory_order_release); }
+
+    private:
+        static constexpr size_t MESSAGE_CAPACITY = 256;
+        static constexpr uint32_t PUMP_TIMEOUT_MS = 4;
+
+        windowing::sdl::UfoxWindow& window;
+        graphics::vulkan::GraphicsDevice& gpu;
+        InputSystem& input;
+        UpdateCallback update{};
+
+        std::atomic<bool> running{false};
+        std::atomic<bool> renderFinished{false};
+        std::thread renderThread{};
+        std::exception_ptr renderError{};
+        SpscRing<WindowMessage, MESSAGE_CAPACITY> messages{};
+        TripleBuffer<PlatformState> platformState{};
+
+        // Main thread
+        PlatformState platform{};
+        bool trackMouseOutsideWindow{true};
+        glm::vec2 lastGlobalMouse{-1.0f};
+
+        void pumpEvents();
+        void handleEvent(const SDL_Event& event);
+        void trackGlobalMouse();
+        void post(WindowMessageType type, uint64_t timestamp);
+
+        // Render thread
+        void renderLoop();
+    };
+}
@@ -0,0 +1,75 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace ufox {
+
+    // Bounded single-producer single-consumer queue. push and pop never lock or allocate, one thread may push while
+    // another pops. Capacity must be a power of two.
+    template<typename T, size_t Capacity>
+    class SpscRing {
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "SpscRing stores trivially copyable values");
+
+    public:
+        // Producer side, returns false and leaves the ring untouched when it is full
+        bool push(const T& value) {
+            const uint64_t head = writeIndex.load(std::memory_order_relaxed);
+            if (head - cachedReadIndex >= Capacity) {
+                cachedReadIndex = readIndex.load(std::memory_order_acquire);
+                if (head - cachedReadIndex >= Capacity) return false;
+            }
+            slots[head & MASK] = value;
+            writeIndex.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        std::optional<T> pop() {
+            const uint64_t tail = readIndex.load(std::memory_order_relaxed);
+            if (tail == cachedWriteIndex) {
+                cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+                if (tail == cachedWriteIndex) return std::nullopt;
+            }
+            T value = slots[tail & MASK];
+            readIndex.store(tail + 1, std::memory_order_release);
+            return value;
+        }
+
+        // Consumer side, hands every queued value to fn and publishes the freed slots once
+        template<typename F>
+        size_t drain(F&& fn) {
+            const uint64_t tail = readIndex.load(std::memory_order_relaxed);
+            const uint64_t head = writeIndex.load(std::memory_order_acquire);
+            cachedWriteIndex = head;
+            for (uint64_t i = tail; i != head; ++i)
+                fn(slots[i & MASK]);
+            readIndex.store(head, std::memory_order_release);
+            return static_cast<size_t>(head - tail);
+        }
+
+        [[nodiscard]] size_t size() const {
+            return static_cast<size_t>(writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire));
+        }
+        [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+    private:
+        static constexpr uint64_t MASK = Capacity - 1;
+        static constexpr size_t CACHE_LINE = 64;
+
+        // Each side owns one cache line so the producer and consumer never write to the same line
+        alignas(CACHE_LINE) std::atomic<uint64_t> writeIndex{0};
+        uint64_t cachedReadIndex{0};
+        alignas(CACHE_LINE) std::atomic<uint64_t> readIndex{0};
+        uint64_t cachedWriteIndex{0};
+        alignas(CACHE_LINE) std::array<T, Capacity> slots{};
+    };
+}
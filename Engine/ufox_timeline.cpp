@@ -0,0 +1,68 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_timeline.hpp"
+
+#include <algorithm>
+#include <fmt/core.h>
+
+namespace ufox::profiling {
+
+    uint32_t Timeline::begin(std::string name) {
+        const double now = getElapsedMs();
+        std::lock_guard lock(mutex);
+        phases.push_back({ std::move(name), now, -1.0, threadIndex(std::this_thread::get_id()) });
+        return static_cast<uint32_t>(phases.size() - 1);
+    }
+
+    void Timeline::end(uint32_t phase) {
+        const double now = getElapsedMs();
+        std::lock_guard lock(mutex);
+        if (phase < phases.size()) phases[phase].endMs = now;
+    }
+
+    void Timeline::mark(std::string name) {
+        const double now = getElapsedMs();
+        std::lock_guard lock(mutex);
+        phases.push_back({ std::move(name), now, now, threadIndex(std::this_thread::get_id()) });
+    }
+
+    std::vector<Timeline::Phase> Timeline::getPhases() const {
+        std::lock_guard lock(mutex);
+        return phases;
+    }
+
+    double Timeline::getElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+    }
+
+    void Timeline::report(const std::string &title) const {
+        std::vector<Phase> sorted = getPhases();
+        std::ranges::stable_sort(sorted, {}, &Phase::startMs);
+
+        double totalMs = 0.0;
+        for (const Phase& phase : sorted) totalMs = std::max(totalMs, std::max(phase.startMs, phase.endMs));
+        if (totalMs <= 0.0) totalMs = 1.0;
+
+        constexpr int BAR_WIDTH = 40;
+        fmt::println("{} ({:.1f} ms)", title, totalMs);
+        for (const Phase& phase : sorted) {
+            const double endMs = phase.endMs < 0.0 ? totalMs : phase.endMs;
+            const int first = std::clamp(static_cast<int>(phase.startMs / totalMs * BAR_WIDTH), 0, BAR_WIDTH - 1);
+            const int last = std::clamp(static_cast<int>(endMs / totalMs * BAR_WIDTH), first, BAR_WIDTH - 1);
+
+            std::string bar(BAR_WIDTH, ' ');
+            std::fill(bar.begin() + first, bar.begin() + last + 1, phase.endMs == phase.startMs ? '|' : '#');
+            fmt::println("  {:<24} t{} {:>8.2f} {:>8.2f} ms [{}]{}", phase.name, phase.thread, phase.startMs, endMs - phase.startMs,
+                         bar, phase.endMs < 0.0 ? " (running)" : "");
+        }
+    }
+
+    uint32_t Timeline::threadIndex(std::thread::id id) {
+        auto it = std::ranges::find(threads, id);
+        if (it != threads.end()) return static_cast<uint32_t>(it - threads.begin());
+        threads.push_back(id);
+        return static_cast<uint32_t>(threads.size() - 1);
+    }
+}
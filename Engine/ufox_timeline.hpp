@@ -0,0 +1,62 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ufox::profiling {
+
+    // Wall-clock phases relative to construction, recorded from any thread. Meant for one-off sequences such as
+    // startup where the overlap between threads is what matters, not for per-frame timing.
+    class Timeline {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Phase {
+            std::string name;
+            double startMs;
+            double endMs;
+            uint32_t thread;
+        };
+
+        class Scope {
+        public:
+            Scope(Timeline& timeline, uint32_t phase) : timeline{&timeline}, phase{phase} {}
+            ~Scope() { if (timeline) timeline->end(phase); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Timeline* timeline;
+            uint32_t phase;
+        };
+
+        Timeline() : origin{Clock::now()} {}
+
+        uint32_t begin(std::string name);
+        void end(uint32_t phase);
+        [[nodiscard]] Scope scope(std::string name) { return { *this, begin(std::move(name)) }; }
+        // Zero length phase, e.g. the first presented frame
+        void mark(std::string name);
+
+        [[nodiscard]] std::vector<Phase> getPhases() const;
+        [[nodiscard]] double getElapsedMs() const;
+        // One line per phase in start order with a bar showing where it sits on the timeline
+        void report(const std::string& title) const;
+
+    private:
+        Clock::time_point origin;
+        mutable std::mutex mutex;
+        std::vector<Phase> phases;
+        std::vector<std::thread::id> threads;
+
+        uint32_t threadIndex(std::thread::id id);
+    };
+}
@@ -3,3 +3,667 @@
 //
 
 #include "ufox_tools_shader_compiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <fmt/format.h>
+#include <glslang/Include/glslang_c_interface.h>
+#include <glslang/Public/resource_limits_c.h>
+
+#include "Engine/ufox_hash.hpp"
+
+namespace ufox::tools::shader {
+    namespace {
+        constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+        constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+        enum Op : uint32_t {
+            OpName = 5,
+            OpEntryPoint = 15,
+            OpExecutionMode = 16,
+            OpTypeInt = 21,
+            OpTypeFloat = 22,
+            OpTypeVector = 23,
+            OpTypeMatrix = 24,
+            OpTypeImage = 25,
+            OpTypeSampler = 26,
+            OpTypeSampledImage = 27,
+            OpTypeArray = 28,
+            OpTypeRuntimeArray = 29,
+            OpTypeStruct = 30,
+            OpTypePointer = 32,
+            OpConstant = 43,
+            OpVariable = 59,
+            OpDecorate = 71,
+            OpMemberDecorate = 72,
+        };
+
+        enum Decoration : uint32_t {
+            DecorationBlock = 2,
+            DecorationBufferBlock = 3,
+            DecorationArrayStride = 6,
+            DecorationMatrixStride = 7,
+            DecorationBuiltIn = 11,
+            DecorationLocation = 30,
+            DecorationBinding = 33,
+            DecorationDescriptorSet = 34,
+            DecorationOffset = 35,
+        };
+
+        enum StorageClass : uint32_t {
+            StorageUniformConstant = 0,
+            StorageInput = 1,
+            StorageUniform = 2,
+            StoragePushConstant = 9,
+            StorageStorageBuffer = 12,
+        };
+
+        constexpr uint32_t DIM_BUFFER = 5;
+        constexpr uint32_t DIM_SUBPASS_DATA = 6;
+        constexpr uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+
+        struct Type {
+            uint32_t opcode{0};
+            std::vector<uint32_t> operands{};   // words after the result id
+        };
+
+        struct Decorations {
+            std::optional<uint32_t> set;
+            std::optional<uint32_t> binding;
+            std::optional<uint32_t> location;
+            std::optional<uint32_t> arrayStride;
+            bool block{false};
+            bool bufferBlock{false};
+            bool builtIn{false};
+            std::vector<uint32_t> memberOffsets{};
+            std::vector<uint32_t> memberMatrixStrides{};
+        };
+
+        struct Variable {
+            uint32_t id;
+            uint32_t pointerType;
+            uint32_t storageClass;
+        };
+
+        std::string ReadString(std::span<const uint32_t> words) {
+            std::string result;
+            for (uint32_t word : words) {
+                for (int i = 0; i < 4; ++i) {
+                    char c = static_cast<char>((word >> (i * 8)) & 0xFF);
+                    if (c == '\0') return result;
+                    result.push_back(c);
+                }
+            }
+            return result;
+        }
+
+        StageFlags StageFromExecutionModel(uint32_t model) {
+            switch (model) {
+                case 0: return StageVertex;
+                case 1: return StageTessellationControl;
+                case 2: return StageTessellationEvaluation;
+                case 3: return StageGeometry;
+                case 4: return StageFragment;
+                case 5: return StageCompute;
+                default: return StageNone;
+            }
+        }
+
+        class Module {
+        public:
+            explicit Module(std::span<const uint32_t> spirv) {
+                if (spirv.size() < SPIRV_HEADER_WORDS || spirv[0] != SPIRV_MAGIC)
+                    throw std::runtime_error("Invalid SPIR-V module header");
+
+                size_t cursor = SPIRV_HEADER_WORDS;
+                while (cursor < spirv.size()) {
+                    uint32_t wordCount = spirv[cursor] >> 16;
+                    uint32_t opcode = spirv[cursor] & 0xFFFF;
+                    if (wordCount == 0 || cursor + wordCount > spirv.size())
+                        throw std::runtime_error("Truncated SPIR-V instruction");
+
+                    parse(opcode, spirv.subspan(cursor + 1, wordCount - 1));
+                    cursor += wordCount;
+                }
+            }
+
+            Reflection reflect() const {
+                Reflection reflection{};
+                reflection.stage = stage;
+                reflection.entryPoint = entryPoint;
+                reflection.localSize = localSize;
+
+                for (const auto& variable : variables) {
+                    const Type* pointer = findType(variable.pointerType);
+                    if (!pointer || pointer->opcode != OpTypePointer) continue;
+                    uint32_t pointeeId = pointer->operands[1];
+                    const Decorations* decorations = findDecorations(variable.id);
+
+                    switch (variable.storageClass) {
+                        case StorageUniformConstant:
+                        case StorageUniform:
+                        case StorageStorageBuffer: {
+                            if (!decorations || !decorations->binding) break;
+                            reflection.bindings.push_back(makeBinding(variable, pointeeId, *decorations));
+                            break;
+                        }
+                        case StoragePushConstant: {
+                            PushConstantBlock block{};
+                            block.stageFlags = stage;
+                            auto [begin, end] = structExtent(pointeeId);
+                            block.offset = begin;
+                            block.size = end - begin;
+                            reflection.pushConstants = block;
+                            break;
+                        }
+                        case StorageInput: {
+                            if (!decorations || decorations->builtIn || !decorations->location) break;
+                            reflection.inputs.push_back(makeInput(variable, pointeeId, *decorations->location));
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+
+                std::ranges::sort(reflection.bindings, [](const DescriptorBinding& a, const DescriptorBinding& b) {
+                    return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+                });
+                std::ranges::sort(reflection.inputs, {}, &VertexInput::location);
+                return reflection;
+            }
+
+        private:
+            StageFlags stage{StageNone};
+            uint32_t entryPointId{0};
+            std::string entryPoint{};
+            std::array<uint32_t, 3> localSize{0, 0, 0};
+            std::unordered_map<uint32_t, Type> types;
+            std::unordered_map<uint32_t, uint32_t> constants;
+            std::unordered_map<uint32_t, std::string> names;
+            std::unordered_map<uint32_t, Decorations> decorations;
+            std::vector<Variable> variables;
+
+            void parse(uint32_t opcode, std::span<const uint32_t> operands) {
+                switch (opcode) {
+                    case OpName:
+                        if (operands.size() >= 2) names[operands[0]] = ReadString(operands.subspan(1));
+                        break;
+                    case OpEntryPoint:
+                        // Multi-entry modules are reflected for their first entry point
+                        if (operands.size() >= 3 && stage == StageNone) {
+                            stage = StageFromExecutionModel(operands[0]);
+                            entryPointId = operands[1];
+                            entryPoint = ReadString(operands.subspan(2));
+                        }
+                        break;
+                    case OpExecutionMode:
+                        if (operands.size() >= 5 && operands[0] == entryPointId && operands[1] == EXECUTION_MODE_LOCAL_SIZE)
+                            localSize = { operands[2], operands[3], operands[4] };
+                        break;
+                    case OpTypeInt:
+                    case OpTypeFloat:
+                    case OpTypeVector:
+                    case OpTypeMatrix:
+                    case OpTypeImage:
+                    case OpTypeSampler:
+                    case OpTypeSampledImage:
+                    case OpTypeArray:
+                    case OpTypeRuntimeArray:
+                    case OpTypeStruct:
+                    case OpTypePointer:
+                        if (!operands.empty())
+                            types[operands[0]] = Type{ opcode, { operands.begin() + 1, operands.end() } };
+                        break;
+                    case OpConstant:
+                        if (operands.size() >= 3) constants[operands[1]] = operands[2];
+                        break;
+                    case OpVariable:
+                        if (operands.size() >= 3) variables.push_back({ operands[1], operands[0], operands[2] });
+                        break;
+                    case OpDecorate:
+                        if (operands.size() >= 2) decorate(decorations[operands[0]], operands[1], operands.subspan(2));
+                        break;
+                    case OpMemberDecorate:
+                        if (operands.size() >= 4) memberDecorate(decorations[operands[0]], operands[1], operands[2], operands[3]);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            static void decorate(Decorations& target, uint32_t decoration, std::span<const uint32_t> literals) {
+                uint32_t value = literals.empty() ? 0 : literals[0];
+                switch (decoration) {
+                    case DecorationBlock: target.block = true; break;
+                    case DecorationBufferBlock: target.bufferBlock = true; break;
+                    case DecorationBuiltIn: target.builtIn = true; break;
+                    case DecorationArrayStride: target.arrayStride = value; break;
+                    case DecorationLocation: target.location = value; break;
+                    case DecorationBinding: target.binding = value; break;
+                    case DecorationDescriptorSet: target.set = value; break;
+                    default: break;
+                }
+            }
+
+            static void memberDecorate(Decorations& target, uint32_t member, uint32_t decoration, uint32_t value) {
+                auto store = [member, value](std::vector<uint32_t>& values) {
+                    if (values.size() <= member) values.resize(member + 1, 0);
+                    values[member] = value;
+                };
+                if (decoration == DecorationOffset) store(target.memberOffsets);
+                else if (decoration == DecorationMatrixStride) store(target.memberMatrixStrides);
+                else if (decoration == DecorationBuiltIn) target.builtIn = true;
+            }
+
+            const Type* findType(uint32_t id) const {
+                auto it = types.find(id);
+                return it != types.end() ? &it->second : nullptr;
+            }
+
+            const Decorations* findDecorations(uint32_t id) const {
+                auto it = decorations.find(id);
+                return it != decorations.end() ? &it->second : nullptr;
+            }
+
+            uint32_t arrayLength(const Type& array) const {
+                auto it = constants.find(array.operands[1]);
+                return it != constants.end() ? it->second : 1;
+            }
+
+            uint32_t typeSize(uint32_t id, uint32_t matrixStride = 0) const {
+                const Type* type = findType(id);
+                if (!type) return 0;
+                switch (type->opcode) {
+                    case OpTypeInt:
+                    case OpTypeFloat:
+                        return type->operands[0] / 8;
+                    case OpTypeVector:
+                        return typeSize(type->operands[0]) * type->operands[1];
+                    case OpTypeMatrix: {
+                        uint32_t columnSize = matrixStride != 0 ? matrixStride : typeSize(type->operands[0]);
+                        return columnSize * type->operands[1];
+                    }
+                    case OpTypeArray: {
+                        const Decorations* arrayDecorations = findDecorations(id);
+                        uint32_t stride = arrayDecorations && arrayDecorations->arrayStride ? *arrayDecorations->arrayStride
+                                                                                           : typeSize(type->operands[0]);
+                        return stride * arrayLength(*type);
+                    }
+                    case OpTypeRuntimeArray:
+                        return 0;
+                    case OpTypeStruct:
+                        return structExtent(id).second;
+                    default:
+                        return 0;
+                }
+            }
+
+            // [first member offset, end of last member) for a struct type
+            std::pair<uint32_t, uint32_t> structExtent(uint32_t id) const {
+                const Type* type = findType(id);
+                if (!type || type->opcode != OpTypeStruct) return { 0, typeSize(id) };
+
+                const Decorations* structDecorations = findDecorations(id);
+                uint32_t begin = UINT32_MAX;
+                uint32_t end = 0;
+                for (uint32_t member = 0; member < type->operands.size(); ++member) {
+                    uint32_t offset = 0;
+                    uint32_t matrixStride = 0;
+                    if (structDecorations && member < structDecorations->memberOffsets.size())
+                        offset = structDecorations->memberOffsets[member];
+                    if (structDecorations && member < structDecorations->memberMatrixStrides.size())
+                        matrixStride = structDecorations->memberMatrixStrides[member];
+                    begin = std::min(begin, offset);
+                    end = std::max(end, offset + typeSize(type->operands[member], matrixStride));
+                }
+                return { begin == UINT32_MAX ? 0 : begin, end };
+            }
+
+            DescriptorBinding makeBinding(const Variable& variable, uint32_t typeId, const Decorations& variableDecorations) const {
+                DescriptorBinding binding{};
+                binding.set = variableDecorations.set.value_or(0);
+                binding.binding = *variableDecorations.binding;
+                binding.stageFlags = stage;
+
+                auto nameIt = names.find(variable.id);
+                if (nameIt != names.end()) binding.name = nameIt->second;
+
+                const Type* type = findType(typeId);
+                while (type && (type->opcode == OpTypeArray || type->opcode == OpTypeRuntimeArray)) {
+                    binding.count = type->opcode == OpTypeArray ? binding.count * arrayLength(*type) : 0;
+                    typeId = type->operands[0];
+                    type = findType(typeId);
+                }
+                if (!type) throw std::runtime_error("SPIR-V binding references an unknown type");
+
+                switch (type->opcode) {
+                    case OpTypeStruct: {
+                        const Decorations* structDecorations = findDecorations(typeId);
+                        bool storage = variable.storageClass == StorageStorageBuffer ||
+                                       (structDecorations && structDecorations->bufferBlock);
+                        binding.type = storage ? DescriptorType::StorageBuffer : DescriptorType::UniformBuffer;
+                        binding.blockSize = structExtent(typeId).second;
+                        if (binding.name.empty()) {
+                            auto typeName = names.find(typeId);
+                            if (typeName != names.end()) binding.name = typeName->second;
+                        }
+                        break;
+                    }
+                    case OpTypeSampledImage: {
+                        const Type* image = findType(type->operands[0]);
+                        binding.type = image && image->operands[1] == DIM_BUFFER ? DescriptorType::UniformTexelBuffer
+                                                                                 : DescriptorType::CombinedImageSampler;
+                        break;
+                    }
+                    case OpTypeImage: {
+                        uint32_t dim = type->operands[1];
+                        uint32_t sampled = type->operands[5];
+                        if (dim == DIM_SUBPASS_DATA) binding.type = DescriptorType::InputAttachment;
+                        else if (dim == DIM_BUFFER) binding.type = sampled == 2 ? DescriptorType::StorageTexelBuffer : DescriptorType::UniformTexelBuffer;
+                        else binding.type = sampled == 2 ? DescriptorType::StorageImage : DescriptorType::SampledImage;
+                        break;
+                    }
+                    case OpTypeSampler:
+                        binding.type = DescriptorType::Sampler;
+                        break;
+                    default:
+                        throw std::runtime_error("Unsupported SPIR-V descriptor type for binding " + std::to_string(binding.binding));
+                }
+                return binding;
+            }
+
+            VertexInput makeInput(const Variable& variable, uint32_t typeId, uint32_t location) const {
+                VertexInput input{};
+                input.location = location;
+
+                auto nameIt = names.find(variable.id);
+                if (nameIt != names.end()) input.name = nameIt->second;
+
+                const Type* type = findType(typeId);
+                input.componentCount = 1;
+                if (type && type->opcode == OpTypeVector) {
+                    input.componentCount = type->operands[1];
+                    type = findType(type->operands[0]);
+                }
+                if (type && type->opcode == OpTypeFloat) {
+                    input.type = BaseType::Float;
+                    input.componentWidth = type->operands[0];
+                }
+                else if (type && type->opcode == OpTypeInt) {
+                    input.type = type->operands[1] != 0 ? BaseType::Int : BaseType::UInt;
+                    input.componentWidth = type->operands[0];
+                }
+                return input;
+            }
+        };
+    }
+
+    Reflection Reflect(std::span<const uint32_t> spirv) {
+        return Module(spirv).reflect();
+    }
+
+    Reflection Reflect(std::span<const char> bytes) {
+        if (bytes.size() % sizeof(uint32_t) != 0) throw std::runtime_error("SPIR-V size is not a multiple of 4");
+        std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+        std::memcpy(words.data(), bytes.data(), bytes.size());
+        return Reflect(std::span<const uint32_t>(words));
+    }
+
+    namespace {
+        // Bumped whenever compiler settings change so stale disk cache entries are not reused
+        constexpr uint64_t COMPILER_CONFIG_VERSION = 1;
+
+        std::string ReadTextFile(const std::filesystem::path& file) {
+            std::ifstream stream(file, std::ios::binary);
+            if (!stream.is_open()) throw std::runtime_error("Failed to open shader source: " + file.string());
+            std::ostringstream content;
+            content << stream.rdbuf();
+            return content.str();
+        }
+
+        std::optional<std::string> ParseInclude(std::string_view line) {
+            auto first = line.find_first_not_of(" \t");
+            if (first == std::string_view::npos || !line.substr(first).starts_with("#include")) return std::nullopt;
+            auto open = line.find('"', first);
+            auto close = open == std::string_view::npos ? open : line.find('"', open + 1);
+            if (close == std::string_view::npos) throw std::runtime_error("Malformed #include: " + std::string(line));
+            return std::string(line.substr(open + 1, close - open - 1));
+        }
+
+        void ExpandInto(const std::filesystem::path& file, std::string& out,
+                        std::vector<std::filesystem::path>& dependencies, std::set<std::filesystem::path>& stack) {
+            auto canonical = std::filesystem::weakly_canonical(file);
+            if (!stack.insert(canonical).second) throw std::runtime_error("Recursive #include of " + file.string());
+            dependencies.push_back(canonical);
+
+            std::istringstream source(ReadTextFile(file));
+            std::string line;
+            while (std::getline(source, line)) {
+                if (line.find("GL_GOOGLE_include_directive") != std::string::npos) continue;
+                if (auto include = ParseInclude(line)) {
+                    ExpandInto(file.parent_path() / *include, out, dependencies, stack);
+                    continue;
+                }
+                out += line;
+                out += '\n';
+            }
+            stack.erase(canonical);
+        }
+
+        std::optional<glslang_stage_t> StageFromSourceName(const std::string& sourceName) {
+            auto extension = std::filesystem::path(sourceName).extension();
+            if (extension == ".vert") return GLSLANG_STAGE_VERTEX;
+            if (extension == ".frag") return GLSLANG_STAGE_FRAGMENT;
+            if (extension == ".comp") return GLSLANG_STAGE_COMPUTE;
+            if (extension == ".geom") return GLSLANG_STAGE_GEOMETRY;
+            if (extension == ".tesc") return GLSLANG_STAGE_TESSCONTROL;
+            if (extension == ".tese") return GLSLANG_STAGE_TESSEVALUATION;
+            return std::nullopt;
+        }
+
+        std::string InjectDefines(const std::string& source, const Defines& defines) {
+            if (defines.empty()) return source;
+
+            std::string block;
+            for (const auto& [name, value] : defines) block += "#define " + name + " " + value + "\n";
+
+            // #version has to stay the first directive
+            auto version = source.find("#version");
+            if (version == std::string::npos) return block + source;
+            auto lineEnd = source.find('\n', version);
+            if (lineEnd == std::string::npos) return source + "\n" + block;
+            return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+        }
+
+        std::vector<uint32_t> CompileGlsl(const std::string& sourceName, const std::string& source) {
+            static std::once_flag initializeOnce;
+            std::call_once(initializeOnce, [] { glslang_initialize_process(); });
+
+            auto stage = StageFromSourceName(sourceName);
+            if (!stage) throw std::runtime_error("Unknown shader stage for " + sourceName);
+
+            glslang_input_t input{};
+            input.language = GLSLANG_SOURCE_GLSL;
+            input.stage = *stage;
+            input.client = GLSLANG_CLIENT_VULKAN;
+            input.client_version = GLSLANG_TARGET_VULKAN_1_3;
+            input.target_language = GLSLANG_TARGET_SPV;
+            input.target_language_version = GLSLANG_TARGET_SPV_1_6;
+            input.code = source.c_str();
+            input.default_version = 450;
+            input.default_profile = GLSLANG_NO_PROFILE;
+            input.force_default_version_and_profile = false;
+            input.forward_compatible = false;
+            input.messages = GLSLANG_MSG_DEFAULT_BIT;
+            input.resource = glslang_default_resource();
+
+            std::unique_ptr<glslang_shader_t, decltype(&glslang_shader_delete)> shader{ glslang_shader_create(&input), glslang_shader_delete };
+            if (!glslang_shader_preprocess(shader.get(), &input))
+                throw std::runtime_error(fmt::format("Failed to preprocess {}:\n{}", sourceName, glslang_shader_get_info_log(shader.get())));
+            if (!glslang_shader_parse(shader.get(), &input))
+                throw std::runtime_error(fmt::format("Failed to compile {}:\n{}", sourceName, glslang_shader_get_info_log(shader.get())));
+
+            std::unique_ptr<glslang_program_t, decltype(&glslang_program_delete)> program{ glslang_program_create(), glslang_program_delete };
+            glslang_program_add_shader(program.get(), shader.get());
+            if (!glslang_program_link(program.get(), GLSLANG_MSG_SPV_RULES_BIT | GLSLANG_MSG_VULKAN_RULES_BIT))
+                throw std::runtime_error(fmt::format("Failed to link {}:\n{}", sourceName, glslang_program_get_info_log(program.get())));
+
+            glslang_program_SPIRV_generate(program.get(), *stage);
+            std::vector<uint32_t> spirv(glslang_program_SPIRV_get_size(program.get()));
+            glslang_program_SPIRV_get(program.get(), spirv.data());
+            return spirv;
+        }
+
+        std::optional<std::vector<uint32_t>> ReadSpirvFile(const std::filesystem::path& file) {
+            std::ifstream stream(file, std::ios::ate | std::ios::binary);
+            if (!stream.is_open()) return std::nullopt;
+
+            auto size = static_cast<size_t>(stream.tellg());
+            if (size == 0 || size % sizeof(uint32_t) != 0) return std::nullopt;
+
+            std::vector<uint32_t> words(size / sizeof(uint32_t));
+            stream.seekg(0);
+            stream.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(size));
+            return words;
+        }
+    }
+
+    ShaderCompiler::ShaderCompiler(std::filesystem::path sourceDirectory, std::filesystem::path binaryDirectory,
+                                   std::filesystem::path cacheDirectory) :
+        sourceDirectory{std::move(sourceDirectory)}, binaryDirectory{std::move(binaryDirectory)}, cacheDirectory{std::move(cacheDirectory)} {}
+
+    SpirvBinary ShaderCompiler::load(const std::string &name, const Defines &defines) {
+        std::string key = name;
+        for (const auto& [define, value] : defines) key += '\n' + define + '=' + value;
+
+        {
+            std::lock_guard lock(mutex);
+            if (auto it = entries.find(key); it != entries.end() && it->second.binary) {
+                cacheHitCount.fetch_add(1, std::memory_order_relaxed);
+                return it->second.binary;
+            }
+        }
+
+        Entry entry{};
+        entry.name = name;
+        entry.defines = defines;
+
+        std::string sourceName = toSourceName(name);
+        std::filesystem::path sourceFile = sourceDirectory / sourceName;
+        std::error_code error;
+        if (!sourceDirectory.empty() && std::filesystem::exists(sourceFile, error)) {
+            ExpandedSource expanded = expand(sourceFile);
+            entry.hash = hashSource(sourceName, expanded.text, defines);
+            entry.binary = compileExpanded(sourceName, expanded.text, defines, entry.hash);
+            for (const auto& dependency : expanded.dependencies) {
+                entry.timestamps.emplace_back(dependency, std::filesystem::last_write_time(dependency, error));
+            }
+        }
+        else {
+            entry.binary = readPrebuilt(name);
+        }
+
+        std::lock_guard lock(mutex);
+        auto& stored = entries[key];
+        stored = std::move(entry);
+        return stored.binary;
+    }
+
+    std::vector<std::string> ShaderCompiler::pollChanges() {
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::string> changed;
+
+        std::lock_guard lock(mutex);
+        if (now - lastPoll < pollInterval) return changed;
+        lastPoll = now;
+
+        for (auto& [key, entry] : entries) {
+            if (entry.timestamps.empty()) continue;
+
+            std::error_code error;
+            bool touched = std::ranges::any_of(entry.timestamps, [&error](const auto& dependency) {
+                return std::filesystem::last_write_time(dependency.first, error) != dependency.second;
+            });
+            if (!touched) continue;
+
+            // Editors often rewrite files without changing them, only a different hash counts as a change
+            try {
+                std::string sourceName = toSourceName(entry.name);
+                ExpandedSource expanded = expand(sourceDirectory / sourceName);
+                entry.timestamps.clear();
+                for (const auto& dependency : expanded.dependencies) {
+                    entry.timestamps.emplace_back(dependency, std::filesystem::last_write_time(dependency, error));
+                }
+                if (hashSource(sourceName, expanded.text, entry.defines) == entry.hash) continue;
+            }
+            catch (const std::exception&) {
+                // Mid-save or deleted, try again on the next poll
+                continue;
+            }
+
+            entry.binary.reset();
+            if (std::ranges::find(changed, entry.name) == changed.end()) changed.push_back(entry.name);
+        }
+        return changed;
+    }
+
+    std::string ShaderCompiler::toSourceName(const std::string &name) const {
+        std::filesystem::path path(name);
+        if (path.extension() == ".spv") path.replace_extension();
+        return path.filename().string();
+    }
+
+    ShaderCompiler::ExpandedSource ShaderCompiler::expand(const std::filesystem::path &file) const {
+        ExpandedSource expanded{};
+        std::set<std::filesystem::path> stack;
+        ExpandInto(file, expanded.text, expanded.dependencies, stack);
+        return expanded;
+    }
+
+    SpirvBinary ShaderCompiler::compileExpanded(const std::string &sourceName, const std::string &source,
+                                                const Defines &defines, uint64_t hash) {
+        std::filesystem::path cachedFile;
+        if (!cacheDirectory.empty()) {
+            cachedFile = cacheDirectory / fmt::format("{}.{:016x}.spv", sourceName, hash);
+            if (auto cached = ReadSpirvFile(cachedFile)) {
+                cacheHitCount.fetch_add(1, std::memory_order_relaxed);
+                return std::make_shared<const std::vector<uint32_t>>(std::move(*cached));
+            }
+        }
+
+        auto spirv = CompileGlsl(sourceName, InjectDefines(source, defines));
+        compileCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (!cachedFile.empty()) {
+            std::error_code error;
+            std::filesystem::create_directories(cacheDirectory, error);
+            std::ofstream stream(cachedFile, std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char*>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+        }
+        return std::make_shared<const std::vector<uint32_t>>(std::move(spirv));
+    }
+
+    SpirvBinary ShaderCompiler::readPrebuilt(const std::string &name) const {
+        std::filesystem::path file = binaryDirectory / name;
+        auto words = ReadSpirvFile(file);
+        if (!words) throw std::runtime_error("Failed to open shader: " + file.string());
+        return std::make_shared<const std::vector<uint32_t>>(std::move(*words));
+    }
+
+    uint64_t ShaderCompiler::hashSource(const std::string &sourceName, const std::string &source, const Defines &defines) {
+        uint64_t seed = hash::Combine(hash::FNV_OFFSET_BASIS, COMPILER_CONFIG_VERSION);
+        seed = hash::Fnv1a64(std::filesystem::path(sourceName).extension().string(), seed);
+        seed = hash::Fnv1a64(source, seed);
+        for (const auto& [name, value] : defines) {
+            seed = hash::Fnv1a64(name, seed);
+            seed = hash::Fnv1a64(value, seed);
+        }
+        return seed;
+    }
+}
@@ -3,12 +3,142 @@
 //
 
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace ufox::tools::shader {
 
+    // Bit values match VkShaderStageFlagBits so the graphics side can cast them directly
+    enum StageFlags : uint32_t {
+        StageNone = 0,
+        StageVertex = 0x00000001,
+        StageTessellationControl = 0x00000002,
+        StageTessellationEvaluation = 0x00000004,
+        StageGeometry = 0x00000008,
+        StageFragment = 0x00000010,
+        StageCompute = 0x00000020,
+    };
 
+    // Values match VkDescriptorType for the same reason
+    enum class DescriptorType : uint32_t {
+        Sampler = 0,
+        CombinedImageSampler = 1,
+        SampledImage = 2,
+        StorageImage = 3,
+        UniformTexelBuffer = 4,
+        StorageTexelBuffer = 5,
+        UniformBuffer = 6,
+        StorageBuffer = 7,
+        InputAttachment = 10,
+    };
 
+    enum class BaseType : uint8_t {
+        Unknown,
+        Float,
+        Int,
+        UInt,
+    };
+
+    struct DescriptorBinding {
+        uint32_t set{0};
+        uint32_t binding{0};
+        uint32_t count{1};          // array length, 0 for runtime-sized arrays
+        DescriptorType type{DescriptorType::UniformBuffer};
+        uint32_t stageFlags{StageNone};
+        uint32_t blockSize{0};      // bytes for uniform/storage blocks, 0 otherwise
+        std::string name{};
+    };
+
+    struct PushConstantBlock {
+        uint32_t offset{0};
+        uint32_t size{0};
+        uint32_t stageFlags{StageNone};
+    };
+
+    struct VertexInput {
+        uint32_t location{0};
+        BaseType type{BaseType::Unknown};
+        uint32_t componentCount{0};
+        uint32_t componentWidth{32};
+        std::string name{};
+    };
+
+    struct Reflection {
+        StageFlags stage{StageNone};
+        std::string entryPoint{};
+        std::vector<DescriptorBinding> bindings{};            // sorted by set, binding
+        std::optional<PushConstantBlock> pushConstants{};
+        std::vector<VertexInput> inputs{};                    // stage inputs with a Location, sorted
+        std::array<uint32_t, 3> localSize{0, 0, 0};           // compute only
+    };
+
+    // Parses a SPIR-V module and extracts its resource interface. Throws std::runtime_error on malformed input.
+    [[nodiscard]] Reflection Reflect(std::span<const uint32_t> spirv);
+    [[nodiscard]] Reflection Reflect(std::span<const char> bytes);
+
+    using Defines = std::vector<std::pair<std::string, std::string>>;
+    using SpirvBinary = std::shared_ptr<const std::vector<uint32_t>>;
+
+    // Compiles GLSL in-process with glslang. Results are cached in memory and on disk, keyed by a content hash of
+    // the include-expanded source, the defines and the stage, so untouched shaders never hit the compiler twice.
+    // Modules without a source file under sourceDirectory fall back to the prebuilt .spv in binaryDirectory.
+    class ShaderCompiler {
+    public:
+        ShaderCompiler(std::filesystem::path sourceDirectory, std::filesystem::path binaryDirectory,
+                       std::filesystem::path cacheDirectory = {});
+
+        // name is either a source name ("shader.frag") or a prebuilt path ("shaders/shader.frag.spv")
+        [[nodiscard]] SpirvBinary load(const std::string& name, const Defines& defines = {});
+
+        // Checks the timestamps of every loaded source and its includes, at most once per poll interval.
+        // Returns the names passed to load() whose content changed; their next load() recompiles.
+        [[nodiscard]] std::vector<std::string> pollChanges();
+        void setPollInterval(std::chrono::milliseconds interval) { pollInterval = interval; }
+
+        [[nodiscard]] uint32_t getCompileCount() const { return compileCount.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint32_t getCacheHitCount() const { return cacheHitCount.load(std::memory_order_relaxed); }
+
+    private:
+        struct ExpandedSource {
+            std::string text{};
+            std::vector<std::filesystem::path> dependencies{};
+        };
+
+        struct Entry {
+            std::string name{};
+            Defines defines{};
+            SpirvBinary binary{};
+            uint64_t hash{0};
+            std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> timestamps{};
+        };
+
+        std::filesystem::path sourceDirectory;
+        std::filesystem::path binaryDirectory;
+        std::filesystem::path cacheDirectory;
+
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::chrono::milliseconds pollInterval{250};
+        std::chrono::steady_clock::time_point lastPoll{};
+        std::atomic<uint32_t> compileCount{0};
+        std::atomic<uint32_t> cacheHitCount{0};
+
+        [[nodiscard]] std::string toSourceName(const std::string& name) const;
+        [[nodiscard]] ExpandedSource expand(const std::filesystem::path& file) const;
+        [[nodiscard]] SpirvBinary compileExpanded(const std::string& sourceName, const std::string& source,
+                                                  const Defines& defines, uint64_t hash);
+        [[nodiscard]] SpirvBinary readPrebuilt(const std::string& name) const;
+        [[nodiscard]] static uint64_t hashSource(const std::string& sourceName, const std::string& source, const Defines& defines);
+    };
 }
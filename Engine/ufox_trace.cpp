@@ -0,0 +1,96 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include "ufox_trace.hpp"
+
+#include <algorithm>
+
+namespace ufox::graphics::vulkan {
+    namespace {
+        constexpr char TRACE_MAGIC[4] = { 'U', 'F', 'T', 'R' };
+        constexpr size_t RECORD_ALIGNMENT = 8;
+
+        constexpr size_t AlignRecord(size_t size) {
+            return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+        }
+    }
+
+    TraceWriter::TraceWriter(const std::filesystem::path &path) : file{path, std::ios::binary | std::ios::trunc} {
+        if (!file) throw std::runtime_error("Failed to create trace " + path.string());
+        buffer.reserve(BUFFER_SIZE);
+
+        TraceHeader header{};
+        std::ranges::copy(TRACE_MAGIC, header.magic);
+        header.version = TRACE_VERSION;
+        const auto bytes = std::as_bytes(std::span{ &header, 1 });
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    TraceWriter::~TraceWriter() {
+        std::lock_guard lock(mutex);
+        flushLocked();
+    }
+
+    void TraceWriter::flush() {
+        std::lock_guard lock(mutex);
+        flushLocked();
+        file.flush();
+    }
+
+    uint64_t TraceWriter::getBytesWritten() const {
+        std::lock_guard lock(mutex);
+        return bytesWritten + buffer.size();
+    }
+
+    void TraceWriter::append(TraceOp op, std::span<const std::byte> payload, std::span<const std::byte> trailing) {
+        const size_t size = AlignRecord(payload.size() + trailing.size());
+        if (size > UINT32_MAX) throw std::runtime_error("Trace record too large");
+        const TraceRecordHeader header{ op, 0, static_cast<uint32_t>(size) };
+        const auto headerBytes = std::as_bytes(std::span{ &header, 1 });
+
+        std::lock_guard lock(mutex);
+        if (buffer.size() + sizeof(header) + size > BUFFER_SIZE) flushLocked();
+        buffer.insert(buffer.end(), headerBytes.begin(), headerBytes.end());
+        buffer.insert(buffer.end(), payload.begin(), payload.end());
+        buffer.insert(buffer.end(), trailing.begin(), trailing.end());
+        buffer.resize(buffer.size() + size - payload.size() - trailing.size(), std::byte{0});
+
+        if (op == TraceOp::Submit) {
+            flushLocked();
+            file.flush();
+        }
+    }
+
+    void TraceWriter::flushLocked() {
+        if (buffer.empty()) return;
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        bytesWritten += buffer.size();
+        buffer.clear();
+    }
+
+    TraceReader::TraceReader(const std::filesystem::path &path) : file{path} {
+        const std::span<const std::byte> bytes = file.getBytes();
+        TraceHeader header{};
+        if (bytes.size() < sizeof(header)) throw std::runtime_error("Not a trace: " + path.string());
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (!std::ranges::equal(header.magic, TRACE_MAGIC)) throw std::runtime_error("Not a trace: " + path.string());
+        if (header.version != TRACE_VERSION)
+            throw std::runtime_error("Trace version " + std::to_string(header.version) + " is not supported: " + path.string());
+    }
+
+    bool TraceReader::next(TraceRecord &record) {
+        const std::span<const std::byte> bytes = file.getBytes();
+        if (position + sizeof(TraceRecordHeader) > bytes.size()) return false;
+
+        TraceRecordHeader header{};
+        std::memcpy(&header, bytes.data() + position, sizeof(header));
+        position += sizeof(header);
+        // A capture cut short by a crash ends in a partial record, everything before it still replays
+        if (position + header.size > bytes.size()) return false;
+
+        record = { header.op, bytes.subspan(position, header.size) };
+        position += header.size;
+        return true;
+    }
+}
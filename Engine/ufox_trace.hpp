@@ -0,0 +1,312 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <vulkan/vulkan_raii.hpp>
+#include "Engine/ufox_asset_pack.hpp"
+
+namespace ufox::graphics::vulkan {
+
+    // Binary log of what GraphicsDevice hands to Vulkan: resource creation, uploads, pipelines, descriptor writes and
+    // the command stream of each frame. A 16 byte TraceHeader is followed by records, each a TraceRecordHeader and
+    // a payload padded to 8 bytes. Objects are identified by their handle value at capture time, a value seen again
+    // in a Create record refers to a new object from then on. Tools/ufox_trace_replay.cpp re-executes a log.
+    static constexpr uint32_t TRACE_VERSION = 1;
+
+    enum class TraceOp : uint16_t {
+        CreateBuffer,
+        CreateImage,
+        SwapchainImage,
+        ImageView,
+        BufferData,         // payload followed by size bytes
+        CopyBuffer,
+        CopyBufferToImage,
+        DefinePipeline,     // payload followed by both shader paths and the specialization constants
+        WriteDescriptor,
+        BeginFrame,
+        Barrier,
+        BeginRendering,
+        EndRendering,
+        SetDepthState,
+        SetViewport,
+        SetScissor,
+        BindPipeline,
+        BindDescriptorSet,
+        BindVertexBuffer,
+        BindIndexBuffer,
+        PushConstants,      // payload followed by size bytes
+        DrawIndexed,
+        Submit,
+    };
+
+    struct TraceHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(TraceHeader) == 16);
+
+    struct TraceRecordHeader {
+        TraceOp op;
+        uint16_t reserved;
+        uint32_t size;          // payload bytes including padding
+    };
+    static_assert(sizeof(TraceRecordHeader) == 8);
+
+    struct TraceCreateBuffer {
+        static constexpr TraceOp OP = TraceOp::CreateBuffer;
+        uint64_t buffer;
+        uint64_t size;
+        uint32_t usage;
+        uint32_t memoryProperties;
+    };
+
+    struct TraceCreateImage {
+        static constexpr TraceOp OP = TraceOp::CreateImage;
+        uint64_t image;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t samples;
+        uint32_t usage;
+        uint32_t memoryProperties;
+    };
+
+    // Swapchain images are replayed as plain color attachments
+    struct TraceSwapchainImage {
+        static constexpr TraceOp OP = TraceOp::SwapchainImage;
+        uint64_t image;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t reserved;
+    };
+
+    struct TraceImageView {
+        static constexpr TraceOp OP = TraceOp::ImageView;
+        uint64_t view;
+        uint64_t image;
+    };
+
+    struct TraceBufferData {
+        static constexpr TraceOp OP = TraceOp::BufferData;
+        uint64_t buffer;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct TraceCopyBuffer {
+        static constexpr TraceOp OP = TraceOp::CopyBuffer;
+        uint64_t source;
+        uint64_t destination;
+        uint64_t size;
+    };
+
+    // Whole single mip color image, the image ends up in eShaderReadOnlyOptimal
+    struct TraceCopyBufferToImage {
+        static constexpr TraceOp OP = TraceOp::CopyBufferToImage;
+        uint64_t buffer;
+        uint64_t image;
+    };
+
+    struct TraceDefinePipeline {
+        static constexpr TraceOp OP = TraceOp::DefinePipeline;
+        uint64_t pipeline;
+        uint32_t vertexLayout;
+        uint32_t blendMode;
+        uint32_t colorFormat;
+        uint32_t depthFormat;
+        uint32_t samples;
+        uint32_t vertexShaderLength;
+        uint32_t fragmentShaderLength;
+        uint32_t specializationCount;
+    };
+
+    struct TraceWriteDescriptor {
+        static constexpr TraceOp OP = TraceOp::WriteDescriptor;
+        uint64_t set;
+        uint32_t binding;
+        uint32_t arrayElement;
+        uint32_t type;
+        uint32_t imageLayout;
+        uint64_t buffer;        // buffer descriptors
+        uint64_t offset;
+        uint64_t range;
+        uint64_t view;          // image descriptors, replayed with a shared sampler
+    };
+
+    struct TraceBeginFrame {
+        static constexpr TraceOp OP = TraceOp::BeginFrame;
+        uint64_t frameNumber;
+    };
+
+    struct TraceBarrier {
+        static constexpr TraceOp OP = TraceOp::Barrier;
+        uint64_t image;
+        uint64_t srcStage;
+        uint64_t dstStage;
+        uint64_t srcAccess;
+        uint64_t dstAccess;
+        uint32_t oldLayout;
+        uint32_t newLayout;
+        uint32_t aspect;
+        uint32_t reserved;
+    };
+
+    struct TraceBeginRendering {
+        static constexpr TraceOp OP = TraceOp::BeginRendering;
+        uint64_t colorImage;
+        uint64_t resolveImage;  // 0 without MSAA
+        uint64_t depthImage;    // 0 without depth
+        uint32_t width;
+        uint32_t height;
+        float clearColor[4];
+    };
+
+    struct TraceEndRendering {
+        static constexpr TraceOp OP = TraceOp::EndRendering;
+    };
+
+    struct TraceSetDepthState {
+        static constexpr TraceOp OP = TraceOp::SetDepthState;
+        uint32_t testEnable;
+        uint32_t writeEnable;
+        uint32_t compareOp;
+    };
+
+    struct TraceSetViewport {
+        static constexpr TraceOp OP = TraceOp::SetViewport;
+        float x, y, width, height, minDepth, maxDepth;
+    };
+
+    struct TraceSetScissor {
+        static constexpr TraceOp OP = TraceOp::SetScissor;
+        int32_t x, y;
+        uint32_t width, height;
+    };
+
+    struct TraceBindPipeline {
+        static constexpr TraceOp OP = TraceOp::BindPipeline;
+        uint64_t pipeline;
+    };
+
+    // Bound at set 0 through the layout of the last bound pipeline
+    struct TraceBindDescriptorSet {
+        static constexpr TraceOp OP = TraceOp::BindDescriptorSet;
+        uint64_t set;
+    };
+
+    struct TraceBindVertexBuffer {
+        static constexpr TraceOp OP = TraceOp::BindVertexBuffer;
+        uint64_t buffer;
+    };
+
+    struct TraceBindIndexBuffer {
+        static constexpr TraceOp OP = TraceOp::BindIndexBuffer;
+        uint64_t buffer;
+        uint32_t indexType;
+    };
+
+    struct TracePushConstants {
+        static constexpr TraceOp OP = TraceOp::PushConstants;
+        uint32_t stages;
+        uint32_t size;
+    };
+
+    struct TraceDrawIndexed {
+        static constexpr TraceOp OP = TraceOp::DrawIndexed;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+    };
+
+    struct TraceSubmit {
+        static constexpr TraceOp OP = TraceOp::Submit;
+        uint32_t presentCount;
+    };
+
+    // Handle value used as the object's id in the log, 0 for a null handle
+    template<typename Handle>
+    [[nodiscard]] uint64_t TraceId(Handle handle) {
+        const typename Handle::CType raw = static_cast<typename Handle::CType>(handle);
+        uint64_t id = 0;
+        std::memcpy(&id, &raw, sizeof(raw));
+        return id;
+    }
+
+    // Appends records from any thread, they land in the file in the order they were written. Records go through a
+    // buffer of a few hundred KiB, so a call costs a memcpy, not a write. Every Submit hands the buffer to the OS,
+    // so a crash loses at most the frame that was being recorded.
+    class TraceWriter {
+    public:
+        explicit TraceWriter(const std::filesystem::path& path);
+        ~TraceWriter();
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        template<typename T>
+        void record(const T& payload, std::span<const std::byte> trailing = {}) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if constexpr (std::is_empty_v<T>) append(T::OP, {}, trailing);
+            else append(T::OP, std::as_bytes(std::span{ &payload, 1 }), trailing);
+        }
+
+        void flush();
+        [[nodiscard]] uint64_t getBytesWritten() const;
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 512 * 1024;
+
+        mutable std::mutex mutex;
+        std::ofstream file;
+        std::vector<std::byte> buffer;
+        uint64_t bytesWritten{0};
+
+        void append(TraceOp op, std::span<const std::byte> payload, std::span<const std::byte> trailing);
+        void flushLocked();
+    };
+
+    struct TraceRecord {
+        TraceOp op;
+        std::span<const std::byte> payload;     // fixed part first, then the trailing bytes
+
+        // Fixed part of the payload, copied out since records are only 8 byte aligned
+        template<typename T>
+        [[nodiscard]] T as() const {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (payload.size() < sizeof(T)) throw std::runtime_error("Truncated trace record");
+            T value{};
+            std::memcpy(&value, payload.data(), sizeof(T));
+            return value;
+        }
+        // Bytes following the fixed part T
+        template<typename T>
+        [[nodiscard]] std::span<const std::byte> trailing() const { return payload.subspan(std::is_empty_v<T> ? 0 : sizeof(T)); }
+    };
+
+    // Walks a memory mapped log, throws on a foreign or newer file
+    class TraceReader {
+    public:
+        explicit TraceReader(const std::filesystem::path& path);
+
+        // False at the end of the log
+        bool next(TraceRecord& record);
+        void rewind() { position = sizeof(TraceHeader); }
+
+    private:
+        assets::MappedFile file;
+        size_t position{sizeof(TraceHeader)};
+    };
+}
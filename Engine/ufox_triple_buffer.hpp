@@ -0,0 +1,48 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ufox {
+
+    // Latest-value handoff between one writer and one reader thread. The writer fills its back slot and publishes
+    // it, the reader picks up the newest published slot. Neither side blocks and intermediate values may be
+    // skipped, which is what per-frame state wants.
+    template<typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer() = default;
+        explicit TripleBuffer(const T& initial) { slots.fill(initial); }
+
+        // Writer side, the slot stays owned by the writer until publish
+        [[nodiscard]] T& back() { return slots[backIndex]; }
+        void publish() {
+            backIndex = middle.exchange(backIndex | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        void publish(const T& value) {
+            back() = value;
+            publish();
+        }
+
+        // Reader side, returns true when a newer value was published since the last call
+        bool update() {
+            if (!(middle.load(std::memory_order_relaxed) & DIRTY)) return false;
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+        [[nodiscard]] const T& front() const { return slots[frontIndex]; }
+
+    private:
+        static constexpr uint8_t DIRTY = 0x4;
+        static constexpr uint8_t INDEX_MASK = 0x3;
+
+        std::array<T, 3> slots{};
+        uint8_t frontIndex{0};
+        alignas(64) std::atomic<uint8_t> middle{1};
+        alignas(64) uint8_t backIndex{2};
+    };
+}
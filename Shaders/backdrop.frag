@@ -0,0 +1,32 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Frosted-glass backdrops for EffectsRenderer, drawn with path.vert. Samples the blurred copy of what was drawn
+// behind the node and tints it, clipped to the node's rounded box.
+
+layout(location = 0) in vec4 fragColor;         // tint, alpha is the tint strength
+layout(location = 1) in vec2 fragLocal;         // pixels from the node's center
+layout(location = 2) flat in uint fragBlock;
+
+// Per effect: [0] half size, unused  [1] corner radius  [2] source origin, 1 / source extent
+layout(std430, binding = 0) readonly buffer EffectData {
+    vec4 data[];
+} effects;
+
+layout(binding = 1) uniform sampler2D blurred;
+
+layout(location = 0) out vec4 outColor;
+
+#include "sdf.glsl"
+
+void main() {
+    vec4 shape = effects.data[fragBlock];
+    vec4 radius = effects.data[fragBlock + 1u];
+    vec4 source = effects.data[fragBlock + 2u];
+
+    float coverage = clamp(0.5 - roundedBoxSDF(fragLocal, shape.xy, radius), 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+
+    vec3 color = texture(blurred, (gl_FragCoord.xy - source.xy) * source.zw).rgb;
+    outColor = vec4(mix(color, fragColor.rgb, fragColor.a), coverage);
+}
@@ -0,0 +1,60 @@
+#version 450
+
+// Fills a path without triangulating it: the fragment counts the signed crossings of a horizontal ray with the
+// outline, weighting each crossing by how much of the pixel lies left of it, at two rows for vertical coverage.
+//
+// Geometry block written by PathGeometry::writeBlock, in vec4 units from fragBlock:
+//   0: bounds min x, min y, max x, max y
+//   1: band count, fill rule, bands per pixel, segment base       (counts and offsets as uint bits)
+//   2: bands, two uvec2(first segment, segment count) per vec4
+//   segment base: x0, y0, x1, y1 per segment, grouped by band
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragLocal;
+layout(location = 2) flat in uint fragBlock;
+
+layout(std430, binding = 0) readonly buffer PathData {
+    vec4 data[];
+} paths;
+
+layout(location = 0) out vec4 outColor;
+
+const uint FILL_NON_ZERO = 0u;
+
+float rowWinding(uint first, uint count, vec2 point) {
+    float winding = 0.0;
+    for (uint i = 0u; i < count; ++i) {
+        vec4 segment = paths.data[first + i];
+        if ((segment.y <= point.y) != (segment.w <= point.y)) {
+            float x = segment.x + (point.y - segment.y) * (segment.z - segment.x) / (segment.w - segment.y);
+            float direction = segment.w > segment.y ? 1.0 : -1.0;
+            winding += direction * clamp(x - fragLocal.x + 0.5, 0.0, 1.0);
+        }
+    }
+    return winding;
+}
+
+float rowCoverage(float winding, uint fillRule) {
+    winding = abs(winding);
+    if (fillRule == FILL_NON_ZERO) return min(winding, 1.0);
+    return 1.0 - abs(1.0 - mod(winding, 2.0));
+}
+
+void main() {
+    vec4 bounds = paths.data[fragBlock];
+    vec4 header = paths.data[fragBlock + 1u];
+    uint bandCount = floatBitsToUint(header.x);
+    uint fillRule = floatBitsToUint(header.y);
+    uint segmentBase = fragBlock + floatBitsToUint(header.w);
+
+    int band = clamp(int(floor((fragLocal.y - bounds.y) * header.z)), 0, int(bandCount) - 1);
+    vec4 pair = paths.data[fragBlock + 2u + uint(band) / 2u];
+    uvec2 range = floatBitsToUint((band & 1) == 0 ? pair.xy : pair.zw);
+    uint first = segmentBase + range.x;
+
+    float coverage = 0.5 * (rowCoverage(rowWinding(first, range.y, vec2(fragLocal.x, fragLocal.y - 0.25)), fillRule) +
+                            rowCoverage(rowWinding(first, range.y, vec2(fragLocal.x, fragLocal.y + 0.25)), fillRule));
+    if (coverage <= 0.0) discard;
+
+    outColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
@@ -0,0 +1,24 @@
+#version 450
+
+// Bounding quads of the paths queued on a PathRenderer, positions are framebuffer pixels so no uniform buffer
+// is involved and every path of a frame shares one draw.
+
+layout(push_constant) uniform PathPass {
+    vec2 inverseViewport;   // 1 / framebuffer size
+} pass;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in vec2 inLocal;   // same corner in path space
+layout(location = 3) in uint inBlock;   // first vec4 of the path's geometry block
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragLocal;
+layout(location = 2) flat out uint fragBlock;
+
+void main() {
+    gl_Position = vec4(inPosition * pass.inverseViewport * 2.0 - 1.0, 0.0, 1.0);
+    fragColor = inColor;
+    fragLocal = inLocal;
+    fragBlock = inBlock;
+}
@@ -0,0 +1,11 @@
+// Signed distance helpers shared by the GUI shaders, no declarations needed from the including file.
+
+// SDF for a rounded rectangle with per-corner radius
+float roundedBoxSDF(vec2 centerPosition, vec2 size, vec4 radius) {
+    float finalRadius = (centerPosition.x < 0.0 && centerPosition.y > 0.0) ? radius.x : // Top-left
+    (centerPosition.x > 0.0 && centerPosition.y > 0.0) ? radius.y : // Top-right
+    (centerPosition.x < 0.0 && centerPosition.y < 0.0) ? radius.z : // Bottom-left
+    radius.w; // Bottom-right
+    vec2 q = abs(centerPosition) - size + finalRadius;
+    return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - finalRadius;
+}
@@ -6,6 +6,12 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ufo;
 
+// 1.0 for float positions, 1/4 for the 14.2 fixed-point PackedVertex layout
+layout(constant_id = 0) const float positionScale = 1.0;
+
+// Clip table entry of every vertex, parallel to the vertex buffer. Indexing by vertex keeps merged draws correct.
+layout(std430, binding = 3) readonly buffer VertexClips { uint vertexClips[]; };
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec4 inColor;
 layout(location = 2) in vec2 inTexCoord;
@@ -13,10 +19,12 @@ layout(location = 2) in vec2 inTexCoord;
 layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec2 fragScale;
+layout(location = 3) flat out uint fragClipIndex;
 
 void main() {
-    gl_Position = ufo.proj * ufo.view * ufo.model * vec4(inPosition, 1.0);
+    gl_Position = ufo.proj * ufo.view * ufo.model * vec4(inPosition.xy * positionScale, inPosition.z, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
     fragScale = vec2(ufo.model[0][0], ufo.model[1][1]);
+    fragClipIndex = vertexClips[gl_VertexIndex];
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+layout(location = 0) in vec4 fragColor; // RGBA, with alpha as a base value
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in vec2 fragScale; // Rectangle size from vertex shader
+
+layout(binding = 1) uniform sampler2D texSampler;
+layout(push_constant) uniform RoundedRectParams {
+    vec4 cornerRadius;       // x: top-left, y: top-right, z: bottom-left, w: bottom-right
+    vec4 borderThickness;   // x: top, y: right, z: bottom, w: left
+    vec4 borderTopColor;    // Color for top border
+    vec4 borderRightColor;  // Color for right border
+    vec4 borderBottomColor; // Color for bottom border
+    vec4 borderLeftColor;   // Color for left border
+} params;
+
+#include "rounded_rect.glsl"
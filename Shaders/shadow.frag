@@ -0,0 +1,37 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Analytic drop shadows for EffectsRenderer, drawn with path.vert. The shadow is the rounded box convolved with a
+// Gaussian, approximated by running the box's signed distance through erf, so no blur pass is involved.
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragLocal;         // pixels from the shadow's center
+layout(location = 2) flat in uint fragBlock;
+
+// Per effect: [0] half size, sigma, unused  [1] corner radius
+layout(std430, binding = 0) readonly buffer EffectData {
+    vec4 data[];
+} effects;
+
+layout(location = 0) out vec4 outColor;
+
+#include "sdf.glsl"
+
+// Abramowitz and Stegun 7.1.26, max error 1.5e-7
+float erfApprox(float x) {
+    float t = 1.0 / (1.0 + 0.3275911 * abs(x));
+    float y = 1.0 - (((((1.061405429 * t - 1.453152027) * t) + 1.421413741) * t - 0.284496736) * t + 0.254829592) * t * exp(-x * x);
+    return sign(x) * y;
+}
+
+void main() {
+    vec4 shape = effects.data[fragBlock];
+    vec4 radius = effects.data[fragBlock + 1u];
+    float sigma = shape.z;
+
+    float dist = roundedBoxSDF(fragLocal, shape.xy, radius);
+    float coverage = sigma > 0.0 ? 0.5 - 0.5 * erfApprox(dist / (sigma * 1.41421356)) : clamp(0.5 - dist, 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+
+    outColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
@@ -0,0 +1,104 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include "Engine/ufox_asset_pack.hpp"
+
+namespace {
+    using namespace ufox::assets;
+
+    bool IsImage(const std::string& extension) {
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+    }
+
+    std::vector<std::byte> ReadFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) throw std::runtime_error("Failed to open " + path.string());
+
+        std::vector<std::byte> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
+    // Decoded ahead of time so the engine copies pixels straight from the mapping into staging memory
+    void AddImage(AssetPackWriter& writer, const std::string& name, const std::filesystem::path& path) {
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> rawSurface{IMG_Load(path.string().c_str()), SDL_DestroySurface};
+        if (!rawSurface) throw std::runtime_error(fmt::format("Failed to load {}: {}", path.string(), SDL_GetError()));
+
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{SDL_ConvertSurface(rawSurface.get(), SDL_PIXELFORMAT_ABGR8888), SDL_DestroySurface};
+        if (!surface) throw std::runtime_error(fmt::format("Failed to convert {}: {}", path.string(), SDL_GetError()));
+
+        const auto width = static_cast<uint32_t>(surface->w);
+        const auto height = static_cast<uint32_t>(surface->h);
+        const size_t rowSize = size_t{width} * 4;
+
+        std::vector<std::byte> pixels(rowSize * height);
+        const auto* source = static_cast<const std::byte*>(surface->pixels);
+        for (uint32_t y = 0; y < height; ++y)
+            std::memcpy(pixels.data() + y * rowSize, source + static_cast<size_t>(y) * surface->pitch, rowSize);
+
+        writer.addTexture(name, { width, height, TextureFormat::Rgba8Srgb, 1 }, pixels);
+    }
+
+    void AddDirectory(AssetPackWriter& writer, const std::filesystem::path& root) {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file()) files.push_back(entry.path());
+        }
+        // Directory iteration order is unspecified, sorting keeps packs byte identical between runs
+        std::ranges::sort(files);
+
+        for (const auto& path : files) {
+            const std::string name = std::filesystem::relative(path, root).generic_string();
+            std::string extension = path.extension().string();
+            std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+            if (IsImage(extension)) AddImage(writer, name, path);
+            else if (extension == ".spv") writer.add(name, AssetType::Shader, ReadFile(path), Compression::Lz);
+            else if (extension == ".ttf" || extension == ".otf") writer.add(name, AssetType::Font, ReadFile(path), Compression::Lz);
+            else writer.add(name, AssetType::Raw, ReadFile(path), Compression::Lz);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fmt::println("Usage: {} <output.ufpk> <directory>...", argv[0]);
+        return 1;
+    }
+
+    try {
+        AssetPackWriter writer{};
+        for (int i = 2; i < argc; ++i) AddDirectory(writer, argv[i]);
+        writer.write(argv[1]);
+
+        AssetPack pack(argv[1]);
+        uint64_t storedBytes = 0;
+        uint64_t bytes = 0;
+        for (const PackEntry& entry : pack.getEntries()) {
+            if (!pack.verify(entry)) throw std::runtime_error(fmt::format("Verification failed for {}", pack.getName(entry)));
+            fmt::println("  {:<40} {:>10} -> {:>10} {}", pack.getName(entry), entry.size, entry.storedSize,
+                         entry.compression == Compression::Lz ? "lz" : "raw");
+            storedBytes += entry.storedSize;
+            bytes += entry.size;
+        }
+        fmt::println("Packed {} assets into {}: {} -> {} bytes", writer.getEntryCount(), argv[1], bytes, storedBytes);
+    }
+    catch (const std::exception& e) {
+        fmt::println("Error: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
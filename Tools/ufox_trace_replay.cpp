@@ -0,0 +1,546 @@
+//
+// Created by Putcho on 18.10.2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fmt/core.h>
+#include <SDL3/SDL.h>
+#include <Windowing/ufox_windowing.hpp>
+#include <Engine/ufox_graphic.hpp>
+#include <Engine/ufox_trace.hpp>
+
+namespace {
+    using namespace ufox::graphics::vulkan;
+    using Clock = std::chrono::steady_clock;
+
+    struct ReplayOptions {
+        std::filesystem::path tracePath{};
+        uint64_t firstFrame{0};
+        uint64_t lastFrame{std::numeric_limits<uint64_t>::max()};
+        int repeat{1};
+        size_t slowest{10};
+        std::optional<std::filesystem::path> jsonPath{};
+    };
+
+    struct FrameTiming {
+        uint64_t frameNumber;
+        double ms;              // best of the repeats
+        uint32_t draws;
+    };
+
+    struct ReplayPipeline {
+        vk::Pipeline pipeline{};
+        vk::PipelineLayout layout{};
+        vk::DescriptorSetLayout setLayout{};
+    };
+
+    struct ReplayImage {
+        Image image{};
+        vk::ImageAspectFlags aspect{vk::ImageAspectFlagBits::eColor};
+    };
+
+    bool IsDepthFormat(vk::Format format) {
+        return format == vk::Format::eD32Sfloat || format == vk::Format::eD32SfloatS8Uint || format == vk::Format::eD24UnormS8Uint;
+    }
+
+    // Swapchain images become plain attachments, a layout only valid for presentable images is replaced
+    vk::ImageLayout ReplayLayout(uint32_t layout) {
+        const auto captured = static_cast<vk::ImageLayout>(layout);
+        return captured == vk::ImageLayout::ePresentSrcKHR ? vk::ImageLayout::eGeneral : captured;
+    }
+
+    // Rebuilds the objects of a capture on a fresh device and re-executes the frames between BeginFrame and Submit.
+    // Host writes, uploads, pipelines and descriptor writes are applied as they are read; the commands of a frame are
+    // collected and executed at its Submit, recorded and submitted again for every repeat.
+    class TraceReplayer {
+    public:
+        TraceReplayer(GraphicsDevice& gpu, const ReplayOptions& options) : gpu{gpu}, options{options} {
+            createDescriptorPool();
+            createSampler();
+        }
+
+        void run(TraceReader& reader) {
+            TraceRecord record{};
+            while (reader.next(record)) {
+                switch (record.op) {
+                    case TraceOp::CreateBuffer: createBuffer(record.as<TraceCreateBuffer>()); break;
+                    case TraceOp::CreateImage: createImage(record.as<TraceCreateImage>()); break;
+                    case TraceOp::SwapchainImage: createSwapchainImage(record.as<TraceSwapchainImage>()); break;
+                    case TraceOp::ImageView: views[record.as<TraceImageView>().view] = record.as<TraceImageView>().image; break;
+                    case TraceOp::BufferData: writeBuffer(record.as<TraceBufferData>(), record.trailing<TraceBufferData>()); break;
+                    case TraceOp::CopyBuffer: copyBuffer(record.as<TraceCopyBuffer>()); break;
+                    case TraceOp::CopyBufferToImage: copyBufferToImage(record.as<TraceCopyBufferToImage>()); break;
+                    case TraceOp::DefinePipeline: definePipeline(record.as<TraceDefinePipeline>(), record.trailing<TraceDefinePipeline>()); break;
+                    case TraceOp::WriteDescriptor: writeDescriptor(record.as<TraceWriteDescriptor>()); break;
+                    case TraceOp::BeginFrame:
+                        frameNumber = record.as<TraceBeginFrame>().frameNumber;
+                        frameCommands.clear();
+                        break;
+                    case TraceOp::Submit: submitFrame(); break;
+                    default: frameCommands.push_back(record); break;
+                }
+            }
+        }
+
+        [[nodiscard]] const std::vector<FrameTiming>& getTimings() const { return timings; }
+        [[nodiscard]] uint32_t getSkippedDraws() const { return skippedDraws; }
+
+    private:
+        GraphicsDevice& gpu;
+        const ReplayOptions& options;
+
+        std::unordered_map<uint64_t, Buffer> buffers;
+        std::unordered_map<uint64_t, ReplayImage> images;
+        std::unordered_map<uint64_t, uint64_t> views;          // captured view -> captured image
+        std::unordered_map<uint64_t, ReplayPipeline> pipelines;
+        std::unordered_map<uint64_t, std::vector<TraceWriteDescriptor>> pendingWrites;
+        // Declared before the sets, they are freed back into it
+        std::optional<vk::raii::DescriptorPool> descriptorPool{};
+        std::unordered_map<uint64_t, vk::raii::DescriptorSet> descriptorSets;
+        std::optional<vk::raii::Sampler> sampler{};
+
+        uint64_t frameNumber{0};
+        std::vector<TraceRecord> frameCommands;
+        std::vector<FrameTiming> timings;
+        uint32_t skippedDraws{0};
+
+        void createDescriptorPool() {
+            constexpr uint32_t POOL_SIZE = 1024;
+            const std::array sizes{
+                vk::DescriptorPoolSize{ vk::DescriptorType::eUniformBuffer, POOL_SIZE },
+                vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, POOL_SIZE },
+                vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, POOL_SIZE },
+                vk::DescriptorPoolSize{ vk::DescriptorType::eSampledImage, POOL_SIZE },
+                vk::DescriptorPoolSize{ vk::DescriptorType::eStorageImage, POOL_SIZE },
+                vk::DescriptorPoolSize{ vk::DescriptorType::eSampler, POOL_SIZE },
+            };
+            vk::DescriptorPoolCreateInfo poolInfo{};
+            poolInfo.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
+                    .setMaxSets(POOL_SIZE)
+                    .setPoolSizes(sizes);
+            descriptorPool.emplace(gpu.getDevice(), poolInfo);
+        }
+
+        // Sampler state is not captured, every image descriptor samples through this one
+        void createSampler() {
+            vk::SamplerCreateInfo samplerInfo{};
+            samplerInfo.setMagFilter(vk::Filter::eLinear)
+                       .setMinFilter(vk::Filter::eLinear)
+                       .setMipmapMode(vk::SamplerMipmapMode::eLinear)
+                       .setAddressModeU(vk::SamplerAddressMode::eRepeat)
+                       .setAddressModeV(vk::SamplerAddressMode::eRepeat)
+                       .setAddressModeW(vk::SamplerAddressMode::eRepeat)
+                       .setMaxLod(0.0f);
+            sampler.emplace(gpu.getDevice(), samplerInfo);
+        }
+
+        void createBuffer(const TraceCreateBuffer& create) {
+            Buffer& buffer = buffers[create.buffer];
+            buffer = {};
+            gpu.createBuffer(create.size, vk::BufferUsageFlags(create.usage), vk::MemoryPropertyFlags(create.memoryProperties), buffer);
+        }
+
+        void createImage(const TraceCreateImage& create) {
+            ReplayImage& replay = images[create.image];
+            replay.image.clear();
+            replay.image.format = static_cast<vk::Format>(create.format);
+            replay.image.extent = vk::Extent2D{ create.width, create.height };
+            replay.image.samples = static_cast<vk::SampleCountFlagBits>(create.samples);
+            replay.aspect = IsDepthFormat(replay.image.format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+            gpu.createImage(vk::ImageTiling::eOptimal, vk::ImageUsageFlags(create.usage), vk::MemoryPropertyFlags(create.memoryProperties), replay.image);
+            createView(replay);
+        }
+
+        void createSwapchainImage(const TraceSwapchainImage& swapchainImage) {
+            createImage({ swapchainImage.image, swapchainImage.format, swapchainImage.width, swapchainImage.height,
+                          static_cast<uint32_t>(vk::SampleCountFlagBits::e1),
+                          static_cast<uint32_t>(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc),
+                          static_cast<uint32_t>(vk::MemoryPropertyFlagBits::eDeviceLocal) });
+        }
+
+        void createView(ReplayImage& replay) const {
+            vk::ImageViewCreateInfo viewInfo{};
+            viewInfo.setImage(*replay.image.data)
+                    .setViewType(vk::ImageViewType::e2D)
+                    .setFormat(replay.image.format)
+                    .setSubresourceRange({ replay.aspect, 0, 1, 0, 1 });
+            replay.image.view.emplace(gpu.getDevice(), viewInfo);
+        }
+
+        void writeBuffer(const TraceBufferData& data, std::span<const std::byte> bytes) {
+            auto it = buffers.find(data.buffer);
+            if (it == buffers.end()) return;
+            // The engine only writes through mappings, so every captured write targets host visible memory
+            void* mapped = it->second.memory->mapMemory(data.offset, data.size);
+            std::memcpy(mapped, bytes.data(), std::min<size_t>(data.size, bytes.size()));
+            it->second.memory->unmapMemory();
+        }
+
+        void copyBuffer(const TraceCopyBuffer& copy) const {
+            auto source = buffers.find(copy.source);
+            auto destination = buffers.find(copy.destination);
+            if (source == buffers.end() || destination == buffers.end()) return;
+            gpu.copyBuffer(source->second, destination->second, copy.size);
+        }
+
+        void copyBufferToImage(const TraceCopyBufferToImage& copy) const {
+            auto buffer = buffers.find(copy.buffer);
+            auto image = images.find(copy.image);
+            if (buffer == buffers.end() || image == images.end()) return;
+            gpu.transitionImageLayout(image->second.image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+            gpu.copyBufferToImage(buffer->second, image->second.image);
+            gpu.transitionImageLayout(image->second.image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+        }
+
+        void definePipeline(const TraceDefinePipeline& define, std::span<const std::byte> trailing) {
+            const size_t specializationBytes = size_t{define.specializationCount} * sizeof(SpecializationConstant);
+            if (trailing.size() < size_t{define.vertexShaderLength} + define.fragmentShaderLength + specializationBytes)
+                throw std::runtime_error("Truncated pipeline definition");
+
+            PipelineKey key{};
+            const auto* text = reinterpret_cast<const char*>(trailing.data());
+            key.vertexShader.assign(text, define.vertexShaderLength);
+            key.fragmentShader.assign(text + define.vertexShaderLength, define.fragmentShaderLength);
+            key.specialization.resize(define.specializationCount);
+            std::memcpy(key.specialization.data(), trailing.data() + define.vertexShaderLength + define.fragmentShaderLength, specializationBytes);
+            key.vertexLayout = static_cast<VertexLayout>(define.vertexLayout);
+            key.blendMode = static_cast<BlendMode>(define.blendMode);
+            key.colorFormat = static_cast<vk::Format>(define.colorFormat);
+            key.depthFormat = static_cast<vk::Format>(define.depthFormat);
+            key.samples = static_cast<vk::SampleCountFlagBits>(define.samples);
+
+            // The capture's layout handle means nothing here, the shaders determine it
+            const ShaderInterface& shaderInterface = gpu.getLayoutCache().get({ key.vertexShader, key.fragmentShader });
+            key.layout = shaderInterface.pipelineLayout;
+
+            ReplayPipeline& replay = pipelines[define.pipeline];
+            replay.pipeline = gpu.getPipelineCache().getOrCreate(key);
+            replay.layout = shaderInterface.pipelineLayout;
+            replay.setLayout = shaderInterface.setLayouts.empty() ? vk::DescriptorSetLayout{} : shaderInterface.setLayouts.front();
+        }
+
+        // Sets are allocated when first bound, only then is the layout known
+        void writeDescriptor(const TraceWriteDescriptor& write) {
+            pendingWrites[write.set].push_back(write);
+        }
+
+        vk::DescriptorSet resolveDescriptorSet(uint64_t id, const ReplayPipeline& pipeline) {
+            auto it = descriptorSets.find(id);
+            if (it == descriptorSets.end()) {
+                if (!pipeline.setLayout) return {};
+                vk::DescriptorSetAllocateInfo allocateInfo{};
+                allocateInfo.setDescriptorPool(**descriptorPool)
+                            .setSetLayouts(pipeline.setLayout);
+                vk::raii::DescriptorSets allocated(gpu.getDevice(), allocateInfo);
+                it = descriptorSets.emplace(id, std::move(allocated.front())).first;
+            }
+
+            auto pending = pendingWrites.find(id);
+            if (pending != pendingWrites.end()) {
+                applyWrites(*it->second, pending->second);
+                pendingWrites.erase(pending);
+            }
+            return *it->second;
+        }
+
+        void applyWrites(vk::DescriptorSet set, const std::vector<TraceWriteDescriptor>& writes) {
+            std::vector<vk::DescriptorBufferInfo> bufferInfos;
+            std::vector<vk::DescriptorImageInfo> imageInfos;
+            bufferInfos.reserve(writes.size());
+            imageInfos.reserve(writes.size());
+
+            std::vector<vk::WriteDescriptorSet> descriptorWrites;
+            for (const TraceWriteDescriptor& write : writes) {
+                vk::WriteDescriptorSet descriptorWrite{};
+                descriptorWrite.setDstSet(set)
+                               .setDstBinding(write.binding)
+                               .setDstArrayElement(write.arrayElement)
+                               .setDescriptorCount(1)
+                               .setDescriptorType(static_cast<vk::DescriptorType>(write.type));
+
+                if (write.buffer) {
+                    auto buffer = buffers.find(write.buffer);
+                    if (buffer == buffers.end()) continue;
+                    descriptorWrite.setPBufferInfo(&bufferInfos.emplace_back(**buffer->second.data, write.offset, write.range));
+                }
+                else {
+                    auto view = views.find(write.view);
+                    auto image = view != views.end() ? images.find(view->second) : images.end();
+                    if (image == images.end()) continue;
+                    descriptorWrite.setPImageInfo(&imageInfos.emplace_back(**sampler, **image->second.image.view,
+                                                                           static_cast<vk::ImageLayout>(write.imageLayout)));
+                }
+                descriptorWrites.push_back(descriptorWrite);
+            }
+            if (!descriptorWrites.empty()) gpu.updateDescriptorSets(descriptorWrites);
+        }
+
+        [[nodiscard]] vk::ImageView findView(uint64_t image) const {
+            auto it = images.find(image);
+            return it != images.end() && it->second.image.view ? **it->second.image.view : vk::ImageView{};
+        }
+
+        void submitFrame() {
+            if (frameNumber < options.firstFrame || frameNumber > options.lastFrame) return;
+
+            FrameTiming timing{ frameNumber, std::numeric_limits<double>::max(), 0 };
+            for (int i = 0; i < options.repeat; ++i) {
+                const Clock::time_point start = Clock::now();
+                vk::raii::CommandBuffer cmd = gpu.beginSingleTimeCommands();
+                timing.draws = recordFrame(cmd);
+                // Waits for the queue, so this is the frame's recording, submission and GPU time
+                gpu.endSingleTimeCommands(cmd);
+                timing.ms = std::min(timing.ms, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            }
+            timings.push_back(timing);
+        }
+
+        uint32_t recordFrame(const vk::raii::CommandBuffer& cmd) {
+            const ReplayPipeline* pipeline = nullptr;
+            bool pipelineMissing = false;
+            uint32_t draws = 0;
+
+            for (const TraceRecord& record : frameCommands) {
+                switch (record.op) {
+                    case TraceOp::Barrier: {
+                        const auto barrier = record.as<TraceBarrier>();
+                        auto image = images.find(barrier.image);
+                        if (image == images.end()) break;
+                        vk::ImageMemoryBarrier2 imageBarrier{};
+                        imageBarrier.setImage(*image->second.image.data)
+                                    .setOldLayout(ReplayLayout(barrier.oldLayout))
+                                    .setNewLayout(ReplayLayout(barrier.newLayout))
+                                    .setSrcStageMask(vk::PipelineStageFlags2(barrier.srcStage))
+                                    .setDstStageMask(vk::PipelineStageFlags2(barrier.dstStage))
+                                    .setSrcAccessMask(vk::AccessFlags2(barrier.srcAccess))
+                                    .setDstAccessMask(vk::AccessFlags2(barrier.dstAccess))
+                                    .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                    .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                    .setSubresourceRange({ vk::ImageAspectFlags(barrier.aspect), 0, 1, 0, 1 });
+                        vk::DependencyInfo dependency{};
+                        dependency.setImageMemoryBarriers(imageBarrier);
+                        cmd.pipelineBarrier2(dependency);
+                        break;
+                    }
+                    case TraceOp::BeginRendering: {
+                        const auto begin = record.as<TraceBeginRendering>();
+                        vk::RenderingAttachmentInfo colorAttachment{};
+                        colorAttachment.setImageView(findView(begin.colorImage))
+                            .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                            .setLoadOp(vk::AttachmentLoadOp::eClear)
+                            .setStoreOp(vk::AttachmentStoreOp::eStore)
+                            .setClearValue({ std::array{ begin.clearColor[0], begin.clearColor[1], begin.clearColor[2], begin.clearColor[3] } });
+                        if (begin.resolveImage) {
+                            colorAttachment.setStoreOp(vk::AttachmentStoreOp::eDontCare)
+                                .setResolveMode(vk::ResolveModeFlagBits::eAverage)
+                                .setResolveImageView(findView(begin.resolveImage))
+                                .setResolveImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
+                        }
+
+                        vk::RenderingAttachmentInfo depthAttachment{};
+                        depthAttachment.setImageView(findView(begin.depthImage))
+                            .setImageLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+                            .setLoadOp(vk::AttachmentLoadOp::eClear)
+                            .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+                            .setClearValue(vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0)));
+
+                        vk::RenderingInfo renderingInfo{};
+                        renderingInfo.setRenderArea({ {0, 0}, { begin.width, begin.height } })
+                            .setLayerCount(1)
+                            .setColorAttachments(colorAttachment)
+                            .setPDepthAttachment(begin.depthImage ? &depthAttachment : nullptr);
+                        cmd.beginRendering(renderingInfo);
+                        break;
+                    }
+                    case TraceOp::EndRendering:
+                        cmd.endRendering();
+                        break;
+                    case TraceOp::SetDepthState: {
+                        const auto depth = record.as<TraceSetDepthState>();
+                        cmd.setDepthTestEnable(depth.testEnable != 0);
+                        cmd.setDepthWriteEnable(depth.writeEnable != 0);
+                        cmd.setDepthCompareOp(static_cast<vk::CompareOp>(depth.compareOp));
+                        break;
+                    }
+                    case TraceOp::SetViewport: {
+                        const auto viewport = record.as<TraceSetViewport>();
+                        cmd.setViewport(0, vk::Viewport{ viewport.x, viewport.y, viewport.width, viewport.height, viewport.minDepth, viewport.maxDepth });
+                        // DrawList sets these together with the viewport and never changes them
+                        cmd.setCullMode(vk::CullModeFlagBits::eNone);
+                        cmd.setFrontFace(vk::FrontFace::eClockwise);
+                        cmd.setPrimitiveTopology(vk::PrimitiveTopology::eTriangleList);
+                        break;
+                    }
+                    case TraceOp::SetScissor: {
+                        const auto scissor = record.as<TraceSetScissor>();
+                        cmd.setScissor(0, vk::Rect2D{ { scissor.x, scissor.y }, { scissor.width, scissor.height } });
+                        break;
+                    }
+                    case TraceOp::BindPipeline: {
+                        auto it = pipelines.find(record.as<TraceBindPipeline>().pipeline);
+                        pipelineMissing = it == pipelines.end() || !it->second.pipeline;
+                        if (pipelineMissing) break;
+                        pipeline = &it->second;
+                        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->pipeline);
+                        break;
+                    }
+                    case TraceOp::BindDescriptorSet: {
+                        if (!pipeline || pipelineMissing) break;
+                        const vk::DescriptorSet set = resolveDescriptorSet(record.as<TraceBindDescriptorSet>().set, *pipeline);
+                        if (set) cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->layout, 0, set, nullptr);
+                        break;
+                    }
+                    case TraceOp::BindVertexBuffer: {
+                        auto it = buffers.find(record.as<TraceBindVertexBuffer>().buffer);
+                        if (it != buffers.end()) cmd.bindVertexBuffers(0, **it->second.data, vk::DeviceSize{0});
+                        break;
+                    }
+                    case TraceOp::BindIndexBuffer: {
+                        const auto bind = record.as<TraceBindIndexBuffer>();
+                        auto it = buffers.find(bind.buffer);
+                        if (it != buffers.end()) cmd.bindIndexBuffer(**it->second.data, 0, static_cast<vk::IndexType>(bind.indexType));
+                        break;
+                    }
+                    case TraceOp::PushConstants: {
+                        if (!pipeline || pipelineMissing) break;
+                        const auto push = record.as<TracePushConstants>();
+                        const auto bytes = record.trailing<TracePushConstants>().first(std::min<size_t>(push.size, record.trailing<TracePushConstants>().size()));
+                        cmd.pushConstants<std::byte>(pipeline->layout, vk::ShaderStageFlags(push.stages), 0, bytes);
+                        break;
+                    }
+                    case TraceOp::DrawIndexed: {
+                        // A pipeline the capture never defined, e.g. one built before tracing or by a GUI helper pass
+                        if (!pipeline || pipelineMissing) {
+                            ++skippedDraws;
+                            break;
+                        }
+                        const auto draw = record.as<TraceDrawIndexed>();
+                        cmd.drawIndexed(draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+                        ++draws;
+                        break;
+                    }
+                    default: break;
+                }
+            }
+            return draws;
+        }
+    };
+
+    void PrintUsage() {
+        fmt::println("Usage: UFox-TraceReplay <trace> [options]");
+        fmt::println("  --frames <first>:<last>  replay only these frame numbers, either side may be empty");
+        fmt::println("  --repeat <n>             execute every frame n times and keep the best time");
+        fmt::println("  --slowest <n>            list the n slowest frames (default 10)");
+        fmt::println("  --json <path>            write every frame's time to a JSON file");
+    }
+
+    ReplayOptions ParseOptions(int argc, char** argv) {
+        ReplayOptions options{};
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error("Missing value for " + argument);
+                return argv[++i];
+            };
+
+            if (argument == "--frames") {
+                const std::string range = value();
+                const size_t separator = range.find(':');
+                if (separator == std::string::npos) throw std::runtime_error("--frames expects <first>:<last>");
+                if (separator > 0) options.firstFrame = std::stoull(range.substr(0, separator));
+                if (separator + 1 < range.size()) options.lastFrame = std::stoull(range.substr(separator + 1));
+            }
+            else if (argument == "--repeat") options.repeat = std::max(1, std::stoi(value()));
+            else if (argument == "--slowest") options.slowest = std::stoul(value());
+            else if (argument == "--json") options.jsonPath = value();
+            else if (argument == "--help") {
+                PrintUsage();
+                std::exit(0);
+            }
+            else if (options.tracePath.empty() && !argument.starts_with("--")) options.tracePath = argument;
+            else throw std::runtime_error("Unknown option " + argument);
+        }
+        if (options.tracePath.empty()) {
+            PrintUsage();
+            std::exit(1);
+        }
+        return options;
+    }
+
+    void WriteJson(const std::filesystem::path& path, const std::vector<FrameTiming>& timings) {
+        std::ofstream file(path);
+        if (!file) throw std::runtime_error("Failed to create " + path.string());
+        file << "{\n  \"frames\": [\n";
+        for (size_t i = 0; i < timings.size(); ++i) {
+            file << fmt::format("    {{\"frame\": {}, \"ms\": {:.4f}, \"draws\": {}}}{}\n", timings[i].frameNumber, timings[i].ms,
+                                timings[i].draws, i + 1 < timings.size() ? "," : "");
+        }
+        file << "  ]\n}\n";
+    }
+
+    void PrintSummary(const ReplayOptions& options, std::vector<FrameTiming> timings, uint32_t skippedDraws) {
+        if (timings.empty()) {
+            fmt::println("No frames in range");
+            return;
+        }
+
+        double total = 0.0;
+        for (const FrameTiming& timing : timings) total += timing.ms;
+        std::ranges::sort(timings, std::ranges::greater{}, &FrameTiming::ms);
+        const auto percentile = [&](double p) { return timings[static_cast<size_t>((1.0 - p) * static_cast<double>(timings.size() - 1))].ms; };
+
+        fmt::println("{} frames, mean {:.3f} ms, p50 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms", timings.size(),
+                     total / static_cast<double>(timings.size()), percentile(0.5), percentile(0.99), timings.front().ms);
+        if (skippedDraws > 0) fmt::println("{} draws skipped, their pipelines are not in the trace", skippedDraws);
+
+        fmt::println("Slowest frames:");
+        for (size_t i = 0; i < std::min(options.slowest, timings.size()); ++i)
+            fmt::println("  frame {:>8}  {:8.3f} ms  {} draws", timings[i].frameNumber, timings[i].ms, timings[i].draws);
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const ReplayOptions options = ParseOptions(argc, argv);
+        TraceReader reader(options.tracePath);
+
+        // Replays run on machines without a display too, presentation is never replayed
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        ufox::windowing::sdl::UfoxWindow window("UFox Trace Replay", SDL_WINDOW_VULKAN);
+        GraphicsDevice gpu(window, "UFox Engine", vk::makeApiVersion(0, 1, 0, 0),
+                           "UFox Trace Replay", vk::makeApiVersion(0, 1, 0, 0));
+        // A UFOX_TRACE left in the environment would capture the replay itself
+        gpu.stopTrace();
+
+        std::vector<FrameTiming> timings;
+        uint32_t skippedDraws = 0;
+        {
+            TraceReplayer replayer(gpu, options);
+            replayer.run(reader);
+            gpu.waitForIdle();
+            timings = replayer.getTimings();
+            skippedDraws = replayer.getSkippedDraws();
+        }
+
+        PrintSummary(options, timings, skippedDraws);
+        if (options.jsonPath) {
+            WriteJson(*options.jsonPath, timings);
+            fmt::println("Frame times written to {}", options.jsonPath->string());
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        fmt::println("Error: {}", e.what());
+        return 1;
+    }
+}
@@ -1,7 +1,11 @@
+#include <cstdlib>
+#include <optional>
 #include <fmt/core.h>
 #include <Windowing/ufox_windowing.hpp>
 #include <Engine/ufox_graphic.hpp>
 #include <Engine/ufox_inputSystem.hpp>
+#include <Engine/ufox_metrics.hpp>
+#include <Engine/ufox_runtime.hpp>
 
 
 int main() {
@@ -13,66 +17,18 @@ int main() {
             "UFox Application", vk::makeApiVersion(0,1,0,0));
         ufox::InputSystem input{};
 
+        // Field builds point UFOX_METRICS at a file, or at unix:<path> for a local collector
+        std::optional<ufox::profiling::MetricsExporter> metricsExporter{};
+        if (const char* metricsTarget = std::getenv("UFOX_METRICS"))
+            metricsExporter.emplace(gpu.getMetrics(), ufox::profiling::MetricsExporter::OpenSink(metricsTarget));
 
 
-        window.show();
-
-        SDL_Event event;
-        bool running = true;
-        bool c {true};
-
-        auto windowflag = SDL_GetWindowFlags(window.get());
-        gpu.enableRender = !(windowflag & SDL_WINDOW_MINIMIZED) && !(windowflag & SDL_WINDOW_HIDDEN);
 
-        while (running) {
-            while (SDL_PollEvent(&event)) {
-                switch (event.type) {
-                    case SDL_EVENT_QUIT: {
-                        gpu.enableRender = false;
-                        running = false;
-                        break;
-                    }
-                    case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED: {
-                        window.updateSize();
-                        auto [w, h] = window.getSize();
-                        fmt::println("Window resized: {}x{}", w, h);
-                        gpu.recreateSwapchain(window);
-                        break;
-                    }
-                    case SDL_EVENT_WINDOW_MINIMIZED: {
-                        gpu.enableRender = false;
-                        break;
-                    }
-                    case SDL_EVENT_WINDOW_RESTORED: {
-                        gpu.enableRender = true;
-                        break;
-                    }
-                    case SDL_EVENT_MOUSE_MOTION: {
-                        input.EnabledMousePositionOutside(false);
-                        input.updateMousePositionInsideWindow();
-                        break;
-                    }
-                    case SDL_EVENT_WINDOW_FOCUS_LOST: {
-                        input.EnabledMousePositionOutside(false);
-                        break;
-                    }
-                    case SDL_EVENT_WINDOW_FOCUS_GAINED: {
-                        input.EnabledMousePositionOutside(true);
-                        break;
-                    }
-                    default: {
-                        if (event.motion.x == 0 || event.motion.y == 0) {
-                            input.EnabledMousePositionOutside(true);
-                        }
-
-                    }
-                }
-            }
-
-            input.updateMousePositionOutsideWindow(window.get());
+        window.show();
 
-            gpu.drawFrame(window);
-        }
+        // Events stay on this thread, update and rendering run on the runtime's render thread
+        ufox::EngineRuntime runtime(window, gpu, input);
+        runtime.run();
 
         gpu.waitForIdle();
 